@@ -57,11 +57,16 @@ for i in \
     cluon/TerminateHandler.hpp \
     cluon/NotifyingPipeline.hpp \
     cluon/UDPPacketSizeConstraints.hpp \
+    cluon/IOReactor.hpp \
+    cluon/BufferPool.hpp \
     cluon/UDPSender.hpp \
     cluon/UDPReceiver.hpp \
     cluon/TCPConnection.hpp \
     cluon/TCPServer.hpp \
+    cluon/Arena.hpp \
+    cluon/MemoryMappedFile.hpp \
     cluon/ProtoConstants.hpp \
+    cluon/VarInt.hpp \
     cluon/ToProtoVisitor.hpp \
     cluon/FromProtoVisitor.hpp \
     cluon/FromLCMVisitor.hpp \
@@ -75,6 +80,9 @@ for i in \
     cluon/ToODVDVisitor.hpp \
     cluon/ToMsgPackVisitor.hpp \
     cluon/Envelope.hpp \
+    cluon/EnvelopeReader.hpp \
+    cluon/EnvelopeView.hpp \
+    cluon/RecIndex.hpp \
     cluon/EnvelopeConverter.hpp \
     cluon/GenericMessage.hpp \
     cluon/LCMToGenericMessage.hpp \
@@ -94,10 +102,14 @@ for i in \
     MetaMessage.cpp \
     MessageParser.cpp \
     TerminateHandler.cpp \
+    IOReactor.cpp \
+    BufferPool.cpp \
     UDPSender.cpp \
     UDPReceiver.cpp \
     TCPConnection.cpp \
     TCPServer.cpp \
+    Arena.cpp \
+    MemoryMappedFile.cpp \
     ToProtoVisitor.cpp \
     FromProtoVisitor.cpp \
     FromLCMVisitor.cpp \
@@ -109,6 +121,9 @@ for i in \
     ToLCMVisitor.cpp \
     LCMToGenericMessage.cpp \
     ToMsgPackVisitor.cpp \
+    EnvelopeReader.cpp \
+    EnvelopeView.cpp \
+    RecIndex.cpp \
     OD4Session.cpp \
     ToODVDVisitor.cpp \
     EnvelopeConverter.cpp \
@@ -0,0 +1,227 @@
+/*
+ * Copyright (C) 2017-2018  Christian Berger
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef CLUON_ARENA_HPP
+#define CLUON_ARENA_HPP
+
+#include "cluon/cluon.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <vector>
+
+namespace cluon {
+/**
+This class is a monotonic allocator: Memory is taken from large blocks by
+advancing an offset and is never freed individually; instead, the whole arena
+is rewound to an earlier state at once. The blocks are kept after rewinding
+and thus, in steady state, allocating from an Arena does not allocate memory
+from the heap.
+
+An Arena must not be used from several threads at the same time; every thread
+has its own Arena available via Arena::ofThisThread(). Arenas are not used
+directly but activated with an ArenaScope and allocated from with an
+ArenaAllocator:
+
+\code{.cpp}
+{
+    cluon::ArenaScope scope{cluon::Arena::ofThisThread()};
+    // Scratch memory of the FromProtoVisitor is taken from the Arena.
+    cluon::FromProtoVisitor protoDecoder;
+    protoDecoder.decodeFrom(data, size);
+    msg.accept(protoDecoder);
+} // All memory that was taken from the Arena inside the scope is reused.
+\endcode
+*/
+class LIBCLUON_API Arena {
+   private:
+    Arena(const Arena &) = delete;
+    Arena(Arena &&)      = delete;
+    Arena &operator=(const Arena &) = delete;
+    Arena &operator=(Arena &&) = delete;
+
+   public:
+    /**
+     * This class describes a state of an Arena to rewind to.
+     */
+    class Mark {
+       public:
+        std::size_t m_block{0};
+        std::size_t m_offset{0};
+    };
+
+   public:
+    static constexpr std::size_t DEFAULT_BLOCK_SIZE{64 * 1024};
+
+    /**
+     * Constructor.
+     *
+     * @param blockSize Number of bytes of each block; larger allocations get a block of their own.
+     */
+    explicit Arena(std::size_t blockSize = DEFAULT_BLOCK_SIZE) noexcept;
+    ~Arena() = default;
+
+   public:
+    /**
+     * This method allocates memory from this Arena.
+     *
+     * @param size Number of bytes to allocate.
+     * @param alignment Alignment of the allocated memory (a power of 2).
+     * @return Pointer to the allocated memory or nullptr if no memory is available.
+     */
+    void *allocate(std::size_t size, std::size_t alignment) noexcept;
+
+    /**
+     * @return Current state of this Arena to rewind to later.
+     */
+    Mark mark() const noexcept;
+
+    /**
+     * This method makes all memory allocated after the given mark available again.
+     *
+     * @param mark State to rewind to.
+     */
+    void rewind(const Mark &mark) noexcept;
+
+    /**
+     * This method makes all memory of this Arena available again.
+     */
+    void reset() noexcept;
+
+    /**
+     * @return Number of bytes allocated from this Arena including padding and unused bytes at the end of blocks.
+     */
+    std::size_t numberOfBytesInUse() const noexcept;
+
+    /**
+     * @return Number of bytes of all blocks of this Arena.
+     */
+    std::size_t capacity() const noexcept;
+
+    /**
+     * @return Number of blocks that were allocated from the heap.
+     */
+    std::size_t numberOfBlocks() const noexcept;
+
+    /**
+     * @return Arena that belongs to the calling thread.
+     */
+    static Arena &ofThisThread() noexcept;
+
+    /**
+     * @return Arena activated by the innermost ArenaScope of the calling thread or nullptr.
+     */
+    static Arena *current() noexcept;
+
+   private:
+    friend class ArenaScope;
+    static Arena *&currentOfThisThread() noexcept;
+
+    /**
+     * This class holds the memory of a block.
+     */
+    class Block {
+       public:
+        std::unique_ptr<char[]> m_data{};
+        std::size_t m_size{0};
+    };
+
+   private:
+    const std::size_t m_blockSize;
+    std::vector<Block> m_blocks{};
+    std::size_t m_currentBlock{0};
+    std::size_t m_offset{0};
+};
+
+/**
+This class activates an Arena for the calling thread for its lifetime: Until
+it is destroyed, default-constructed ArenaAllocators take their memory from
+the given Arena. When the scope ends, all memory that was allocated from the
+Arena inside the scope is made available again and the previously active
+Arena (if any) is restored; hence, scopes can be nested.
+
+Containers using an ArenaAllocator that was created inside the scope must not
+outlive the scope.
+*/
+class LIBCLUON_API ArenaScope {
+   private:
+    ArenaScope(const ArenaScope &) = delete;
+    ArenaScope(ArenaScope &&)      = delete;
+    ArenaScope &operator=(const ArenaScope &) = delete;
+    ArenaScope &operator=(ArenaScope &&) = delete;
+
+   public:
+    explicit ArenaScope(Arena &arena) noexcept;
+    ~ArenaScope() noexcept;
+
+   private:
+    Arena &m_arena;
+    Arena::Mark m_mark;
+    Arena *m_previous;
+};
+
+/**
+This class is an allocator for standard containers that takes its memory from
+the Arena that was active when the allocator was created; without an active
+Arena, the memory is taken from the heap. Deallocating memory from an Arena
+does nothing as the memory is reused when the ArenaScope ends.
+*/
+template <typename T>
+class ArenaAllocator {
+   public:
+    using value_type = T;
+
+    ArenaAllocator() noexcept
+        : m_arena{Arena::current()} {}
+
+    explicit ArenaAllocator(Arena *arena) noexcept
+        : m_arena{arena} {}
+
+    template <typename U>
+    ArenaAllocator(const ArenaAllocator<U> &other) noexcept
+        : m_arena{other.arena()} {}
+
+    T *allocate(std::size_t n) {
+        if (nullptr == m_arena) {
+            return static_cast<T *>(::operator new(n * sizeof(T)));
+        }
+        void *ptr{m_arena->allocate(n * sizeof(T), alignof(T))};
+        if (nullptr == ptr) {
+            throw std::bad_alloc(); // LCOV_EXCL_LINE
+        }
+        return static_cast<T *>(ptr);
+    }
+
+    void deallocate(T *ptr, std::size_t) noexcept {
+        if (nullptr == m_arena) {
+            ::operator delete(ptr);
+        }
+    }
+
+    Arena *arena() const noexcept {
+        return m_arena;
+    }
+
+   private:
+    Arena *m_arena;
+};
+
+template <typename T, typename U>
+inline bool operator==(const ArenaAllocator<T> &lhs, const ArenaAllocator<U> &rhs) noexcept {
+    return lhs.arena() == rhs.arena();
+}
+
+template <typename T, typename U>
+inline bool operator!=(const ArenaAllocator<T> &lhs, const ArenaAllocator<U> &rhs) noexcept {
+    return lhs.arena() != rhs.arena();
+}
+} // namespace cluon
+
+#endif
@@ -0,0 +1,173 @@
+/*
+ * Copyright (C) 2017-2018  Christian Berger
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef CLUON_BUFFERPOOL_HPP
+#define CLUON_BUFFERPOOL_HPP
+
+#include "cluon/cluon.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace cluon {
+
+class BufferPool;
+
+/**
+This class is a reference-counted handle to a fixed-size buffer that is taken
+from a BufferPool. Copying a PooledBuffer does not copy the bytes but shares
+the buffer; when the last handle is destroyed, the buffer is returned to its
+pool to be reused without any heap allocation.
+
+A PooledBuffer can be kept as long as needed, even after the BufferPool's
+creator (e.g., a UDPReceiver) was destroyed.
+*/
+class LIBCLUON_API PooledBuffer {
+   public:
+    PooledBuffer() = default;
+    ~PooledBuffer() noexcept;
+    PooledBuffer(const PooledBuffer &other) noexcept;
+    PooledBuffer(PooledBuffer &&other) noexcept;
+    PooledBuffer &operator=(const PooledBuffer &other) noexcept;
+    PooledBuffer &operator=(PooledBuffer &&other) noexcept;
+
+   public:
+    /**
+     * @return Pointer to the first byte of this buffer or nullptr for an empty handle.
+     */
+    char *data() noexcept;
+    const char *data() const noexcept;
+
+    /**
+     * @return Number of used bytes in this buffer.
+     */
+    std::size_t size() const noexcept;
+
+    /**
+     * @return Maximum number of bytes that this buffer can hold.
+     */
+    std::size_t capacity() const noexcept;
+
+    /**
+     * This method sets the number of used bytes in this buffer.
+     *
+     * @param size Number of used bytes (limited to the capacity).
+     */
+    void resize(std::size_t size) noexcept;
+
+    /**
+     * @return true if no bytes are used in this buffer.
+     */
+    bool empty() const noexcept;
+
+    /**
+     * @return Copy of the used bytes as std::string.
+     */
+    std::string toString() const noexcept;
+
+   private:
+    friend class BufferPool;
+
+    /**
+     * This class holds the bytes of a buffer and its reference counter.
+     */
+    class Slot {
+       public:
+        std::atomic<uint32_t> m_references{0};
+        std::size_t m_size{0};
+        std::unique_ptr<char[]> m_data{};
+        Slot *m_nextReleased{nullptr};
+    };
+
+    PooledBuffer(std::shared_ptr<BufferPool> pool, Slot *slot) noexcept;
+    void release() noexcept;
+
+   private:
+    std::shared_ptr<BufferPool> m_pool{};
+    Slot *m_slot{nullptr};
+};
+
+/**
+This class provides buffers of a fixed size that are reused after the last
+PooledBuffer referring to them was destroyed. When all buffers are in use,
+the pool grows; thus, in steady state, acquiring a buffer does not allocate
+memory from the heap:
+
+\code{.cpp}
+auto pool = cluon::BufferPool::create(1500);
+cluon::PooledBuffer buffer{pool->acquire()};
+std::memcpy(buffer.data(), "Hello", 5);
+buffer.resize(5);
+\endcode
+*/
+class LIBCLUON_API BufferPool : public std::enable_shared_from_this<BufferPool> {
+   private:
+    BufferPool(const BufferPool &) = delete;
+    BufferPool(BufferPool &&)      = delete;
+    BufferPool &operator=(const BufferPool &) = delete;
+    BufferPool &operator=(BufferPool &&) = delete;
+
+   public:
+    /**
+     * This method creates a new BufferPool.
+     *
+     * @param bufferSize Capacity of each buffer in bytes.
+     * @param numberOfBuffers Number of buffers to allocate upfront.
+     * @return Shared pointer to the new BufferPool.
+     */
+    static std::shared_ptr<BufferPool> create(std::size_t bufferSize, std::size_t numberOfBuffers = 0) noexcept;
+
+    ~BufferPool() = default;
+
+    /**
+     * @return A buffer from this pool with size 0 or an empty handle if no memory is available.
+     */
+    PooledBuffer acquire() noexcept;
+
+    /**
+     * @return Capacity of each buffer in bytes.
+     */
+    std::size_t bufferSize() const noexcept;
+
+    /**
+     * @return Number of buffers that were allocated by this pool.
+     */
+    std::size_t numberOfBuffers() noexcept;
+
+    /**
+     * @return Number of buffers that are currently not in use.
+     */
+    std::size_t numberOfAvailableBuffers() noexcept;
+
+   private:
+    friend class PooledBuffer;
+
+    explicit BufferPool(std::size_t bufferSize) noexcept;
+    void release(PooledBuffer::Slot *slot) noexcept;
+
+   private:
+    const std::size_t m_bufferSize;
+
+    // Buffers are typically acquired by one thread (e.g., the receiving one)
+    // and released by another one (e.g., the delegate's); thus, releasing a
+    // buffer pushes it lock-free to m_releasedSlots without contending for
+    // m_slotsMutex, and acquiring takes all released buffers at once.
+    std::mutex m_slotsMutex{};
+    std::vector<std::unique_ptr<PooledBuffer::Slot>> m_slots{};
+    std::vector<PooledBuffer::Slot *> m_availableSlots{};
+    std::atomic<PooledBuffer::Slot *> m_releasedSlots{nullptr};
+    std::atomic<std::size_t> m_numberOfReleasedSlots{0};
+};
+} // namespace cluon
+
+#endif
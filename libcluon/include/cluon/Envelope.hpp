@@ -10,9 +10,12 @@
 #define CLUON_ENVELOPE_HPP
 
 #include "cluon/FromProtoVisitor.hpp"
+#include "cluon/ProtoConstants.hpp"
 #include "cluon/ToProtoVisitor.hpp"
+#include "cluon/VarInt.hpp"
 #include "cluon/cluonDataStructures.hpp"
 
+#include <array>
 #include <cstring>
 #include <istream>
 #include <sstream>
@@ -22,6 +25,34 @@
 
 namespace cluon {
 
+/**
+ * This method transforms a given Envelope to the representation to be sent to
+ * an OpenDaVINCI session into the given buffer; the buffer's memory is reused.
+ *
+ * @param buffer Buffer to replace with the representation of the Envelope.
+ * @param envelope Envelope with payload to be sent.
+ */
+inline void serializeEnvelope(std::string &buffer, cluon::data::Envelope &envelope) noexcept {
+    try {
+        // Add OD4 header; its length is filled in after encoding the Envelope.
+        constexpr unsigned char OD4_HEADER_BYTE0 = 0x0D;
+        constexpr unsigned char OD4_HEADER_BYTE1 = 0xA4;
+        constexpr std::size_t OD4_HEADER_SIZE{5};
+        buffer.assign(OD4_HEADER_SIZE, '\0');
+        buffer[0] = static_cast<char>(OD4_HEADER_BYTE0);
+        buffer[1] = static_cast<char>(OD4_HEADER_BYTE1);
+
+        // Write payload.
+        cluon::ToProtoVisitor protoEncoder{buffer};
+        envelope.accept(protoEncoder);
+
+        const uint32_t LENGTH{static_cast<uint32_t>(protoEncoder.encodedSize())};
+        buffer[2] = static_cast<char>(LENGTH & 0xFF);
+        buffer[3] = static_cast<char>((LENGTH >> 8) & 0xFF);
+        buffer[4] = static_cast<char>((LENGTH >> 16) & 0xFF);
+    } catch (...) { buffer.clear(); } // LCOV_EXCL_LINE
+}
+
 /**
  * This method transforms a given Envelope to a string representation to be
  * sent to an OpenDaVINCI session.
@@ -31,34 +62,120 @@ namespace cluon {
  */
 inline std::string serializeEnvelope(cluon::data::Envelope &&envelope) noexcept {
     std::string dataToSend;
-    {
-        std::stringstream sstr;
+    serializeEnvelope(dataToSend, envelope);
+    return dataToSend;
+}
 
-        cluon::ToProtoVisitor protoEncoder;
-        envelope.accept(protoEncoder);
+/**
+ * Scatter/gather list of the representation of an Envelope to be sent to an
+ * OpenDaVINCI session: The OD4 header with the fields in front of the
+ * serializedData, the serializedData, and the fields behind it; each part is
+ * given as pointer to its first byte and number of bytes.
+ */
+using EnvelopeParts = std::array<std::pair<const char *, std::size_t>, 3>;
 
-        const std::string tmp{protoEncoder.encodedData()};
-        uint32_t length{static_cast<uint32_t>(tmp.size())};
-        length <<= 8;
-        length = htole32(length);
+/**
+ * This method transforms a given Envelope to the representation to be sent to
+ * an OpenDaVINCI session as scatter/gather list without copying the payload:
+ * Only the OD4 header and the Envelope's fields except for its serializedData
+ * are encoded into the given buffer; the given payload is used instead of the
+ * Envelope's serializedData.
+ *
+ * @param buffer Buffer to replace with the bytes around the payload.
+ * @param envelope Envelope with the fields to be sent.
+ * @param payload Pointer to the first byte of the payload to be sent as serializedData.
+ * @param size Number of bytes of the payload.
+ * @return Parts pointing into buffer and payload; they are valid as long as both are not changed.
+ */
+inline EnvelopeParts serializeEnvelopeParts(std::string &buffer, cluon::data::Envelope &envelope, const char *payload, std::size_t size) noexcept {
+    EnvelopeParts parts{};
+    try {
+        constexpr std::size_t OD4_HEADER_SIZE{5};
+        buffer.assign(OD4_HEADER_SIZE, '\0');
+        buffer[0] = static_cast<char>(0x0D);
+        buffer[1] = static_cast<char>(0xA4);
 
-        // Add OD4 header.
-        constexpr unsigned char OD4_HEADER_BYTE0 = 0x0D;
-        constexpr unsigned char OD4_HEADER_BYTE1 = 0xA4;
-        sstr.put(static_cast<char>(OD4_HEADER_BYTE0));
-        auto posByte1 = sstr.tellp();
-        sstr.write(reinterpret_cast<char *>(&length), static_cast<std::streamsize>(sizeof(uint32_t)));
-        auto posByte5 = sstr.tellp();
-        sstr.seekp(posByte1);
-        sstr.put(static_cast<char>(OD4_HEADER_BYTE1));
-        sstr.seekp(posByte5);
+        cluon::ToProtoVisitor protoEncoder{buffer};
+        envelope.accept(1, protoEncoder);
 
-        // Write payload.
-        sstr.write(tmp.data(), static_cast<std::streamsize>(tmp.size()));
+        // Encode only key and length of the serializedData.
+        char varInt[MAX_VARINT_SIZE];
+        buffer.append(varInt, encodeVarInt(varInt, (2 << 3) | static_cast<uint8_t>(ProtoConstants::LENGTH_DELIMITED)));
+        buffer.append(varInt, encodeVarInt(varInt, size));
+        const std::size_t HEAD{buffer.size()};
+
+        for (uint32_t fieldId{3}; fieldId <= 6; fieldId++) { envelope.accept(fieldId, protoEncoder); }
+
+        const uint32_t LENGTH{static_cast<uint32_t>(protoEncoder.encodedSize() + size)};
+        buffer[2] = static_cast<char>(LENGTH & 0xFF);
+        buffer[3] = static_cast<char>((LENGTH >> 8) & 0xFF);
+        buffer[4] = static_cast<char>((LENGTH >> 16) & 0xFF);
 
-        dataToSend = sstr.str();
+        parts[0] = std::make_pair(buffer.data(), HEAD);
+        parts[1] = std::make_pair(payload, size);
+        parts[2] = std::make_pair(buffer.data() + HEAD, buffer.size() - HEAD);
+    } catch (...) { parts = EnvelopeParts{}; } // LCOV_EXCL_LINE
+    return parts;
+}
+
+/**
+This class refers to the serializedData of an Envelope when visiting its
+field 2 as the Envelope's getter returns a copy.
+*/
+class SerializedDataVisitor {
+   public:
+    void visit(uint32_t, std::string &&, std::string &&, std::string &v) noexcept {
+        m_serializedData = &v;
     }
-    return dataToSend;
+    template <typename T>
+    void visit(uint32_t, std::string &&, std::string &&, T &) noexcept {}
+
+   public:
+    const std::string *m_serializedData{nullptr};
+};
+
+/**
+ * This method transforms a given Envelope to the representation to be sent to
+ * an OpenDaVINCI session as scatter/gather list without copying the
+ * Envelope's serializedData.
+ *
+ * @param buffer Buffer to replace with the bytes around the serializedData.
+ * @param envelope Envelope with payload to be sent.
+ * @return Parts pointing into buffer and envelope; they are valid as long as both are not changed.
+ */
+inline EnvelopeParts serializeEnvelopeParts(std::string &buffer, cluon::data::Envelope &envelope) noexcept {
+    SerializedDataVisitor serializedData;
+    envelope.accept(2, serializedData);
+    return serializeEnvelopeParts(buffer, envelope, serializedData.m_serializedData->data(), serializedData.m_serializedData->size());
+}
+
+/**
+ * This method writes the representation of a given Envelope to be sent to an
+ * OpenDaVINCI session into the given memory; the serializedData is copied
+ * only once.
+ *
+ * @param out Memory to write to.
+ * @param capacity Number of bytes available at out.
+ * @param envelope Envelope with payload to be sent.
+ * @return Number of bytes written or 0 if capacity is too small.
+ */
+inline std::size_t serializeEnvelope(char *out, std::size_t capacity, cluon::data::Envelope &envelope) noexcept {
+    // The bytes around the serializedData are reused for all calls from a thread.
+    static thread_local std::string buffer;
+    const EnvelopeParts PARTS{serializeEnvelopeParts(buffer, envelope)};
+
+    std::size_t size{0};
+    for (const auto &part : PARTS) { size += part.second; }
+    if ((nullptr == out) || (0 == PARTS[0].second) || (capacity < size)) {
+        return 0;
+    }
+    for (const auto &part : PARTS) {
+        if (0 < part.second) {
+            std::memcpy(out, part.first, part.second);
+            out += part.second;
+        }
+    }
+    return size;
 }
 
 /**
@@ -77,8 +194,9 @@ inline std::pair<bool, cluon::data::Envelope> extractEnvelope(std::istream &in)
     cluon::data::Envelope env;
     if (in.good()) {
         constexpr uint8_t OD4_HEADER_SIZE{5};
-        std::vector<char> buffer;
-        buffer.reserve(OD4_HEADER_SIZE);
+        // The buffer is reused for all calls from a thread.
+        static thread_local std::vector<char> buffer;
+        buffer.resize(OD4_HEADER_SIZE);
 #ifdef WIN32                                           // LCOV_EXCL_LINE
         buffer.clear();                                // LCOV_EXCL_LINE
         retVal = true;                                 // LCOV_EXCL_LINE
@@ -90,12 +208,13 @@ inline std::pair<bool, cluon::data::Envelope> extractEnvelope(std::istream &in)
         }
         if (retVal) { // LCOV_EXCL_LINE
 #else                 // LCOV_EXCL_LINE
-        in.read(&buffer[0], OD4_HEADER_SIZE);
+        in.read(buffer.data(), OD4_HEADER_SIZE);
         if (OD4_HEADER_SIZE == in.gcount()) {
 #endif
             if ((0x0D == static_cast<uint8_t>(buffer[0])) && (0xA4 == static_cast<uint8_t>(buffer[1]))) {
-                const uint32_t LENGTH{le32toh(*reinterpret_cast<uint32_t *>(&buffer[1])) >> 8};
-                buffer.reserve(LENGTH);
+                const uint32_t LENGTH{static_cast<uint32_t>(static_cast<uint8_t>(buffer[2])) | (static_cast<uint32_t>(static_cast<uint8_t>(buffer[3])) << 8)
+                                      | (static_cast<uint32_t>(static_cast<uint8_t>(buffer[4])) << 16)};
+                buffer.resize(LENGTH);
 #ifdef WIN32                                           // LCOV_EXCL_LINE
                 buffer.clear();                        // LCOV_EXCL_LINE
                 for (uint32_t i{0}; i < LENGTH; i++) { // LCOV_EXCL_LINE
@@ -105,13 +224,13 @@ inline std::pair<bool, cluon::data::Envelope> extractEnvelope(std::istream &in)
                     buffer.push_back(c);               // LCOV_EXCL_LINE
                 }
 #else // LCOV_EXCL_LINE
-                in.read(&buffer[0], static_cast<std::streamsize>(LENGTH));
+                in.read(buffer.data(), static_cast<std::streamsize>(LENGTH));
                 retVal = static_cast<int32_t>(LENGTH) == in.gcount();
 #endif
                 if (retVal) {
-                    std::stringstream sstr(std::string(buffer.begin(), buffer.begin() + static_cast<std::streamsize>(LENGTH)));
+                    // Decode the Envelope in place.
                     cluon::FromProtoVisitor protoDecoder;
-                    protoDecoder.decodeFrom(sstr, env);
+                    protoDecoder.decodeFrom(buffer.data(), LENGTH, env);
                 }
             }
         }
@@ -119,6 +238,109 @@ inline std::pair<bool, cluon::data::Envelope> extractEnvelope(std::istream &in)
     return std::make_pair(retVal, env);
 }
 
+/**
+ * This method returns the Proto-encoded Envelope from memory that holds bytes
+ * in the same format as for extractEnvelope(const char *, std::size_t).
+ *
+ * @param data Pointer to the first byte of the OD4 header.
+ * @param size Number of available bytes.
+ * @return Pointer to the first byte and number of bytes of the Proto-encoded Envelope or nullptr.
+ */
+inline std::pair<const char *, std::size_t> unframeEnvelope(const char *data, std::size_t size) noexcept {
+    constexpr uint8_t OD4_HEADER_SIZE{5};
+    if ((nullptr != data) && (OD4_HEADER_SIZE <= size) && (0x0D == static_cast<uint8_t>(data[0])) && (0xA4 == static_cast<uint8_t>(data[1]))) {
+        const uint32_t LENGTH{static_cast<uint32_t>(static_cast<uint8_t>(data[2])) | (static_cast<uint32_t>(static_cast<uint8_t>(data[3])) << 8)
+                              | (static_cast<uint32_t>(static_cast<uint8_t>(data[4])) << 16)};
+        if (LENGTH <= (size - OD4_HEADER_SIZE)) {
+            return std::make_pair(data + OD4_HEADER_SIZE, static_cast<std::size_t>(LENGTH));
+        }
+    }
+    return std::make_pair(static_cast<const char *>(nullptr), static_cast<std::size_t>(0));
+}
+
+/**
+ * This method extracts an Envelope from the given memory that holds bytes in
+ * the same format as for extractEnvelope(std::istream &). The bytes are
+ * decoded in place without copying them into an intermediate buffer first.
+ *
+ * @param data Pointer to the first byte of the OD4 header.
+ * @param size Number of available bytes.
+ * @return cluon::data::Envelope.
+ */
+inline std::pair<bool, cluon::data::Envelope> extractEnvelope(const char *data, std::size_t size) noexcept {
+    cluon::data::Envelope env;
+    auto envelope = unframeEnvelope(data, size);
+    const bool retVal{nullptr != envelope.first};
+    if (retVal) {
+        cluon::FromProtoVisitor protoDecoder;
+        protoDecoder.decodeFrom(envelope.first, envelope.second, env);
+    }
+    return std::make_pair(retVal, env);
+}
+
+/**
+ * This class holds all fields of an Envelope except for its serializedData.
+ */
+class LIBCLUON_API EnvelopeMeta {
+   public:
+    int32_t m_dataType{0};
+    cluon::data::TimeStamp m_sent{};
+    cluon::data::TimeStamp m_received{};
+    cluon::data::TimeStamp m_sampleTimeStamp{};
+    uint32_t m_senderStamp{0};
+};
+
+/**
+ * This method calls the given function for every field of Proto-encoded
+ * bytes without decoding or copying the fields' values:
+ *
+ *    f(uint32_t fieldId, cluon::ProtoConstants type, uint64_t value, const char *bytes)
+ *
+ * For VARINT fields, value is the decoded VarInt and bytes is nullptr; for all
+ * other fields, value is the number of bytes starting at bytes.
+ *
+ * @param data Pointer to the first Proto-encoded byte.
+ * @param size Number of Proto-encoded bytes.
+ * @param f Function to call for every field.
+ * @return true if all fields are well-formed.
+ */
+template <typename F>
+inline bool forEachProtoField(const char *data, std::size_t size, F &&f) noexcept {
+    const char *pos{data};
+    const char *end{data + size};
+    uint64_t key{0};
+    uint64_t value{0};
+    while (pos < end) {
+        if (!decodeVarInt(pos, end, key)) {
+            return false;
+        }
+        const uint32_t FIELD_ID{static_cast<uint32_t>(key >> 3)};
+        const ProtoConstants TYPE{static_cast<ProtoConstants>(key & 0x7)};
+        switch (TYPE) {
+            case ProtoConstants::VARINT:
+                if (!decodeVarInt(pos, end, value)) {
+                    return false;
+                }
+                f(FIELD_ID, TYPE, value, static_cast<const char *>(nullptr));
+                continue;
+            case ProtoConstants::EIGHT_BYTES: value = 8; break;
+            case ProtoConstants::FOUR_BYTES: value = 4; break;
+            case ProtoConstants::LENGTH_DELIMITED:
+                if (!decodeVarInt(pos, end, value)) {
+                    return false;
+                }
+                break;
+            default: return false;
+        }
+        if (value > static_cast<uint64_t>(end - pos)) {
+            return false;
+        }
+        f(FIELD_ID, TYPE, value, pos);
+        pos += value;
+    }
+    return true;
+}
+
 /**
  * @return Extract a given Envelope's payload into the desired type.
  */
@@ -126,11 +348,9 @@ template <typename T>
 inline T extractMessage(cluon::data::Envelope &&envelope) noexcept {
     cluon::FromProtoVisitor decoder;
 
-    std::stringstream sstr(envelope.serializedData());
-    decoder.decodeFrom(sstr);
-
+    const std::string serializedData{envelope.serializedData()};
     T msg;
-    msg.accept(decoder);
+    decoder.decodeFrom(serializedData.data(), serializedData.size(), msg);
 
     return msg;
 }
@@ -0,0 +1,132 @@
+/*
+ * Copyright (C) 2017-2018  Christian Berger
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef CLUON_ENVELOPEREADER_HPP
+#define CLUON_ENVELOPEREADER_HPP
+
+#include "cluon/cluon.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <vector>
+
+namespace cluon {
+/**
+ * This class refers to an Envelope in the OD4 format inside the read buffer of
+ * an EnvelopeReader: m_data points to the OD4 header 0x0D 0xA4 LEN0 LEN1 LEN2
+ * that is followed by the Proto-encoded Envelope and m_size is the number of
+ * bytes including the OD4 header. Thus, it can be passed to the functions in
+ * Envelope.hpp and EnvelopeView.hpp, e.g., viewEnvelope(frame.m_data, frame.m_size).
+ */
+class LIBCLUON_API EnvelopeFrame {
+   public:
+    uint64_t m_position{0};
+    const char *m_data{nullptr};
+    std::size_t m_size{0};
+};
+
+/**
+This class reads Envelopes in the OD4 format from a file descriptor, an
+istream, or memory, e.g., from a .rec file or from stdin. The bytes are read in large
+blocks into a buffer that is reused for all Envelopes; the Envelopes are
+returned as EnvelopeFrames pointing into this buffer without allocating
+memory. Corrupt bytes between Envelopes are skipped by scanning for the next
+OD4 header with a length and Proto-encoded bytes that are well-formed.
+
+\code{.cpp}
+std::fstream recFile("myRecording.rec", std::ios::in | std::ios::binary);
+cluon::EnvelopeReader reader{recFile};
+cluon::EnvelopeFrame frame;
+while (reader.next(frame)) {
+    cluon::EnvelopeView view{cluon::viewEnvelope(frame.m_data, frame.m_size)};
+    std::cout << view.dataType() << "/" << view.senderStamp() << std::endl;
+}
+\endcode
+
+Reading from an istream does not block for more bytes than needed for the next
+Envelope when no further bytes are available (e.g., for pipes); thus, it can
+be used to process Envelopes as they arrive.
+*/
+class LIBCLUON_API EnvelopeReader {
+   private:
+    EnvelopeReader(const EnvelopeReader &) = delete;
+    EnvelopeReader(EnvelopeReader &&)      = delete;
+    EnvelopeReader &operator=(const EnvelopeReader &) = delete;
+    EnvelopeReader &operator=(EnvelopeReader &&) = delete;
+
+   public:
+    /**
+     * Constructor.
+     *
+     * @param fd File descriptor to read from; it is not closed by this reader.
+     * @param bufferSize Initial size of the read buffer; it grows for larger Envelopes.
+     */
+    explicit EnvelopeReader(int32_t fd, std::size_t bufferSize = DEFAULT_BUFFER_SIZE) noexcept;
+
+    /**
+     * Constructor.
+     *
+     * @param in Stream to read from; it must outlive this reader.
+     * @param bufferSize Initial size of the read buffer; it grows for larger Envelopes.
+     */
+    explicit EnvelopeReader(std::istream &in, std::size_t bufferSize = DEFAULT_BUFFER_SIZE) noexcept;
+
+    /**
+     * Constructor to read Envelopes from memory, e.g., from a MemoryMappedFile;
+     * the returned EnvelopeFrames point into the given memory.
+     *
+     * @param data Pointer to the first byte; the memory must outlive this reader.
+     * @param size Number of bytes.
+     */
+    EnvelopeReader(const char *data, std::size_t size) noexcept;
+
+    /**
+     * This method reads the next Envelope.
+     *
+     * @param frame Next Envelope; it is valid until the next call of this method.
+     * @return false if no further Envelope is available.
+     */
+    bool next(EnvelopeFrame &frame) noexcept;
+
+    /**
+     * @return Number of bytes that were skipped as they did not belong to a well-formed Envelope.
+     */
+    uint64_t numberOfSkippedBytes() const noexcept;
+
+   public:
+    static constexpr std::size_t DEFAULT_BUFFER_SIZE{1024 * 1024};
+
+   private:
+    /**
+     * This method reads further bytes into the buffer.
+     *
+     * @param minimum Number of bytes that shall be available in the buffer.
+     * @return true if minimum bytes are available.
+     */
+    bool fill(std::size_t minimum) noexcept;
+
+    /**
+     * @return Pointer to the first byte of the buffer or the given memory.
+     */
+    const char *bytes() const noexcept;
+
+   private:
+    int32_t m_fd{-1};
+    std::istream *m_in{nullptr};
+    const char *m_memory{nullptr};
+    bool m_endOfData{false};
+    std::vector<char> m_buffer{};
+    std::size_t m_begin{0};
+    std::size_t m_end{0};
+    uint64_t m_position{0};
+    uint64_t m_numberOfSkippedBytes{0};
+};
+} // namespace cluon
+
+#endif
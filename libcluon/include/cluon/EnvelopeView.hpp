@@ -0,0 +1,177 @@
+/*
+ * Copyright (C) 2017-2018  Christian Berger
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef CLUON_ENVELOPEVIEW_HPP
+#define CLUON_ENVELOPEVIEW_HPP
+
+#include "cluon/Envelope.hpp"
+#include "cluon/FromProtoVisitor.hpp"
+#include "cluon/cluon.hpp"
+#include "cluon/cluonDataStructures.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+namespace cluon {
+/**
+This class provides read access to a Proto-encoded Envelope in memory without
+decoding it in advance: The fields are located when one of them is accessed
+for the first time and each TimeStamp is decoded only when it is accessed;
+the serializedData is never copied but returned as pointer into the given
+memory. Thus, Envelopes can be filtered and routed by their dataType and
+senderStamp for the cost of one pass over their keys.
+
+The memory must outlive the EnvelopeView. As the decoded fields are cached,
+an EnvelopeView must not be accessed from several threads at the same time.
+
+\code{.cpp}
+cluon::EnvelopeView view{cluon::viewEnvelope(data, size)};
+if (MyMessage::ID() == view.dataType()) {
+    MyMessage msg{cluon::extractMessage<MyMessage>(view)};
+    std::cout << cluon::time::toMicroseconds(view.sampleTimeStamp()) << std::endl;
+}
+\endcode
+*/
+class LIBCLUON_API EnvelopeView {
+   public:
+    EnvelopeView() = default;
+
+    /**
+     * Constructor.
+     *
+     * @param data Pointer to the first byte of the Proto-encoded Envelope (without OD4 header).
+     * @param size Number of bytes of the Proto-encoded Envelope.
+     */
+    EnvelopeView(const char *data, std::size_t size) noexcept;
+
+    /**
+     * @return true if the Proto-encoded bytes are well-formed.
+     */
+    bool valid() const noexcept;
+
+    /**
+     * @return Message identifier of the contained message (0 if not present).
+     */
+    int32_t dataType() const noexcept;
+
+    /**
+     * @return Sender stamp of the contained message (0 if not present).
+     */
+    uint32_t senderStamp() const noexcept;
+
+    /**
+     * @return Pointer to the first byte and number of bytes of the serializedData (nullptr if not present).
+     */
+    std::pair<const char *, std::size_t> serializedData() const noexcept;
+
+    const cluon::data::TimeStamp &sent() const noexcept;
+    const cluon::data::TimeStamp &received() const noexcept;
+    const cluon::data::TimeStamp &sampleTimeStamp() const noexcept;
+
+    /**
+     * @return All fields except for serializedData.
+     */
+    EnvelopeMeta meta() const noexcept;
+
+    /**
+     * @return Envelope with all fields and a copy of the serializedData (empty if not valid).
+     */
+    cluon::data::Envelope toEnvelope() const noexcept;
+
+   private:
+    void locateFields() const noexcept;
+    const cluon::data::TimeStamp &timeStamp(uint8_t index) const noexcept;
+
+   private:
+    const char *m_data{nullptr};
+    std::size_t m_size{0};
+
+    // The following fields are filled when accessed for the first time.
+    mutable bool m_located{false};
+    mutable bool m_valid{false};
+    mutable int32_t m_dataType{0};
+    mutable uint32_t m_senderStamp{0};
+    mutable std::pair<const char *, std::size_t> m_serializedData{nullptr, 0};
+    // Proto-encoded bytes of sent, received, and sampleTimeStamp.
+    mutable std::array<std::pair<const char *, std::size_t>, 3> m_timeStampBytes{};
+    mutable std::array<cluon::data::TimeStamp, 3> m_timeStamps{};
+    mutable std::array<bool, 3> m_timeStampDecoded{{false, false, false}};
+};
+
+/**
+ * This method returns an EnvelopeView for memory that holds bytes in the same
+ * format as for extractEnvelope(const char *, std::size_t).
+ *
+ * @param data Pointer to the first byte of the OD4 header.
+ * @param size Number of available bytes.
+ * @return EnvelopeView that is not valid if the OD4 header is missing or incomplete.
+ */
+inline EnvelopeView viewEnvelope(const char *data, std::size_t size) noexcept {
+    auto envelope = unframeEnvelope(data, size);
+    return (nullptr != envelope.first) ? EnvelopeView(envelope.first, envelope.second) : EnvelopeView();
+}
+
+/**
+ * This method reads only the fields dataType and senderStamp of an Envelope
+ * from memory in the same format as for extractEnvelope(const char *, std::size_t)
+ * without decoding the other fields; thus, it does not allocate any memory
+ * and can be used to discard Envelopes of no interest before decoding them.
+ *
+ * @param data Pointer to the first byte of the OD4 header.
+ * @param size Number of available bytes.
+ * @param dataType Message identifier of the contained message (0 if not present).
+ * @param senderStamp Sender stamp of the contained message (0 if not present).
+ * @return true if the bytes contain a well-formed Envelope.
+ */
+inline bool peekEnvelope(const char *data, std::size_t size, int32_t &dataType, uint32_t &senderStamp) noexcept {
+    const EnvelopeView VIEW{viewEnvelope(data, size)};
+    dataType    = VIEW.dataType();
+    senderStamp = VIEW.senderStamp();
+    return VIEW.valid();
+}
+
+/**
+ * This method reads all fields of an Envelope from memory in the same format
+ * as for extractEnvelope(const char *, std::size_t) but does not copy its
+ * serializedData; instead, the location of the serializedData is returned to
+ * decode the contained message directly from the given memory.
+ *
+ * @param data Pointer to the first byte of the OD4 header.
+ * @param size Number of available bytes.
+ * @param meta All fields of the Envelope except for serializedData.
+ * @param serializedData Pointer to the first byte of the serializedData inside data (nullptr if not present).
+ * @param serializedDataSize Number of bytes of the serializedData.
+ * @return true if the bytes contain a well-formed Envelope.
+ */
+inline bool peekEnvelope(const char *data, std::size_t size, EnvelopeMeta &meta, const char *&serializedData, std::size_t &serializedDataSize) noexcept {
+    const EnvelopeView VIEW{viewEnvelope(data, size)};
+    const auto SERIALIZED_DATA = VIEW.serializedData();
+    meta                       = VIEW.meta();
+    serializedData             = SERIALIZED_DATA.first;
+    serializedDataSize         = SERIALIZED_DATA.second;
+    return VIEW.valid();
+}
+
+/**
+ * @return Extract a given EnvelopeView's payload into the desired type without copying it first.
+ */
+template <typename T>
+inline T extractMessage(const EnvelopeView &envelope) noexcept {
+    cluon::FromProtoVisitor decoder;
+
+    const std::pair<const char *, std::size_t> SERIALIZED_DATA{envelope.serializedData()};
+    T msg;
+    decoder.decodeFrom(SERIALIZED_DATA.first, SERIALIZED_DATA.second, msg);
+
+    return msg;
+}
+} // namespace cluon
+
+#endif
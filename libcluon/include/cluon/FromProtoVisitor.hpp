@@ -9,21 +9,34 @@
 #ifndef CLUON_FROMPROTOVISITOR_HPP
 #define CLUON_FROMPROTOVISITOR_HPP
 
+#include "cluon/Arena.hpp"
 #include "cluon/ProtoConstants.hpp"
+#include "cluon/VarInt.hpp"
 #include "cluon/cluon.hpp"
-#include "cluon/any/any.hpp"
 
 #include <cstdint>
 #include <cstddef>
 #include <array>
 #include <sstream>
 #include <string>
-#include <unordered_map>
 #include <vector>
 
 namespace cluon {
 /**
-This class decodes a given message from Proto format.
+This class decodes a given message from Proto format. The bytes can be read
+from an std::istream or directly from memory; the latter does not copy any
+bytes except for the values of string fields and reports malformed input:
+
+\code{.cpp}
+MyMessage msg;
+cluon::FromProtoVisitor protoDecoder;
+if (!protoDecoder.decodeFrom(data, size, msg)) {
+    // data is truncated or contains an unknown Proto type.
+}
+\endcode
+
+A FromProtoVisitor that is created inside an ArenaScope takes its internal
+memory from the active Arena and hence, must not outlive the ArenaScope.
 */
 class LIBCLUON_API FromProtoVisitor {
    private:
@@ -45,6 +58,15 @@ class LIBCLUON_API FromProtoVisitor {
      */
     void decodeFrom(std::istream &in) noexcept;
 
+    /**
+     * This method decodes the given memory into Proto.
+     *
+     * @param data Pointer to the first Proto-encoded byte.
+     * @param size Number of Proto-encoded bytes.
+     * @return true if all bytes were decoded; false if the bytes are malformed.
+     */
+    bool decodeFrom(const char *data, std::size_t size) noexcept;
+
    public:
     // The following methods are provided to allow an instance of this class to
     // be used as visitor for an instance with the method signature void accept<T>(T&);
@@ -72,19 +94,17 @@ class LIBCLUON_API FromProtoVisitor {
         (void)name;
 
         if (m_callToDecodeFromWithDirectVisit) {
-            std::stringstream sstr{std::move(std::string(m_stringValue.data(), static_cast<std::size_t>(m_value)))};
-            cluon::FromProtoVisitor nestedProtoDecoder;
-            nestedProtoDecoder.decodeFrom(sstr, v);
-        }
-        else if (0 < m_mapOfKeyValues.count(id)) {
-            try {
-                std::stringstream sstr{linb::any_cast<std::string>(m_mapOfKeyValues[id])};
+            // The nested message is decoded from the bytes of the enclosing one.
+            if (ProtoConstants::LENGTH_DELIMITED == m_protoType) {
                 cluon::FromProtoVisitor nestedProtoDecoder;
-                nestedProtoDecoder.decodeFrom(sstr);
-                v.accept(nestedProtoDecoder);
-            } catch (const linb::bad_any_cast &) { // LCOV_EXCL_LINE
+                m_isMalformed |= !nestedProtoDecoder.decodeFrom(m_bytes, static_cast<std::size_t>(m_value), v);
             }
         }
+        else if (const Field *field = findField(id, ProtoConstants::LENGTH_DELIMITED)) {
+            cluon::FromProtoVisitor nestedProtoDecoder;
+            nestedProtoDecoder.decodeFrom(m_source.data() + field->m_offset, static_cast<std::size_t>(field->m_value));
+            v.accept(nestedProtoDecoder);
+        }
     }
 
    public:
@@ -129,10 +149,11 @@ class LIBCLUON_API FromProtoVisitor {
                     {
                         fromVarInt(in, m_value);
                         const std::size_t BYTES_TO_READ_FROM_STREAM{static_cast<std::size_t>(m_value)};
-                        if (m_stringValue.capacity() < BYTES_TO_READ_FROM_STREAM) {
-                            m_stringValue.reserve(BYTES_TO_READ_FROM_STREAM);
+                        if (m_stringValue.size() < BYTES_TO_READ_FROM_STREAM) {
+                            m_stringValue.resize(BYTES_TO_READ_FROM_STREAM);
                         }
                         readBytesFromStream(in, BYTES_TO_READ_FROM_STREAM, m_stringValue.data());
+                        m_bytes = m_stringValue.data();
                         v.accept(m_fieldId, *this);
                     }
                     break;
@@ -142,6 +163,43 @@ class LIBCLUON_API FromProtoVisitor {
         m_callToDecodeFromWithDirectVisit = false;
     }
 
+    /**
+     * This method decodes the given memory directly into the corresponding
+     * fields of v. Nested messages are decoded from the same memory.
+     *
+     * @param data Pointer to the first Proto-encoded byte.
+     * @param size Number of Proto-encoded bytes.
+     * @param v Data structure to receive the decoded values.
+     * @return true if all bytes were decoded; false if the bytes are malformed.
+     */
+    template<typename T>
+    bool decodeFrom(const char *data, std::size_t size, T &v) noexcept {
+        m_callToDecodeFromWithDirectVisit = true;
+        m_isMalformed = false;
+        const char *pos{data};
+        const char *end{data + size};
+        while (!m_isMalformed && (pos < end)) {
+            if (readField(pos, end)) {
+                v.accept(m_fieldId, *this);
+            }
+            else {
+                m_isMalformed = true;
+            }
+        }
+        m_callToDecodeFromWithDirectVisit = false;
+        return !m_isMalformed;
+    }
+
+    /**
+     * This method decodes a VarInt from memory.
+     *
+     * @param pos Pointer to the first byte of the VarInt; moved behind the VarInt.
+     * @param end Pointer behind the last available byte.
+     * @param value Decoded value.
+     * @return true if a complete VarInt was decoded before end.
+     */
+    static bool fromVarInt(const char *&pos, const char *end, uint64_t &value) noexcept;
+
    private:
     int8_t fromZigZag8(uint8_t v) noexcept;
     int16_t fromZigZag16(uint16_t v) noexcept;
@@ -152,11 +210,58 @@ class LIBCLUON_API FromProtoVisitor {
 
     void readBytesFromStream(std::istream &in, std::size_t bytesToReadFromStream, char *buffer) noexcept;
 
+    /**
+     * This method reads the key and value of the next field from memory.
+     *
+     * @param pos Pointer to the first byte of the field; moved behind the field.
+     * @param end Pointer behind the last available byte.
+     * @return true if a complete field was read.
+     */
+    bool readField(const char *&pos, const char *end) noexcept;
+
    private:
     // This Boolean flag indicates whether we consecutively decode from istream
     // and inject the decoded values directly into the receiving data structure.
     bool m_callToDecodeFromWithDirectVisit{false};
-    std::unordered_map<uint32_t, linb::any, UseUInt32ValueAsHashKey> m_mapOfKeyValues{};
+
+    /**
+     * This class describes a field decoded by decodeFrom without visiting
+     * a data structure directly.
+     */
+    class Field {
+       public:
+        uint32_t m_fieldId{0};
+        ProtoConstants m_protoType{ProtoConstants::VARINT};
+        // Decoded VarInt, bits of a float or double, or number of bytes of a length-delimited field.
+        uint64_t m_value{0};
+        // Position of a length-delimited field's bytes in m_source.
+        std::size_t m_offset{0};
+    };
+
+    /**
+     * This method decodes all fields of m_source into m_fields.
+     *
+     * @return true if all bytes were decoded; false if the bytes are malformed.
+     */
+    bool indexFields() noexcept;
+
+    /**
+     * @return First field with the given identifier and Proto type or nullptr.
+     */
+    const Field *findField(uint32_t fieldId, ProtoConstants protoType) const noexcept;
+
+    // Field identifiers below this value are looked up in m_fieldIndex; the others are searched in m_fields.
+    static constexpr uint32_t MAX_INDEXED_FIELD_ID{1024};
+
+    // The bytes to decode are kept to visit length-delimited fields later;
+    // a field table is used instead of a map to not allocate per field. The
+    // memory is taken from the Arena that is active when this FromProtoVisitor
+    // is created as every nested message is decoded by a new FromProtoVisitor;
+    // an OD4Session activates its Arena only while decoding a typed message,
+    // not while its delegates are running.
+    std::basic_string<char, std::char_traits<char>, ArenaAllocator<char>> m_source{};
+    std::vector<Field, ArenaAllocator<Field>> m_fields{};
+    std::vector<uint32_t, ArenaAllocator<uint32_t>> m_fieldIndex{}; // Field identifier -> 1 + position in m_fields; 0 if not present.
 
    private:
     // Fields necessary to decode from an istream.
@@ -176,8 +281,14 @@ class LIBCLUON_API FromProtoVisitor {
         float floatValue{0};
     } m_floatValue;
 
-    // Buffer for strings.
-    std::vector<char> m_stringValue;
+    // Buffer for strings read from an istream.
+    std::vector<char, ArenaAllocator<char>> m_stringValue{};
+
+    // Bytes of the current length-delimited field with m_value bytes.
+    const char *m_bytes{nullptr};
+
+    // Set when decoding from memory encountered malformed bytes.
+    bool m_isMalformed{false};
 
     uint64_t m_keyFieldType{0};
     ProtoConstants m_protoType{ProtoConstants::VARINT};
@@ -0,0 +1,273 @@
+/*
+ * Copyright (C) 2017-2018  Christian Berger
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef CLUON_IOREACTOR_HPP
+#define CLUON_IOREACTOR_HPP
+
+#include "cluon/cluon.hpp"
+
+#include <cstdint>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+#include <unordered_map>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace cluon {
+/**
+This class provides event loops running in their own threads that wait for
+sockets to become readable and call a user-supplied delegate for every
+readable socket.
+
+On Linux, the event loops are based on epoll and an eventfd is used to wake up
+the threads on destruction; thus, idle sockets do not cause any periodic
+wake-ups and shutting down does not need to wait for a timeout. On other
+platforms, the event loops fall back to select() with a timeout of 20ms.
+
+UDPReceiver, TCPConnection, and TCPServer use an IOReactor to read from their
+sockets. By default, each of them creates its own IOReactor with one I/O thread
+and hands over received data to its own NotifyingPipeline thread. To reduce the
+number of threads in a process with many sockets, a single IOReactor can be
+shared among several instances (e.g., OD4Sessions joining many CIDs):
+
+\code{.cpp}
+// Two I/O threads waiting for data and two threads calling the delegates.
+auto reactor = std::make_shared<cluon::IOReactor>(2, 2);
+
+cluon::OD4Session od4_111{111, nullptr, reactor};
+cluon::OD4Session od4_112{112, nullptr, reactor};
+\endcode
+
+Sockets are distributed round-robin to the I/O threads. The received data is
+handed over to dispatch queues; all tasks of one dispatch queue are executed in
+order and never concurrently. Any idle dispatch thread picks up the next
+dispatch queue with pending tasks; thus, a slow task only delays the tasks of
+its own dispatch queue as long as other dispatch threads are available. If no
+dispatch threads are requested, the tasks are executed directly in the I/O
+thread.
+
+The IOReactor can also be used directly:
+
+\code{.cpp}
+cluon::IOReactor reactor;
+reactor.addSocket(socket, [](){ std::cout << "Socket is readable." << std::endl; });
+
+// Do something in parallel.
+
+reactor.removeSocket(socket);
+\endcode
+
+An IOReactor without I/O threads only provides dispatch queues, for example to
+execute tasks of several independent streams in parallel while keeping the
+order within each stream:
+
+\code{.cpp}
+cluon::IOReactor dispatcher(0, 4);
+const uint32_t queue{dispatcher.createDispatchQueue()};
+dispatcher.dispatch(queue, [](){ std::cout << "Executed in order." << std::endl; });
+\endcode
+*/
+class LIBCLUON_API IOReactor {
+   private:
+    IOReactor(const IOReactor &) = delete;
+    IOReactor(IOReactor &&)      = delete;
+    IOReactor &operator=(const IOReactor &) = delete;
+    IOReactor &operator=(IOReactor &&) = delete;
+
+   public:
+    /**
+     * Constructor.
+     *
+     * @param numberOfIOThreads Number of threads waiting for sockets to become readable (at least 1 unless dispatch threads are requested).
+     * @param numberOfDispatchThreads Number of threads to execute dispatched tasks; 0 executes them in the I/O threads.
+     */
+    IOReactor(uint8_t numberOfIOThreads = 1, uint8_t numberOfDispatchThreads = 0) noexcept;
+
+    /**
+     * Destructor; it can also be called from within a dispatched task, e.g.,
+     * when releasing the last reference to this IOReactor.
+     */
+    ~IOReactor() noexcept;
+
+    /**
+     * @return true if the IOReactor could successfully be created and is waiting for sockets to become readable.
+     */
+    bool isRunning() const noexcept;
+
+    /**
+     * @return Number of threads that execute dispatched tasks.
+     */
+    uint8_t numberOfDispatchThreads() const noexcept;
+
+    /**
+     * This method adds a socket to be watched for incoming data.
+     *
+     * @param socket Socket to watch.
+     * @param delegate Functional to be called from an I/O thread whenever the socket is readable.
+     * @return true if the socket could be added.
+     */
+    bool addSocket(int32_t socket, std::function<void()> delegate) noexcept;
+
+    /**
+     * This method removes a previously added socket. When this method returns,
+     * the socket's delegate is not running and will not be called anymore.
+     * This method can also be called from within the socket's delegate.
+     *
+     * @param socket Socket to remove.
+     */
+    void removeSocket(int32_t socket) noexcept;
+
+    /**
+     * This method creates a new dispatch queue; all tasks that are dispatched
+     * to the same queue are executed in order and not concurrently.
+     *
+     * @return Identifier for the new dispatch queue.
+     */
+    uint32_t createDispatchQueue() noexcept;
+
+    /**
+     * This method dispatches a task to the given dispatch queue.
+     *
+     * @param dispatchQueue Identifier of the dispatch queue.
+     * @param task Task to be executed.
+     */
+    void dispatch(uint32_t dispatchQueue, std::function<void()> &&task) noexcept;
+
+    /**
+     * This method removes all pending tasks of the given dispatch queue. When
+     * this method returns, no task of this queue is running anymore unless it
+     * is called from within such a task.
+     *
+     * @param dispatchQueue Identifier of the dispatch queue.
+     */
+    void removeDispatchQueue(uint32_t dispatchQueue) noexcept;
+
+   private:
+    /**
+     * This class waits in its own thread for a set of sockets to become readable.
+     */
+    class EventLoop {
+       private:
+        EventLoop(const EventLoop &) = delete;
+        EventLoop(EventLoop &&)      = delete;
+        EventLoop &operator=(const EventLoop &) = delete;
+        EventLoop &operator=(EventLoop &&) = delete;
+
+       public:
+        EventLoop() noexcept;
+        ~EventLoop() noexcept;
+
+        bool isRunning() const noexcept;
+        bool addSocket(int32_t socket, std::function<void()> &&delegate) noexcept;
+        void removeSocket(int32_t socket) noexcept;
+
+       private:
+        void processEvents() noexcept;
+
+        /**
+         * This method calls the delegate that is registered for the given socket.
+         *
+         * @param socket Socket that is readable.
+         * @param registrationIdentifier Identifier of the registration to ignore stale events for reused socket numbers.
+         */
+        void callDelegate(int32_t socket, uint32_t registrationIdentifier) noexcept;
+
+       private:
+        int32_t m_epollFileDescriptor{-1};
+        int32_t m_wakeUpFileDescriptor{-1};
+
+        std::atomic<bool> m_processEventsThreadRunning{false};
+        std::thread m_processEventsThread{};
+
+       private:
+        class Registration {
+           public:
+            uint32_t m_identifier{0};
+            std::shared_ptr<std::function<void()>> m_delegate{};
+        };
+
+        // The mutex is not held while a delegate is running to allow delegates
+        // adding or removing sockets; instead, m_socketInDelegate tracks the
+        // socket whose delegate is running.
+        std::mutex m_registrationsMutex{};
+        std::condition_variable m_delegateFinished{};
+        std::map<int32_t, Registration> m_registrations{};
+        uint32_t m_nextRegistrationIdentifier{1};
+        int32_t m_socketInDelegate{-1};
+    };
+
+    /**
+     * This class executes dispatched tasks in a pool of threads. A dispatch
+     * queue with pending tasks is picked up by any idle thread; the tasks of
+     * one dispatch queue are executed by at most one thread at a time.
+     */
+    class Dispatcher {
+       private:
+        Dispatcher(const Dispatcher &) = delete;
+        Dispatcher(Dispatcher &&)      = delete;
+        Dispatcher &operator=(const Dispatcher &) = delete;
+        Dispatcher &operator=(Dispatcher &&) = delete;
+
+       public:
+        explicit Dispatcher(uint8_t numberOfThreads) noexcept;
+        ~Dispatcher() noexcept;
+
+        bool isRunning() const noexcept;
+        // Stops the threads after their current task; they are joined when destroying this Dispatcher.
+        void stop() noexcept;
+        // true if called from one of the threads executing the dispatched tasks.
+        bool isDispatchThread() const noexcept;
+        uint8_t numberOfThreads() const noexcept;
+        void dispatch(uint32_t dispatchQueue, std::function<void()> &&task) noexcept;
+        void removeDispatchQueue(uint32_t dispatchQueue) noexcept;
+
+       private:
+        void processTasks() noexcept;
+
+       private:
+        class DispatchQueue {
+           public:
+            std::deque<std::function<void()>> m_tasks{};
+            // true while this queue is waiting in m_readyDispatchQueues.
+            bool m_isReady{false};
+            // true while a thread executes a task of this queue.
+            bool m_isRunning{false};
+            // true if this queue was removed from within one of its tasks.
+            bool m_isRemoved{false};
+            std::thread::id m_runningThread{};
+        };
+
+        std::atomic<bool> m_processTasksThreadsRunning{false};
+        std::vector<std::thread> m_processTasksThreads{};
+
+        std::mutex m_tasksMutex{};
+        std::condition_variable m_tasksCondition{};
+        std::condition_variable m_taskFinished{};
+        std::unordered_map<uint32_t, DispatchQueue> m_dispatchQueues{};
+        std::deque<uint32_t> m_readyDispatchQueues{};
+    };
+
+   private:
+    std::vector<std::unique_ptr<EventLoop>> m_eventLoops{};
+    std::unique_ptr<Dispatcher> m_dispatcher{};
+
+    std::mutex m_socketsMutex{};
+    std::map<int32_t, std::size_t> m_eventLoopForSocket{};
+    std::size_t m_nextEventLoop{0};
+
+    std::atomic<uint32_t> m_nextDispatchQueue{1};
+};
+} // namespace cluon
+
+#endif
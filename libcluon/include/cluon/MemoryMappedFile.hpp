@@ -0,0 +1,105 @@
+/*
+ * Copyright (C) 2017-2018  Christian Berger
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef CLUON_MEMORYMAPPEDFILE_HPP
+#define CLUON_MEMORYMAPPEDFILE_HPP
+
+#include "cluon/cluon.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace cluon {
+
+/**
+ * Expected access pattern to the pages of a MemoryMappedFile:
+ * NORMAL: default read-ahead of the operating system.
+ * SEQUENTIAL: pages are read in ascending order; more pages are read ahead and read pages can be dropped early.
+ * RANDOM: pages are read in no particular order; no pages are read ahead.
+ */
+enum class MemoryMappedFileAccess : uint8_t {
+    NORMAL     = 0,
+    SEQUENTIAL = 1,
+    RANDOM     = 2,
+};
+
+/**
+This class maps a file read-only into memory. The bytes of the file can be
+accessed directly in the mapped pages that are read by the operating system
+when they are accessed for the first time; thus, no bytes are copied into
+user-supplied buffers.
+
+\code{.cpp}
+cluon::MemoryMappedFile file{"myRecording.rec"};
+if (file.isMapped()) {
+    file.advise(cluon::MemoryMappedFileAccess::SEQUENTIAL);
+    cluon::EnvelopeReader reader{file.data(), file.size()};
+}
+\endcode
+
+Empty files cannot be mapped. The file must not be truncated while it is
+mapped as accessing pages behind its end causes a SIGBUS.
+*/
+class LIBCLUON_API MemoryMappedFile {
+   private:
+    MemoryMappedFile(const MemoryMappedFile &) = delete;
+    MemoryMappedFile(MemoryMappedFile &&)      = delete;
+    MemoryMappedFile &operator=(const MemoryMappedFile &) = delete;
+    MemoryMappedFile &operator=(MemoryMappedFile &&) = delete;
+
+   public:
+    /**
+     * Constructor.
+     *
+     * @param file File to map.
+     */
+    explicit MemoryMappedFile(const std::string &file) noexcept;
+    ~MemoryMappedFile() noexcept;
+
+    /**
+     * @return true if the file is mapped.
+     */
+    bool isMapped() const noexcept;
+
+    /**
+     * @return Pointer to the first byte of the file or nullptr if it is not mapped.
+     */
+    const char *data() const noexcept;
+
+    /**
+     * @return Number of mapped bytes.
+     */
+    std::size_t size() const noexcept;
+
+    /**
+     * This method tells the operating system how the pages will be accessed.
+     *
+     * @param access Expected access pattern.
+     */
+    void advise(MemoryMappedFileAccess access) const noexcept;
+
+    /**
+     * This method asks the operating system to read the given bytes in background.
+     *
+     * @param offset Position of the first byte to read.
+     * @param length Number of bytes to read (limited to the end of the file).
+     */
+    void prefetch(uint64_t offset, std::size_t length) const noexcept;
+
+   private:
+    const char *m_data{nullptr};
+    std::size_t m_size{0};
+#ifdef WIN32
+    void *m_fileHandle{nullptr};
+    void *m_mappingHandle{nullptr};
+#endif
+};
+} // namespace cluon
+
+#endif
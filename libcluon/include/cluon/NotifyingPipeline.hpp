@@ -11,15 +11,42 @@
 
 #include "cluon/cluon.hpp"
 
+#include <cstddef>
+#include <cstdint>
+#include <algorithm>
 #include <atomic>
 #include <condition_variable>
 #include <deque>
 #include <functional>
 #include <mutex>
 #include <thread>
+#include <utility>
+#include <vector>
 
 namespace cluon {
 
+/**
+ * Storage used by NotifyingPipeline:
+ * DEQUE: unbounded queue protected by a mutex; entries can be added from several threads.
+ * SPSC_RING_BUFFER: bounded lock-free ring buffer; entries must only be added from one thread.
+ */
+enum class NotifyingPipelineType : uint8_t {
+    DEQUE            = 0,
+    SPSC_RING_BUFFER = 1,
+};
+
+/**
+ * Behavior of NotifyingPipeline when adding an entry to a pipeline that has reached its capacity:
+ * DROP_OLDEST: the oldest waiting entry is dropped (behaves like DROP_NEWEST for SPSC_RING_BUFFER as only the pipeline's thread may remove entries).
+ * DROP_NEWEST: the entry to be added is dropped.
+ * BLOCK_PRODUCER: the adding thread waits until the pipeline's thread has made room.
+ */
+enum class NotifyingPipelineOverflowPolicy : uint8_t {
+    DROP_OLDEST    = 0,
+    DROP_NEWEST    = 1,
+    BLOCK_PRODUCER = 2,
+};
+
 template <class T>
 class LIBCLUON_API NotifyingPipeline {
    private:
@@ -29,20 +56,39 @@ class LIBCLUON_API NotifyingPipeline {
     NotifyingPipeline &operator=(NotifyingPipeline &&) = delete;
 
    public:
-    NotifyingPipeline(std::function<void(T &&)> delegate)
-        : m_delegate(delegate) {
-        m_pipelineThread = std::thread(&NotifyingPipeline::processPipeline, this);
+    /**
+     * Constructor.
+     *
+     * @param delegate Functional to be called from the pipeline's thread for every entry.
+     * @param type Storage to be used for the entries.
+     * @param capacity Number of entries in the ring buffer (rounded up to the next power of two); ignored for DEQUE.
+     */
+    NotifyingPipeline(std::function<void(T &&)> delegate,
+                      NotifyingPipelineType type = NotifyingPipelineType::DEQUE,
+                      std::size_t capacity       = DEFAULT_RING_BUFFER_CAPACITY)
+        : m_delegate(delegate)
+        , m_type(type) {
+        if (NotifyingPipelineType::SPSC_RING_BUFFER == m_type) {
+            std::size_t size{2};
+            while (size < capacity) { size <<= 1; }
+            m_ringBuffer.resize(size);
+            m_ringBufferMask = size - 1;
+        }
 
-        // Let the operating system spawn the thread.
-        using namespace std::literals::chrono_literals; // NOLINT
-        do { std::this_thread::sleep_for(1ms); } while (!m_pipelineThreadRunning.load());
+        // Indicate that we are ready before spawning the thread to not delay the caller.
+        m_pipelineThreadRunning.store(true);
+        m_pipelineThread = std::thread(&NotifyingPipeline::processPipeline, this);
     }
 
     ~NotifyingPipeline() {
-        m_pipelineThreadRunning.store(false);
+        {
+            std::lock_guard<std::mutex> lck(m_pipelineMutex);
+            m_pipelineThreadRunning.store(false);
+        }
 
         // Wake any waiting threads.
         m_pipelineCondition.notify_all();
+        m_spaceAvailableCondition.notify_all();
 
         // Joining the thread could fail.
         try {
@@ -53,58 +99,204 @@ class LIBCLUON_API NotifyingPipeline {
     }
 
    public:
-    inline void add(T &&entry) noexcept {
-        std::unique_lock<std::mutex> lck(m_pipelineMutex);
-        m_pipeline.emplace_back(entry);
+    /**
+     * This method limits the number of entries waiting to be processed.
+     *
+     * @param capacity Maximum number of entries; 0 means unbounded for DEQUE and the ring buffer's size for SPSC_RING_BUFFER.
+     *                 For DEQUE, entries being processed are included; SPSC_RING_BUFFER releases an entry's slot before processing it.
+     * @param policy Behavior when an entry is added while the capacity is reached.
+     */
+    inline void setCapacity(std::size_t capacity, NotifyingPipelineOverflowPolicy policy) noexcept {
+        {
+            std::lock_guard<std::mutex> lck(m_pipelineMutex);
+            m_capacity.store(capacity);
+            m_overflowPolicy.store(policy);
+        }
+        // A producer might wait for a smaller capacity.
+        m_spaceAvailableCondition.notify_all();
     }
 
-    inline void notifyAll() noexcept { m_pipelineCondition.notify_all(); }
+    /**
+     * @return Number of entries that are waiting to be processed (including the ones being processed for DEQUE).
+     */
+    inline std::size_t size() noexcept {
+        std::size_t retVal{0};
+        if (NotifyingPipelineType::SPSC_RING_BUFFER == m_type) {
+            // Read m_head first as the pipeline's thread cannot move it past a later value of m_tail.
+            const std::size_t HEAD{m_head.load(std::memory_order_acquire)};
+            const std::size_t TAIL{m_tail.load(std::memory_order_acquire)};
+            retVal = std::min(TAIL - HEAD, m_ringBufferMask + 1);
+        } else {
+            std::lock_guard<std::mutex> lck(m_pipelineMutex);
+            retVal = m_pipeline.size() + m_entriesInFlight.load();
+        }
+        return retVal;
+    }
+
+    /**
+     * @return Number of entries that were dropped due to the capacity.
+     */
+    inline uint64_t numberOfDroppedEntries() const noexcept { return m_droppedEntries.load(); }
+
+    /**
+     * This method adds an entry to the pipeline; call notifyAll() to process it.
+     * When the capacity is reached, the entry is handled according to the
+     * overflow policy (cf. setCapacity).
+     *
+     * @param entry Entry to be moved into the pipeline.
+     * @return true if the entry was added, false if it was dropped (the entry is left untouched).
+     */
+    inline bool add(T &&entry) noexcept {
+        bool retVal{false};
+        if (NotifyingPipelineType::SPSC_RING_BUFFER == m_type) {
+            const std::size_t CAPACITY{ringBufferCapacity()};
+            const std::size_t TAIL{m_tail.load(std::memory_order_relaxed)};
+            if ((NotifyingPipelineOverflowPolicy::BLOCK_PRODUCER == m_overflowPolicy.load()) && ((TAIL - m_head.load(std::memory_order_acquire)) >= CAPACITY)) {
+                try {
+                    std::unique_lock<std::mutex> lck(m_pipelineMutex);
+                    // Announce the waiting producer before checking for room again so that
+                    // the pipeline's thread either sees the flag or this thread sees the room.
+                    m_producerWaiting.store(true);
+                    // Only the pipeline's thread can make room; thus, wake it up and wait.
+                    m_pipelineCondition.notify_all();
+                    m_spaceAvailableCondition.wait(lck, [this, TAIL] {
+                        return (!this->m_pipelineThreadRunning.load() || ((TAIL - this->m_head.load()) < this->ringBufferCapacity())
+                                || (NotifyingPipelineOverflowPolicy::BLOCK_PRODUCER != this->m_overflowPolicy.load()));
+                    });
+                    m_producerWaiting.store(false);
+                } catch (...) {} // LCOV_EXCL_LINE
+            }
+            if ((TAIL - m_head.load(std::memory_order_acquire)) < ringBufferCapacity()) {
+                m_ringBuffer[TAIL & m_ringBufferMask] = std::move(entry);
+                m_tail.store(TAIL + 1, std::memory_order_release);
+                retVal = true;
+            }
+        } else {
+            try {
+                std::unique_lock<std::mutex> lck(m_pipelineMutex);
+                const std::size_t CAPACITY{m_capacity.load()};
+                if ((0 < CAPACITY) && (dequeSize() >= CAPACITY)) {
+                    if (NotifyingPipelineOverflowPolicy::BLOCK_PRODUCER == m_overflowPolicy.load()) {
+                        // Announce the waiting producer before checking for room again (cf. wakeBlockedProducer).
+                        m_producerWaiting.store(true);
+                        // Wake up the pipeline's thread as the caller might not have called notifyAll yet.
+                        m_pipelineCondition.notify_all();
+                        m_spaceAvailableCondition.wait(lck, [this] {
+                            const std::size_t C{this->m_capacity.load()};
+                            return (!this->m_pipelineThreadRunning.load() || (0 == C) || (this->dequeSize() < C)
+                                    || (NotifyingPipelineOverflowPolicy::BLOCK_PRODUCER != this->m_overflowPolicy.load()));
+                        });
+                        m_producerWaiting.store(false);
+                    }
+                    // Apply the policy in case the capacity is still reached; entries being processed cannot be dropped.
+                    while ((0 < m_capacity.load()) && !m_pipeline.empty() && (dequeSize() >= m_capacity.load())
+                           && (NotifyingPipelineOverflowPolicy::DROP_OLDEST == m_overflowPolicy.load())) {
+                        m_pipeline.pop_front();
+                        m_droppedEntries++;
+                    }
+                }
+                if ((0 == m_capacity.load()) || (dequeSize() < m_capacity.load())) {
+                    m_pipeline.emplace_back(std::move(entry));
+                    retVal = true;
+                }
+            } catch (...) {} // LCOV_EXCL_LINE
+        }
+        if (!retVal) {
+            m_droppedEntries++;
+        }
+        return retVal;
+    }
+
+    inline void notifyAll() noexcept {
+        if (NotifyingPipelineType::SPSC_RING_BUFFER == m_type) {
+            // The ring buffer is not guarded by the mutex; thus, acquire it
+            // briefly to not lose a notification while the thread is about to wait.
+            std::lock_guard<std::mutex> lck(m_pipelineMutex);
+        }
+        m_pipelineCondition.notify_all();
+    }
 
     inline bool isRunning() noexcept { return m_pipelineThreadRunning.load(); }
 
    private:
-    inline void processPipeline() noexcept {
-        // Indicate to caller that we are ready.
-        m_pipelineThreadRunning.store(true);
+    inline std::size_t ringBufferCapacity() const noexcept {
+        const std::size_t CAPACITY{m_capacity.load()};
+        return ((0 < CAPACITY) && (CAPACITY <= m_ringBufferMask)) ? CAPACITY : (m_ringBufferMask + 1);
+    }
 
-        while (m_pipelineThreadRunning.load()) {
-            std::unique_lock<std::mutex> lck(m_pipelineMutex);
-            // Wait until the thread should stop or data is available.
-            m_pipelineCondition.wait(lck, [this] { return (!this->m_pipelineThreadRunning.load() || !this->m_pipeline.empty()); });
+    inline void wakeBlockedProducer() noexcept {
+        if (NotifyingPipelineOverflowPolicy::BLOCK_PRODUCER == m_overflowPolicy.load()) {
+            // Order the release of the slot before reading the flag (cf. add).
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (m_producerWaiting.load()) {
+                {
+                    std::lock_guard<std::mutex> lck(m_pipelineMutex);
+                }
+                m_spaceAvailableCondition.notify_all();
+            }
+        }
+    }
+
+    // Must be called while holding m_pipelineMutex.
+    inline std::size_t dequeSize() const noexcept { return m_pipeline.size() + m_entriesInFlight.load(); }
 
-            // The condition will automatically lock the mutex after waking up.
-            // As we are locking per entry, we need to unlock the mutex first.
-            lck.unlock();
+    inline bool isEmpty() const noexcept {
+        return (NotifyingPipelineType::SPSC_RING_BUFFER == m_type) ? (m_head.load(std::memory_order_relaxed) == m_tail.load(std::memory_order_acquire))
+                                                                   : m_pipeline.empty();
+    }
 
-            uint32_t entries{0};
+    inline void processPipeline() noexcept {
+        std::deque<T> entries;
+        while (m_pipelineThreadRunning.load()) {
             {
-                lck.lock();
-                entries = static_cast<uint32_t>(m_pipeline.size());
-                lck.unlock();
-            }
-            for (uint32_t i{0}; i < entries; i++) {
-                T entry;
-                {
-                    lck.lock();
-                    entry = m_pipeline.front();
-                    lck.unlock();
-                }
+                std::unique_lock<std::mutex> lck(m_pipelineMutex);
+                // Wait until the thread should stop or data is available.
+                m_pipelineCondition.wait(lck, [this] { return (!this->m_pipelineThreadRunning.load() || !this->isEmpty()); });
 
-                if (nullptr != m_delegate) {
-                    m_delegate(std::move(entry));
+                if (NotifyingPipelineType::DEQUE == m_type) {
+                    if (0 == m_capacity.load()) {
+                        // Take all pending entries at once to process them without holding the lock.
+                        entries.swap(m_pipeline);
+                    } else if (!m_pipeline.empty()) {
+                        // Take one entry at a time to keep the others subject to the capacity and the overflow policy.
+                        entries.emplace_back(std::move(m_pipeline.front()));
+                        m_pipeline.pop_front();
+                    }
+                    // The taken entries count against the capacity until they are processed.
+                    m_entriesInFlight.store(entries.size());
                 }
+            }
 
-                {
-                    lck.lock();
-                    m_pipeline.pop_front();
-                    lck.unlock();
+            if (NotifyingPipelineType::SPSC_RING_BUFFER == m_type) {
+                std::size_t head{m_head.load(std::memory_order_relaxed)};
+                while (head != m_tail.load(std::memory_order_acquire)) {
+                    T entry{std::move(m_ringBuffer[head & m_ringBufferMask])};
+                    // Release the slot before calling the delegate.
+                    m_head.store(++head, std::memory_order_release);
+                    wakeBlockedProducer();
+                    if (nullptr != m_delegate) {
+                        m_delegate(std::move(entry));
+                    }
+                }
+            } else {
+                for (auto &entry : entries) {
+                    if (nullptr != m_delegate) {
+                        m_delegate(std::move(entry));
+                    }
+                    m_entriesInFlight--;
+                    wakeBlockedProducer();
                 }
+                entries.clear();
             }
         }
     }
 
    private:
+    static constexpr std::size_t DEFAULT_RING_BUFFER_CAPACITY{4096};
+    static constexpr std::size_t CACHE_LINE_SIZE{64};
+
     std::function<void(T &&)> m_delegate;
+    const NotifyingPipelineType m_type;
 
     std::atomic<bool> m_pipelineThreadRunning{false};
     std::thread m_pipelineThread{};
@@ -112,6 +304,23 @@ class LIBCLUON_API NotifyingPipeline {
     std::condition_variable m_pipelineCondition{};
 
     std::deque<T> m_pipeline{};
+    // Entries of a DEQUE that were taken by the pipeline's thread but not processed yet.
+    std::atomic<std::size_t> m_entriesInFlight{0};
+
+    std::atomic<std::size_t> m_capacity{0};
+    std::atomic<NotifyingPipelineOverflowPolicy> m_overflowPolicy{NotifyingPipelineOverflowPolicy::DROP_NEWEST};
+    std::atomic<uint64_t> m_droppedEntries{0};
+    std::condition_variable m_spaceAvailableCondition{};
+    std::atomic<bool> m_producerWaiting{false};
+
+    // Ring buffer: m_head is only written by the pipeline's thread, m_tail only by the producer;
+    // they are padded to not share a cache line.
+    std::vector<T> m_ringBuffer{};
+    std::size_t m_ringBufferMask{0};
+    std::atomic<std::size_t> m_head{0};
+    char m_headPadding[CACHE_LINE_SIZE]{};
+    std::atomic<std::size_t> m_tail{0};
+    char m_tailPadding[CACHE_LINE_SIZE]{};
 };
 } // namespace cluon
 
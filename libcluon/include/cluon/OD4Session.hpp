@@ -9,6 +9,11 @@
 #ifndef CLUON_OD4SESSION_HPP
 #define CLUON_OD4SESSION_HPP
 
+#include "cluon/Arena.hpp"
+#include "cluon/BufferPool.hpp"
+#include "cluon/Envelope.hpp"
+#include "cluon/FromProtoVisitor.hpp"
+#include "cluon/IOReactor.hpp"
 #include "cluon/Time.hpp"
 #include "cluon/ToProtoVisitor.hpp"
 #include "cluon/UDPReceiver.hpp"
@@ -16,16 +21,33 @@
 #include "cluon/cluon.hpp"
 #include "cluon/cluonDataStructures.hpp"
 
+#include <atomic>
 #include <chrono>
 #include <cstdint>
 #include <functional>
+#include <map>
 #include <memory>
 #include <mutex>
 #include <string>
 #include <unordered_map>
 #include <utility>
+#include <vector>
 
 namespace cluon {
+
+/**
+ * Threads to call the data-triggered delegates of an OD4Session:
+ * PIPELINE_THREAD: all delegates are called from the thread receiving the Envelopes.
+ * PER_MESSAGE_IDENTIFIER: delegates are called from a pool of worker threads; Envelopes with the same message identifier are delivered in order.
+ * PER_MESSAGE_IDENTIFIER_AND_SENDER_STAMP: like PER_MESSAGE_IDENTIFIER but in order per pair of message identifier and sender stamp;
+ *                                          the sender stamps of one message identifier are distributed over one dispatch queue per worker thread.
+ */
+enum class OD4SessionDispatchMode : uint8_t {
+    PIPELINE_THREAD                         = 0,
+    PER_MESSAGE_IDENTIFIER                  = 1,
+    PER_MESSAGE_IDENTIFIER_AND_SENDER_STAMP = 2,
+};
+
 /**
 This class provides an interface to an OpenDaVINCI v4 session. An OpenDaVINCI
 v4 session allows the automatic exchange of time-stamped Envelopes carrying
@@ -59,6 +81,20 @@ MyMessage msg;
 od4.send(msg);
 \endcode
 
+When only the contained message is of interest, it can be decoded directly
+from the received bytes without creating an Envelope and copying its payload
+first; all other fields of the Envelope are passed as cluon::EnvelopeMeta:
+
+\code{.cpp}
+cluon::OD4Session od4{111};
+od4.dataTrigger<MyMessage>([](MyMessage &&msg, const cluon::EnvelopeMeta &meta){ std::cout << "Received MyMessage from " << meta.m_senderStamp << std::endl;});
+\endcode
+
+The typed delegates' messages are decoded inside an ArenaScope of the calling
+thread that ends before the delegate is called; thus, the scratch memory of the
+decoder is reused for the next message while the delegates are free to keep
+any objects they create.
+
 Next to receive Envelopes, OD4Session can call a user-supplied lambda in a time-triggered
 way. The lambda is executed as long as it does not return false or throws an exception
 that is then caught in the method timeTrigger and the method is exited:
@@ -72,6 +108,36 @@ od4.timeTrigger(FREQ, [](){
   return false;
 }); // This call blocks until the lambda returns false.
 \endcode
+
+Every OD4Session uses two threads to receive Envelopes by default. Processes
+that participate in many OpenDaVINCI sessions can share one IOReactor with a
+configurable number of threads among all OD4Sessions instead:
+
+\code{.cpp}
+// One thread waiting for data from all sessions, two threads calling the delegates.
+auto reactor = std::make_shared<cluon::IOReactor>(1, 2);
+cluon::OD4Session od4_111{111, nullptr, reactor};
+cluon::OD4Session od4_112{112, nullptr, reactor};
+\endcode
+
+By default, all data-triggered delegates are called one after another from the
+thread receiving the Envelopes; thus, a slow delegate (e.g., decoding images)
+delays all other message types. Instead, the Envelopes can be distributed to a
+pool of worker threads; Envelopes of the same stream are still delivered in
+order and the execution time of every delegate is recorded:
+
+\code{.cpp}
+cluon::OD4Session od4{111};
+od4.setDispatchMode(cluon::OD4SessionDispatchMode::PER_MESSAGE_IDENTIFIER, 4);
+od4.dataTrigger(MyImage::ID(), [](cluon::data::Envelope &&envelope){ decode(envelope); });
+od4.dataTrigger(MyMessage::ID(), [](cluon::data::Envelope &&envelope){ std::cout << "Not delayed by images." << std::endl; });
+
+// Do something in parallel.
+
+for (auto &e : od4.dataTriggerStatistics()) {
+    std::cout << e.first << ": " << e.second.m_numberOfCalls << " calls, max. " << e.second.m_maximumExecutionTime.count() << "ns" << std::endl;
+}
+\endcode
 */
 class LIBCLUON_API OD4Session {
    private:
@@ -89,8 +155,22 @@ class LIBCLUON_API OD4Session {
      *        if a nullptr is passed, the method dataTrigger can be used to set
      *        message specific delegates. Please note that it is NOT possible
      *        to have both: a delegate for "catch-all" and the data-triggered ones.
+     * @param reactor IOReactor to be shared with other OD4Sessions; if nullptr, separate threads are used.
      */
-    OD4Session(uint16_t CID, std::function<void(cluon::data::Envelope &&envelope)> delegate = nullptr) noexcept;
+    OD4Session(uint16_t CID,
+               std::function<void(cluon::data::Envelope &&envelope)> delegate = nullptr,
+               std::shared_ptr<cluon::IOReactor> reactor                      = nullptr) noexcept;
+    ~OD4Session() noexcept;
+
+    /**
+     * Execution times of a data-triggered delegate.
+     */
+    class DataTriggerStatistics {
+       public:
+        uint64_t m_numberOfCalls{0};
+        std::chrono::nanoseconds m_totalExecutionTime{0};
+        std::chrono::nanoseconds m_maximumExecutionTime{0};
+    };
 
     /**
      * This method will send a given Envelope to this OpenDaVINCI v4 session.
@@ -109,6 +189,57 @@ class LIBCLUON_API OD4Session {
      */
     bool dataTrigger(int32_t messageIdentifier, std::function<void(cluon::data::Envelope &&envelope)> delegate) noexcept;
 
+    /**
+     * This method sets a delegate to be called data-triggered on arrival
+     * of a new message of type T. The message is decoded directly from the
+     * received bytes; thus, no Envelope is created for this delegate.
+     * Messages with malformed bytes are not passed to the delegate.
+     *
+     * @param delegate Function to call on newly arriving messages; setting it to nullptr will erase it.
+     * @return true if the given delegate could be successfully set or unset.
+     */
+    template <typename T>
+    bool dataTrigger(std::function<void(T &&message, const cluon::EnvelopeMeta &meta)> delegate) noexcept {
+        bool retVal{false};
+        try {
+            std::shared_ptr<DataTrigger> dataTrigger;
+            if (nullptr != delegate) {
+                dataTrigger                           = std::make_shared<DataTrigger>();
+                dataTrigger->m_serializedDataDelegate = [delegate](const char *serializedData, std::size_t size, const cluon::EnvelopeMeta &meta) {
+                    T message;
+                    bool decoded{false};
+                    {
+                        // Scratch memory needed to decode the message is reused for the next call.
+                        cluon::ArenaScope scope{cluon::Arena::ofThisThread()};
+                        cluon::FromProtoVisitor protoDecoder;
+                        decoded = protoDecoder.decodeFrom(serializedData, size, message);
+                    }
+                    if (decoded) {
+                        delegate(std::move(message), meta);
+                    }
+                };
+            }
+            retVal = setDataTrigger(static_cast<int32_t>(T::ID()), dataTrigger);
+        } catch (...) {} // LCOV_EXCL_LINE
+        return retVal;
+    }
+
+    /**
+     * This method selects the threads to call the data-triggered delegates.
+     * Envelopes that were received before but not delivered yet when the
+     * mode is changed might be dropped.
+     *
+     * @param mode Dispatch mode.
+     * @param numberOfWorkers Number of worker threads to call the delegates (at least 1); ignored for PIPELINE_THREAD.
+     * @return true if the dispatch mode could be set.
+     */
+    bool setDispatchMode(OD4SessionDispatchMode mode, uint8_t numberOfWorkers = 2) noexcept;
+
+    /**
+     * @return Execution times of all data-triggered delegates per message identifier.
+     */
+    std::map<int32_t, DataTriggerStatistics> dataTriggerStatistics() noexcept;
+
     /**
      * This method sets a delegate to be called time-triggered using the
      * specified frequency until the delegate returns false. This method
@@ -132,39 +263,241 @@ class LIBCLUON_API OD4Session {
     void send(T &message, const cluon::data::TimeStamp &sampleTimeStamp = cluon::data::TimeStamp(), uint32_t senderStamp = 0) noexcept {
         try {
             std::lock_guard<std::mutex> lck(m_senderMutex);
-            cluon::ToProtoVisitor protoEncoder;
+            // The message, the Envelope, and the bytes to send are reusing
+            // their memory from previous calls.
+            m_sendMessageBuffer.clear();
+            cluon::ToProtoVisitor protoEncoder{m_sendMessageBuffer};
+            message.accept(protoEncoder);
 
-            cluon::data::Envelope envelope;
-            {
-                envelope.dataType(static_cast<int32_t>(message.ID()));
-                message.accept(protoEncoder);
-                envelope.serializedData(protoEncoder.encodedData());
-                envelope.sent(cluon::time::now());
-                envelope.sampleTimeStamp((0 == (sampleTimeStamp.seconds() + sampleTimeStamp.microseconds())) ? envelope.sent() : sampleTimeStamp);
-                envelope.senderStamp(senderStamp);
-            }
+            m_sendEnvelope.dataType(static_cast<int32_t>(message.ID()));
+            m_sendEnvelope.sent(cluon::time::now());
+            m_sendEnvelope.sampleTimeStamp((0 == (sampleTimeStamp.seconds() + sampleTimeStamp.microseconds())) ? m_sendEnvelope.sent() : sampleTimeStamp);
+            m_sendEnvelope.senderStamp(senderStamp);
 
-            send(std::move(envelope));
+            // The encoded message is sent as serializedData of the Envelope without copying it.
+            const cluon::EnvelopeParts PARTS{cluon::serializeEnvelopeParts(m_sendBuffer, m_sendEnvelope, m_sendMessageBuffer.data(), m_sendMessageBuffer.size())};
+            m_sender.send(PARTS.data(), PARTS.size());
         } catch (...) {} // LCOV_EXCL_LINE
     }
 
+    /**
+    This class collects messages to be sent to an OpenDaVINCI v4 session and
+    sends them at once when it is flushed or destroyed; on Linux, up to
+    UDPSender::MAX_NUMBER_OF_PACKETS_PER_SYSCALL Envelopes are sent with one
+    system call. A Batch must not be used from several threads at the same time.
+
+    \code{.cpp}
+    {
+        cluon::OD4Session::Batch batch{od4};
+        for (auto &detection : detections) { batch.send(detection); }
+    } // All detections are sent here.
+    \endcode
+    */
+    class LIBCLUON_API Batch {
+       private:
+        Batch(const Batch &) = delete;
+        Batch(Batch &&)      = delete;
+        Batch &operator=(const Batch &) = delete;
+        Batch &operator=(Batch &&) = delete;
+
+       public:
+        /**
+         * Constructor.
+         *
+         * @param session OD4Session to send the collected messages to; it must outlive this Batch.
+         */
+        explicit Batch(OD4Session &session) noexcept;
+
+        /**
+         * Destructor sending all collected messages.
+         */
+        ~Batch() noexcept;
+
+        /**
+         * This method adds a given Envelope to this batch.
+         *
+         * @param envelope to be sent.
+         * @return true if the Envelope was added; false if it does not fit into one UDP datagram.
+         */
+        bool send(cluon::data::Envelope &&envelope) noexcept;
+
+        /**
+         * This method adds a given message to this batch.
+         *
+         * @param message Message to be sent.
+         * @param sampleTimeStamp Time point when this sample to be sent was captured (default = sent time point).
+         * @param senderStamp Optional sender stamp (default = 0).
+         * @return true if the message was added; false if it does not fit into one UDP datagram.
+         */
+        template <typename T>
+        bool send(T &message, const cluon::data::TimeStamp &sampleTimeStamp = cluon::data::TimeStamp(), uint32_t senderStamp = 0) noexcept {
+            bool retVal{false};
+            try {
+                m_messageBuffer.clear();
+                cluon::ToProtoVisitor protoEncoder{m_messageBuffer};
+                message.accept(protoEncoder);
+
+                m_envelope.dataType(static_cast<int32_t>(message.ID()));
+                m_envelope.sent(cluon::time::now());
+                m_envelope.sampleTimeStamp((0 == (sampleTimeStamp.seconds() + sampleTimeStamp.microseconds())) ? m_envelope.sent() : sampleTimeStamp);
+                m_envelope.senderStamp(senderStamp);
+
+                retVal = append(cluon::serializeEnvelopeParts(m_partsBuffer, m_envelope, m_messageBuffer.data(), m_messageBuffer.size()));
+            } catch (...) {} // LCOV_EXCL_LINE
+            return retVal;
+        }
+
+        /**
+         * This method sends all collected messages.
+         *
+         * @return Pair: Number of Envelopes sent and errno.
+         */
+        std::pair<ssize_t, int32_t> flush() noexcept;
+
+        /**
+         * @return Number of collected messages.
+         */
+        std::size_t size() const noexcept;
+
+       private:
+        /**
+         * This method adds a serialized Envelope to this batch unless it is
+         * too large for one UDP datagram, which would fail the entire batch.
+         *
+         * @param parts Serialized Envelope.
+         * @return true if the Envelope was added.
+         */
+        bool append(const cluon::EnvelopeParts &parts) noexcept;
+
+       private:
+        OD4Session &m_session;
+        std::string m_messageBuffer{};
+        cluon::data::Envelope m_envelope{};
+        std::string m_partsBuffer{};
+        // All Envelopes are serialized one after another into m_frames.
+        std::string m_frames{};
+        std::vector<std::pair<std::size_t, std::size_t>> m_frameOffsetsAndSizes{};
+        std::vector<std::pair<const char *, std::size_t>> m_packets{};
+    };
+
    public:
     bool isRunning() noexcept;
 
+    /**
+     * This method limits the number of received Envelopes waiting for or being
+     * processed by the delegates to protect against delegates that are slower than the network.
+     * It has no effect when a shared IOReactor is used.
+     *
+     * @param capacity Maximum number of waiting or processed Envelopes; 0 means unbounded (default).
+     * @param policy Behavior when an Envelope is received while the capacity is reached.
+     */
+    void setPipelineCapacity(std::size_t capacity, NotifyingPipelineOverflowPolicy policy) noexcept;
+
+    /**
+     * @return Number of received Envelopes waiting for or being processed by the delegates.
+     */
+    std::size_t pipelineSize() const noexcept;
+
+    /**
+     * @return Number of received Envelopes that were dropped due to the pipeline's capacity.
+     */
+    uint64_t numberOfDroppedEnvelopes() const noexcept;
+
    private:
-    void callback(std::string &&data, std::string &&from, std::chrono::system_clock::time_point &&timepoint) noexcept;
-    void sendInternal(std::string &&dataToSend) noexcept;
+    void callback(cluon::PooledBuffer &&data, const struct sockaddr_storage &from, std::chrono::system_clock::time_point &&timepoint) noexcept;
 
    private:
     std::unique_ptr<cluon::UDPReceiver> m_receiver;
     cluon::UDPSender m_sender;
 
     std::mutex m_senderMutex{};
+    std::string m_sendMessageBuffer{};
+    cluon::data::Envelope m_sendEnvelope{};
+    std::string m_sendBuffer{};
 
     std::function<void(cluon::data::Envelope &&envelope)> m_delegate{nullptr};
 
-    std::mutex m_mapOfDataTriggeredDelegatesMutex{};
-    std::unordered_map<int32_t, std::function<void(cluon::data::Envelope &&envelope)>, UseUInt32ValueAsHashKey> m_mapOfDataTriggeredDelegates{};
+    /**
+     * This class holds a data-triggered delegate and its execution times.
+     */
+    class DataTrigger {
+       public:
+        std::function<void(cluon::data::Envelope &&envelope)> m_delegate{nullptr};
+        std::function<void(const char *serializedData, std::size_t size, const cluon::EnvelopeMeta &meta)> m_serializedDataDelegate{nullptr};
+        std::atomic<uint64_t> m_numberOfCalls{0};
+        std::atomic<int64_t> m_totalExecutionTime{0};
+        std::atomic<int64_t> m_maximumExecutionTime{0};
+
+        /**
+         * This method calls the delegate and records its execution time.
+         *
+         * @param envelope Envelope to pass to the delegate.
+         */
+        void call(cluon::data::Envelope &&envelope) noexcept;
+
+        /**
+         * This method calls the delegate for the serializedData and records its execution time.
+         *
+         * @param serializedData Pointer to the first byte of the contained message.
+         * @param size Number of bytes of the contained message.
+         * @param meta All other fields of the Envelope.
+         */
+        void call(const char *serializedData, std::size_t size, const cluon::EnvelopeMeta &meta) noexcept;
+
+       private:
+        template <typename F>
+        void measure(F &&f) noexcept;
+    };
+
+    /**
+     * This method sets or erases (nullptr) a data-triggered delegate.
+     *
+     * @param messageIdentifier Message identifier to assign a delegate.
+     * @param dataTrigger Delegate to set or nullptr to erase it.
+     * @return true if the given delegate could be successfully set or unset.
+     */
+    bool setDataTrigger(int32_t messageIdentifier, std::shared_ptr<DataTrigger> dataTrigger) noexcept;
+
+    using DataTriggers = std::unordered_map<int32_t, std::shared_ptr<DataTrigger>, UseUInt32ValueAsHashKey>;
+
+    /**
+     * This class holds the worker threads and a fixed set of dispatch queues
+     * per message identifier with a data-triggered delegate. The dispatch
+     * queues are only created by the writers; the thread receiving the
+     * Envelopes just selects one of them by the sender stamp. Thus, Envelopes
+     * from the network cannot grow the number of dispatch queues.
+     */
+    class Dispatch {
+       public:
+        /**
+         * This method creates the dispatch queues for a message identifier if not existing yet.
+         *
+         * @param messageIdentifier Message identifier.
+         */
+        void addDispatchQueues(int32_t messageIdentifier) noexcept;
+
+       public:
+        OD4SessionDispatchMode m_mode{OD4SessionDispatchMode::PIPELINE_THREAD};
+        uint8_t m_numberOfQueuesPerMessageIdentifier{1};
+        std::shared_ptr<cluon::IOReactor> m_dispatcher{};
+        std::unordered_map<int32_t, std::vector<uint32_t>, UseUInt32ValueAsHashKey> m_dispatchQueues{};
+    };
+
+    /**
+     * This method waits until the thread receiving the Envelopes does not use
+     * a previously published DataTriggers or Dispatch anymore.
+     */
+    void waitForReaders() noexcept;
+
+    // The data-triggered delegates and the dispatch settings are published as
+    // snapshots by swapping an atomic pointer (RCU-style): The receiving thread
+    // never locks but only announces itself in m_numberOfReaders while looking
+    // up a delegate. Writers are serialized, modify a copy, swap the pointers,
+    // and delete the previous snapshot after all readers have left it.
+    std::mutex m_writersMutex{};
+    std::atomic<uint32_t> m_numberOfReaders{0};
+    std::atomic<DataTriggers *> m_dataTriggers{nullptr};
+    std::atomic<Dispatch *> m_dispatch{nullptr};
 };
 
 } // namespace cluon
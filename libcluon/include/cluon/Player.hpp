@@ -9,41 +9,37 @@
 #ifndef CLUON_PLAYER_HPP
 #define CLUON_PLAYER_HPP
 
+#include "cluon/MemoryMappedFile.hpp"
+#include "cluon/RecIndex.hpp"
 #include "cluon/cluon.hpp"
 #include "cluon/cluonDataStructures.hpp"
 
+#include <chrono>
+#include <condition_variable>
 #include <cstdint>
 #include <deque>
 #include <fstream>
 #include <functional>
-#include <map>
 #include <memory>
 #include <mutex>
 #include <string>
 #include <thread>
 #include <utility>
+#include <vector>
 
 namespace cluon {
 
-class LIBCLUON_API IndexEntry {
-   public:
-    IndexEntry() = default;
-    IndexEntry(const int64_t &sampleTimeStamp, const uint64_t &filePosition) noexcept;
-
-   public:
-    int64_t m_sampleTimeStamp{0};
-    uint64_t m_filePosition{0};
-    bool m_available{0};
-};
-
 class LIBCLUON_API Player {
    private:
     enum {
         ONE_MILLISECOND_IN_MICROSECONDS = 1000,
         ONE_SECOND_IN_MICROSECONDS      = 1000 * ONE_MILLISECOND_IN_MICROSECONDS,
         MAX_DELAY_IN_MICROSECONDS       = 1 * ONE_SECOND_IN_MICROSECONDS,
-        LOOK_AHEAD_IN_S                 = 30,
-        MIN_ENTRIES_FOR_LOOK_AHEAD      = 5000,
+        READ_AHEAD_IN_S                 = 10,
+        MIN_READ_AHEAD_IN_BYTES         = 1024 * 1024,
+        MAX_READ_AHEAD_IN_BYTES         = 64 * 1024 * 1024,
+        MIN_ENTRIES_IN_CACHE            = 1024,
+        PREFETCH_IN_BYTES               = 8 * 1024 * 1024,
     };
 
    private:
@@ -59,10 +55,31 @@ class LIBCLUON_API Player {
      * @param file File to play.
      * @param autoRewind True if the file should be rewind at EOF.
      * @param threading If set to true, player will load new envelopes from the files in background.
+     * @param memoryMapped If set to true, the file is mapped into memory to read the envelopes directly
+     *        from the mapped pages; if the file cannot be mapped, it is read with an fstream.
      */
-    Player(const std::string &file, const bool &autoRewind, const bool &threading) noexcept;
+    Player(const std::string &file, const bool &autoRewind, const bool &threading, const bool &memoryMapped = true) noexcept;
     ~Player();
 
+    /**
+     * Statistics about the cluon::data::Envelopes read ahead from the .rec file.
+     */
+    class CacheStatistics {
+       public:
+        // Envelopes that were available in the cache when they were requested.
+        uint64_t m_numberOfHits{0};
+        // Envelopes that needed to be waited for.
+        uint64_t m_numberOfMisses{0};
+        // Total time spent waiting for Envelopes.
+        std::chrono::microseconds m_stallTime{0};
+        uint64_t m_bytesInCache{0};
+        // Number of bytes to be held in the cache; it adapts to the consumption.
+        uint64_t m_readAheadInBytes{0};
+        double m_consumedBytesPerSecond{0};
+        // Entries of the index that could not be read from the .rec file and were skipped.
+        uint64_t m_numberOfSkippedEntries{0};
+    };
+
     /**
      * @return Pair of bool and next cluon::data::Envelope to be replayed;
      *         if bool is false, no next Envelope is available.
@@ -91,6 +108,11 @@ class LIBCLUON_API Player {
      */
     uint32_t totalNumberOfEnvelopesInRecFile() const noexcept;
 
+    /**
+     * @return Statistics about the cache.
+     */
+    CacheStatistics cacheStatistics() const noexcept;
+
    private:
     // Internal methods without Lock.
     bool hasMoreDataFromRecFile() const noexcept;
@@ -103,8 +125,16 @@ class LIBCLUON_API Player {
     void initializeIndex() noexcept;
 
     /**
-     * This method computes the initially required amount of
-     * cluon::data::Envelope in the cache and fill the cache accordingly.
+     * This method sets the global index.
+     *
+     * @param entries Entries sorted by sample time stamp.
+     * @param numberOfEntries Number of entries.
+     */
+    void setIndex(const cluon::RecIndexEntry *entries, const std::size_t &numberOfEntries) noexcept;
+
+    /**
+     * This method computes the initially required amount of bytes of
+     * cluon::data::Envelopes in the cache and fill the cache accordingly.
      */
     void computeInitialCacheLevelAndFillCache() noexcept;
 
@@ -123,15 +153,23 @@ class LIBCLUON_API Player {
      * to maxNumberOfEntriesToReadFromFile from the rec file.
      *
      * @param maxNumberOfEntriesToReadFromFile Maximum number of entries to be read from file.
+     * @param maxBytesInCache No further entries are read when the cache holds this amount of bytes.
      * @return Number of entries read from file.
      */
-    uint32_t fillEnvelopeCache(const uint32_t &maxNumberOfEntriesToReadFromFile) noexcept;
+    uint32_t fillEnvelopeCache(const uint32_t &maxNumberOfEntriesToReadFromFile, const uint64_t &maxBytesInCache) noexcept;
 
     /**
      * This method checks the availability of the next cluon::data::Envelope
-     * to be replayed from the cache.
+     * to be replayed from the cache and waits for it if needed.
+     *
+     * @return true if the next cluon::data::Envelope is available.
      */
-    inline void checkAvailabilityOfNextEnvelopeToBeReplayed() noexcept;
+    inline bool checkAvailabilityOfNextEnvelopeToBeReplayed() noexcept;
+
+    /**
+     * @return Number of cluon::data::Envelopes in the cache; m_indexMutex must be locked.
+     */
+    inline uint32_t numberOfEntriesInCache() const noexcept;
 
    private: // Data for the Player.
     bool m_threading;
@@ -141,25 +179,31 @@ class LIBCLUON_API Player {
     // Handle to .rec file.
     std::fstream m_recFile;
     bool m_recFileValid;
+    uint64_t m_recFileSize;
+
+    // Mapped .rec file; if set, m_recFile is not used.
+    bool m_memoryMapped;
+    std::unique_ptr<cluon::MemoryMappedFile> m_mappedRecFile;
+    // Position from where the pages of the mapped .rec file were last prefetched.
+    uint64_t m_prefetchBegin;
 
    private: // Player states.
     bool m_autoRewind;
 
    private: // Index and cache management.
-    // Global index: Mapping SampleTimeStamp --> cache entry (holding the actual content from .rec file).
+    // Global index sorted by SampleTimeStamp: The sample time stamps and the positions
+    // of the corresponding envelopes in the .rec file are stored in separate arrays.
     mutable std::mutex m_indexMutex;
-    std::multimap<int64_t, IndexEntry> m_index;
-
-    // Pointers to the current envelope to be replayed and the
-    // envelope that has be replayed from the global index.
-    std::multimap<int64_t, IndexEntry>::iterator m_previousPreviousEnvelopeAlreadyReplayed;
-    std::multimap<int64_t, IndexEntry>::iterator m_previousEnvelopeAlreadyReplayed;
-    std::multimap<int64_t, IndexEntry>::iterator m_currentEnvelopeToReplay;
+    std::vector<int64_t> m_indexSampleTimeStamps;
+    std::vector<uint64_t> m_indexFilePositions;
 
-    // Information about the index.
-    std::multimap<int64_t, IndexEntry>::iterator m_nextEntryToReadFromRecFile;
+    // Positions in the global index of the envelope that has been replayed
+    // and of the current envelope to be replayed.
+    std::size_t m_previousEnvelopeAlreadyReplayed;
+    std::size_t m_currentEnvelopeToReplay;
 
-    uint32_t m_desiredInitialLevel;
+    // Position in the global index of the next envelope to be read from the .rec file.
+    std::size_t m_nextEntryToReadFromRecFile;
 
     // Fields to compute replay throughput for cache management.
     cluon::data::TimeStamp m_firstTimePointReturningAEnvelope;
@@ -182,21 +226,30 @@ class LIBCLUON_API Player {
     void manageCache() noexcept;
 
     /**
-     * This method checks whether the cache needs to be refilled.
+     * This method checks whether the cache needs to be refilled; m_indexMutex must be locked.
      *
-     * @param numberOfEntries Number of entries in cache.
-     * @param refillMultiplicator Multiplicator to modify the amount of envelopes to be refilled.
-     * @return Modified refillMultiplicator recommedned to be used next time
+     * @return true if less than half of the read-ahead bytes are in the cache.
      */
-    float checkRefillingCache(const uint32_t &numberOfEntries, float refillMultiplicator) noexcept;
+    inline bool isRefillingCacheNeeded() const noexcept;
 
    private:
     mutable std::mutex m_envelopeCacheFillingThreadIsRunningMutex;
     bool m_envelopeCacheFillingThreadIsRunning;
     std::thread m_envelopeCacheFillingThread;
 
-    // Mapping of pos_type (within .rec file) --> cluon::data::Envelope (read from .rec file).
-    std::map<uint64_t, cluon::data::Envelope> m_envelopeCache;
+    // Ring buffer with the cluon::data::Envelopes read from the .rec file for the positions
+    // [m_currentEnvelopeToReplay, m_nextEntryToReadFromRecFile) in the global index;
+    // position i is stored at i % m_envelopeCache.size(). The ring buffer grows when
+    // all its entries are used but less than the read-ahead bytes are in the cache.
+    std::vector<cluon::data::Envelope> m_envelopeCache;
+    // Number of bytes accounted for the entries in m_envelopeCache.
+    std::vector<uint32_t> m_envelopeCacheBytes;
+
+    // Handoff between the thread filling the cache and the replay; protected by m_indexMutex.
+    std::condition_variable m_envelopeCacheFilled;
+    std::condition_variable m_envelopeCacheConsumed;
+    uint64_t m_bytesReplayedInTotal;
+    CacheStatistics m_cacheStatistics;
 
    public:
     void setPlayerListener(std::function<void(cluon::data::PlayerStatus playerStatus)> playerListener) noexcept;
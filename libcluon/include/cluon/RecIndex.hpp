@@ -0,0 +1,156 @@
+/*
+ * Copyright (C) 2017-2018  Christian Berger
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef CLUON_RECINDEX_HPP
+#define CLUON_RECINDEX_HPP
+
+#include "cluon/MemoryMappedFile.hpp"
+#include "cluon/cluon.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <istream>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace cluon {
+
+/**
+ * This class describes one Envelope in a .rec file.
+ */
+class LIBCLUON_API RecIndexEntry {
+   public:
+    int64_t m_sampleTimeStamp{0}; // Sample time stamp in microseconds.
+    uint64_t m_filePosition{0};   // Position of the Envelope's OD4 header in the .rec file.
+    int32_t m_dataType{0};
+    uint32_t m_senderStamp{0};
+};
+
+/**
+This class reads and writes a binary sidecar index for a .rec file (e.g.,
+"file.rec.idx") holding one RecIndexEntry per Envelope sorted by sample time
+stamp. The index is only loaded if the .rec file's size, modification time
+(with nanoseconds where available), and a checksum over its first and last
+bytes match the values stored when the index was written; otherwise, the .rec
+file needs to be scanned again. As these values cannot detect every change of
+the .rec file, readers still need to check that an entry's file position holds
+a well-formed Envelope with the entry's sample time stamp.
+
+The entries are memory-mapped when loading and thus, loading an index does
+not depend on the size of the .rec file. An index is written by the Player
+after scanning a .rec file for the first time or by a recorder:
+
+\code{.cpp}
+cluon::RecIndex recIndex;
+if (!recIndex.load("file.rec")) {
+    cluon::RecIndex::create("file.rec");
+}
+for (std::size_t i{0}; i < recIndex.size(); i++) {
+    std::cout << recIndex.entries()[i].m_sampleTimeStamp << std::endl;
+}
+\endcode
+
+An index is written in the byte order of the writing machine; on a machine
+with a different byte order, it is not loaded.
+*/
+class LIBCLUON_API RecIndex {
+   private:
+    RecIndex(const RecIndex &) = delete;
+    RecIndex(RecIndex &&)      = delete;
+    RecIndex &operator=(const RecIndex &) = delete;
+    RecIndex &operator=(RecIndex &&) = delete;
+
+   public:
+    RecIndex() = default;
+    ~RecIndex() = default;
+
+    /**
+     * This method loads the sidecar index for the given .rec file.
+     *
+     * @param recFile .rec file to load the index for.
+     * @return true if the index exists and matches the .rec file.
+     */
+    bool load(const std::string &recFile) noexcept;
+
+    /**
+     * @return Pointer to the first loaded entry.
+     */
+    const RecIndexEntry *entries() const noexcept;
+
+    /**
+     * @return Number of loaded entries.
+     */
+    std::size_t size() const noexcept;
+
+    /**
+     * This method writes the sidecar index for the given .rec file.
+     *
+     * @param recFile .rec file to write the index for.
+     * @param recFileSize Size of the .rec file when it was scanned; the index is not written if the size has changed since.
+     * @param entries Entries in the order of the .rec file; they are sorted by sample time stamp.
+     * @return true if the index was written.
+     */
+    static bool write(const std::string &recFile, uint64_t recFileSize, std::vector<RecIndexEntry> &entries) noexcept;
+
+    /**
+     * This method scans the Envelopes in the given bytes of a .rec file, e.g.,
+     * from a MemoryMappedFile. The bytes are split into chunks that are
+     * scanned concurrently; each chunk resynchronizes on the first well-formed
+     * Envelope behind its start and a chunk is scanned again if it did not
+     * start where the preceding chunk ended. Thus, the entries are the same as
+     * when scanning the bytes sequentially.
+     *
+     * @param data Pointer to the first byte of the .rec file.
+     * @param size Number of bytes.
+     * @param numberOfThreads Maximum number of chunks scanned concurrently.
+     * @param entries Entries sorted by sample time stamp (and by file position for equal sample time stamps).
+     * @param numberOfSkippedBytes Number of bytes that did not belong to a well-formed Envelope.
+     * @return true if the bytes were scanned.
+     */
+    static bool scan(const char *data,
+                     std::size_t size,
+                     uint32_t numberOfThreads,
+                     std::vector<RecIndexEntry> &entries,
+                     uint64_t &numberOfSkippedBytes) noexcept;
+
+    /**
+     * This method scans the Envelopes of a .rec file sequentially from the
+     * given istream, e.g., when the .rec file cannot be memory-mapped.
+     *
+     * @param in istream to read the .rec file from.
+     * @param entries Entries sorted by sample time stamp (and by file position for equal sample time stamps).
+     * @param numberOfSkippedBytes Number of bytes that did not belong to an Envelope.
+     * @param progress Function called with the position behind every scanned Envelope (optional).
+     * @return true if the istream was scanned.
+     */
+    static bool scan(std::istream &in,
+                     std::vector<RecIndexEntry> &entries,
+                     uint64_t &numberOfSkippedBytes,
+                     std::function<void(uint64_t position)> progress = nullptr) noexcept;
+
+    /**
+     * This method scans the given .rec file and writes its sidecar index.
+     *
+     * @param recFile .rec file to create the index for.
+     * @return true if the index was written.
+     */
+    static bool create(const std::string &recFile) noexcept;
+
+    /**
+     * @return Name of the sidecar index for the given .rec file.
+     */
+    static std::string filename(const std::string &recFile) noexcept;
+
+   private:
+    std::unique_ptr<MemoryMappedFile> m_file{};
+};
+} // namespace cluon
+
+#endif
@@ -9,6 +9,7 @@
 #ifndef CLUON_TCPCONNECTION_HPP
 #define CLUON_TCPCONNECTION_HPP
 
+#include "cluon/IOReactor.hpp"
 #include "cluon/NotifyingPipeline.hpp"
 #include "cluon/cluon.hpp"
 
@@ -29,6 +30,7 @@
 #include <mutex>
 #include <string>
 #include <thread>
+#include <vector>
 
 namespace cluon {
 /**
@@ -77,9 +79,16 @@ std::pair<ssize_t, int32_t> retVal = connection.send(std::move("Hello World!"));
 \endcode
 
 After creating an instance of class `cluon::TCPConnection`, it is immediately
-activated and concurrently waiting for data in a separate thread. To check
+activated and concurrently waiting for data in a separate thread driven by an
+IOReactor; data is only read from the socket once a newDataDelegate is set. To
+check
 whether the instance was created successfully and running, the method
 `isRunning()` should be called.
+
+Like UDPReceiver, several TCPConnections can share one IOReactor instead of
+using separate threads each by supplying it to the constructor. Likewise, the
+pipeline can use a bounded lock-free ring buffer; when it is full, reading from
+the socket waits until the delegate has caught up.
 */
 class LIBCLUON_API TCPConnection {
    private:
@@ -89,8 +98,9 @@ class LIBCLUON_API TCPConnection {
      * Constructor that is only accessible to TCPServer to manage incoming TCP connections.
      *
      * @param socket Socket to handle an existing TCP connection described by this socket.
+     * @param reactor IOReactor to be shared with other instances; if nullptr, a separate IOReactor and pipeline thread are used.
      */
-    TCPConnection(const int32_t &socket) noexcept;
+    TCPConnection(const int32_t &socket, std::shared_ptr<cluon::IOReactor> reactor = nullptr) noexcept;
 
    private:
     TCPConnection(const TCPConnection &) = delete;
@@ -106,11 +116,15 @@ class LIBCLUON_API TCPConnection {
      * @param port Port to receive UDP packets from.
      * @param newDataDelegate Functional (noexcept) to handle received bytes; parameters are received data, timestamp.
      * @param connectionLostDelegate Functional (noexcept) to handle a lost connection.
+     * @param reactor IOReactor to be shared with other instances; if nullptr, a separate IOReactor and pipeline thread are used.
+     * @param pipelineType Storage for received bytes in the pipeline thread when no shared IOReactor is used.
      */
     TCPConnection(const std::string &address,
                   uint16_t port,
                   std::function<void(std::string &&, std::chrono::system_clock::time_point &&)> newDataDelegate = nullptr,
-                  std::function<void()> connectionLostDelegate                                                  = nullptr) noexcept;
+                  std::function<void()> connectionLostDelegate                                                  = nullptr,
+                  std::shared_ptr<cluon::IOReactor> reactor                                                     = nullptr,
+                  NotifyingPipelineType pipelineType                                                            = NotifyingPipelineType::DEQUE) noexcept;
 
     ~TCPConnection() noexcept;
 
@@ -139,7 +153,16 @@ class LIBCLUON_API TCPConnection {
      * @param errorCode Error code that caused this closing.
      */
     void closeSocket(int errorCode) noexcept;
-    void startReadingFromSocket() noexcept;
+    void startReadingFromSocket(std::shared_ptr<cluon::IOReactor> reactor, NotifyingPipelineType pipelineType) noexcept;
+
+    /**
+     * This method registers the socket at the IOReactor once a newDataDelegate is available.
+     */
+    void registerSocket() noexcept;
+
+    /**
+     * This method is called from the IOReactor when the socket is readable.
+     */
     void readFromSocket() noexcept;
 
    private:
@@ -147,8 +170,12 @@ class LIBCLUON_API TCPConnection {
     int32_t m_socket{-1};
     struct sockaddr_in m_address {};
 
-    std::atomic<bool> m_readFromSocketThreadRunning{false};
-    std::thread m_readFromSocketThread{};
+    std::atomic<bool> m_readFromSocketRunning{false};
+    std::atomic<bool> m_isSocketRegistered{false};
+    std::shared_ptr<cluon::IOReactor> m_reactor{};
+    // Dispatch queue when using a shared IOReactor (0 otherwise).
+    uint32_t m_dispatchQueue{0};
+    std::vector<char> m_buffer{};
 
     std::mutex m_newDataDelegateMutex{};
     std::function<void(std::string &&, std::chrono::system_clock::time_point)> m_newDataDelegate{};
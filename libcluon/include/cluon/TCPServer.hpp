@@ -9,6 +9,7 @@
 #ifndef CLUON_TCPSERVER_HPP
 #define CLUON_TCPSERVER_HPP
 
+#include "cluon/IOReactor.hpp"
 #include "cluon/TCPConnection.hpp"
 #include "cluon/cluon.hpp"
 
@@ -24,6 +25,7 @@
 #include <cstdint>
 #include <atomic>
 #include <functional>
+#include <memory>
 #include <mutex>
 #include <string>
 #include <thread>
@@ -43,8 +45,11 @@ class LIBCLUON_API TCPServer {
      *
      * @param port Port to receive UDP packets from.
      * @param newConnectionDelegate Functional to handle incoming TCP connections.
+     * @param reactor IOReactor to be shared with other instances and the accepted TCPConnections; if nullptr, separate IOReactors are used.
      */
-    TCPServer(uint16_t port, std::function<void(std::string &&from, std::shared_ptr<cluon::TCPConnection> connection)> newConnectionDelegate) noexcept;
+    TCPServer(uint16_t port,
+              std::function<void(std::string &&from, std::shared_ptr<cluon::TCPConnection> connection)> newConnectionDelegate,
+              std::shared_ptr<cluon::IOReactor> reactor = nullptr) noexcept;
 
     ~TCPServer() noexcept;
 
@@ -60,14 +65,20 @@ class LIBCLUON_API TCPServer {
      * @param errorCode Error code that caused this closing.
      */
     void closeSocket(int errorCode) noexcept;
+
+    /**
+     * This method is called from the IOReactor to accept a new connection.
+     */
     void readFromSocket() noexcept;
 
    private:
     mutable std::mutex m_socketMutex{};
     int32_t m_socket{-1};
 
-    std::atomic<bool> m_readFromSocketThreadRunning{false};
-    std::thread m_readFromSocketThread{};
+    std::atomic<bool> m_readFromSocketRunning{false};
+    std::shared_ptr<cluon::IOReactor> m_reactor{};
+    // IOReactor to be used for accepted TCPConnections (nullptr for separate ones).
+    std::shared_ptr<cluon::IOReactor> m_sharedReactor{};
 
     std::mutex m_newConnectionDelegateMutex{};
     std::function<void(std::string &&from, std::shared_ptr<cluon::TCPConnection> connection)> m_newConnectionDelegate{};
@@ -10,15 +10,29 @@
 #define CLUON_TOPROTOVISITOR_HPP
 
 #include "cluon/ProtoConstants.hpp"
+#include "cluon/VarInt.hpp"
 #include "cluon/cluon.hpp"
 
+#include <cstddef>
 #include <cstdint>
-#include <sstream>
 #include <string>
 
 namespace cluon {
 /**
-This class encodes a given message in Proto format.
+This class encodes a given message in Proto format. By default, the encoded
+bytes are collected internally; alternatively, they are appended to a
+caller-supplied buffer that can be reused for many messages to not allocate
+memory once the buffer is large enough:
+
+\code{.cpp}
+std::string buffer;
+cluon::ToProtoVisitor protoEncoder{buffer};
+for (auto &msg : messages) {
+    protoEncoder.reset();
+    msg.accept(protoEncoder);
+    // Use buffer.
+}
+\endcode
 */
 class LIBCLUON_API ToProtoVisitor {
    private:
@@ -31,11 +45,29 @@ class LIBCLUON_API ToProtoVisitor {
     ToProtoVisitor()  = default;
     ~ToProtoVisitor() = default;
 
+    /**
+     * Constructor to append the encoded data to the given buffer.
+     *
+     * @param buffer Buffer to append to; it must outlive this ToProtoVisitor.
+     */
+    explicit ToProtoVisitor(std::string &buffer) noexcept;
+
     /**
      * @return Encoded data in Proto format.
      */
     std::string encodedData() const noexcept;
 
+    /**
+     * @return Number of bytes of the encoded data.
+     */
+    std::size_t encodedSize() const noexcept;
+
+    /**
+     * This method removes the encoded data to reuse this visitor; the
+     * buffer's memory is kept.
+     */
+    void reset() noexcept;
+
    public:
     // The following methods are provided to allow an instance of this class to
     // be used as visitor for an instance with the method signature void accept<T>(T&);
@@ -62,40 +94,101 @@ class LIBCLUON_API ToProtoVisitor {
         (void)typeName;
         (void)name;
 
-        toVarInt(m_buffer, std::move(encodeKey(id, static_cast<uint8_t>(ProtoConstants::LENGTH_DELIMITED))));
-        cluon::ToProtoVisitor nestedProtoEncoder;
-        value.accept(nestedProtoEncoder);
-        encode(m_buffer, std::move(nestedProtoEncoder.encodedData()));
+        toVarInt(*m_buffer, encodeKey(id, static_cast<uint8_t>(ProtoConstants::LENGTH_DELIMITED)));
+        // Determine the length of the nested message first to encode the
+        // nested message in place after its length without moving it.
+        EncodedSizeVisitor sizeVisitor;
+        value.accept(sizeVisitor);
+        toVarInt(*m_buffer, sizeVisitor.encodedSize());
+        value.accept(*this);
     }
 
    private:
-    std::size_t encode(std::ostream &o, bool &v) noexcept;
-    std::size_t encode(std::ostream &o, int8_t &v) noexcept;
-    std::size_t encode(std::ostream &o, uint8_t &v) noexcept;
-    std::size_t encode(std::ostream &o, int16_t &v) noexcept;
-    std::size_t encode(std::ostream &o, uint16_t &v) noexcept;
-    std::size_t encode(std::ostream &o, int32_t &v) noexcept;
-    std::size_t encode(std::ostream &o, uint32_t &v) noexcept;
-    std::size_t encode(std::ostream &o, int64_t &v) noexcept;
-    std::size_t encode(std::ostream &o, uint64_t &v) noexcept;
-    std::size_t encode(std::ostream &o, float &v) noexcept;
-    std::size_t encode(std::ostream &o, double &v) noexcept;
-    std::size_t encode(std::ostream &o, const std::string &v) noexcept;
+    /**
+     * This class computes the number of bytes of a message encoded in Proto
+     * format without encoding it; it only visits the fields and uses the
+     * lengths of strings and nested messages.
+     */
+    class EncodedSizeVisitor {
+       public:
+        std::size_t encodedSize() const noexcept { return m_size; }
+
+       public:
+        void preVisit(int32_t, const std::string &, const std::string &) noexcept {}
+        void postVisit() noexcept {}
+
+        void visit(uint32_t id, std::string &&, std::string &&, bool &v) noexcept { addVarInt(id, v ? 1 : 0); }
+        void visit(uint32_t id, std::string &&, std::string &&, char &v) noexcept { addVarInt(id, static_cast<uint8_t>(v)); }
+        void visit(uint32_t id, std::string &&, std::string &&, int8_t &v) noexcept { addVarInt(id, toZigZag8(v)); }
+        void visit(uint32_t id, std::string &&, std::string &&, uint8_t &v) noexcept { addVarInt(id, v); }
+        void visit(uint32_t id, std::string &&, std::string &&, int16_t &v) noexcept { addVarInt(id, toZigZag16(v)); }
+        void visit(uint32_t id, std::string &&, std::string &&, uint16_t &v) noexcept { addVarInt(id, v); }
+        void visit(uint32_t id, std::string &&, std::string &&, int32_t &v) noexcept { addVarInt(id, toZigZag32(v)); }
+        void visit(uint32_t id, std::string &&, std::string &&, uint32_t &v) noexcept { addVarInt(id, v); }
+        void visit(uint32_t id, std::string &&, std::string &&, int64_t &v) noexcept { addVarInt(id, toZigZag64(v)); }
+        void visit(uint32_t id, std::string &&, std::string &&, uint64_t &v) noexcept { addVarInt(id, v); }
+        void visit(uint32_t id, std::string &&, std::string &&, float &) noexcept { m_size += varIntSize(encodeKey(id, 0)) + sizeof(uint32_t); }
+        void visit(uint32_t id, std::string &&, std::string &&, double &) noexcept { m_size += varIntSize(encodeKey(id, 0)) + sizeof(uint64_t); }
+        void visit(uint32_t id, std::string &&, std::string &&, std::string &v) noexcept { addLengthDelimited(id, v.size()); }
+
+        template <typename T>
+        void visit(uint32_t &id, std::string &&, std::string &&, T &value) noexcept {
+            EncodedSizeVisitor nested;
+            value.accept(nested);
+            addLengthDelimited(id, nested.encodedSize());
+        }
+
+       private:
+        void addVarInt(uint32_t id, uint64_t v) noexcept { m_size += varIntSize(encodeKey(id, 0)) + varIntSize(v); }
+        void addLengthDelimited(uint32_t id, std::size_t length) noexcept { m_size += varIntSize(encodeKey(id, 0)) + varIntSize(length) + length; }
+
+       private:
+        std::size_t m_size{0};
+    };
 
    private:
-    uint8_t toZigZag8(int8_t v) noexcept;
-    uint16_t toZigZag16(int16_t v) noexcept;
-    uint32_t toZigZag32(int32_t v) noexcept;
-    uint64_t toZigZag64(int64_t v) noexcept;
+    std::size_t encode(std::string &o, bool &v) noexcept;
+    std::size_t encode(std::string &o, int8_t &v) noexcept;
+    std::size_t encode(std::string &o, uint8_t &v) noexcept;
+    std::size_t encode(std::string &o, int16_t &v) noexcept;
+    std::size_t encode(std::string &o, uint16_t &v) noexcept;
+    std::size_t encode(std::string &o, int32_t &v) noexcept;
+    std::size_t encode(std::string &o, uint32_t &v) noexcept;
+    std::size_t encode(std::string &o, int64_t &v) noexcept;
+    std::size_t encode(std::string &o, uint64_t &v) noexcept;
+    std::size_t encode(std::string &o, float &v) noexcept;
+    std::size_t encode(std::string &o, double &v) noexcept;
+    std::size_t encode(std::string &o, const std::string &v) noexcept;
+
+   private:
+    static uint8_t toZigZag8(int8_t v) noexcept;
+    static uint16_t toZigZag16(int16_t v) noexcept;
+    static uint32_t toZigZag32(int32_t v) noexcept;
+    static uint64_t toZigZag64(int64_t v) noexcept;
+
+    /**
+     * @param v Value to encode.
+     * @return Number of bytes of the given value encoded in VarInt.
+     */
+    static std::size_t varIntSize(uint64_t v) noexcept;
+
+    /**
+     * This method encodes a given value in VarInt.
+     *
+     * @param out Buffer to append to.
+     * @param v Value to encode.
+     * @return Bytes written.
+     */
+    std::size_t toVarInt(std::string &out, uint64_t v) noexcept;
 
     /**
      * This method encodes a given value in VarInt.
      *
-     * @param out std::ostream to encode to.
+     * @param out Memory to write to with at least MAX_VARINT_SIZE bytes.
      * @param v Value to encode.
      * @return Bytes written.
      */
-    std::size_t toVarInt(std::ostream &out, uint64_t v) noexcept;
+    static std::size_t toVarInt(char *out, uint64_t v) noexcept;
 
     /**
      * This method creates a key/value pair encoded in Proto format.
@@ -108,8 +201,8 @@ class LIBCLUON_API ToProtoVisitor {
     std::size_t toKeyValue(uint32_t fieldIdentifier, T &v) noexcept {
         std::size_t size{0};
         uint64_t key = encodeKey(fieldIdentifier, static_cast<uint8_t>(ProtoConstants::VARINT));
-        size += toVarInt(m_buffer, key);
-        size += encode(m_buffer, v);
+        size += toVarInt(*m_buffer, key);
+        size += encode(*m_buffer, v);
         return size;
     }
 
@@ -120,10 +213,12 @@ class LIBCLUON_API ToProtoVisitor {
      * @param protoType Protobuf type identifier.
      * @return Protobuf fieldIdentifier/key pair.
      */
-    uint64_t encodeKey(uint32_t fieldIdentifier, uint8_t protoType) noexcept;
+    static uint64_t encodeKey(uint32_t fieldIdentifier, uint8_t protoType) noexcept;
 
    private:
-    std::stringstream m_buffer{""};
+    std::string m_ownBuffer{};
+    std::string *m_buffer{&m_ownBuffer};
+    std::size_t m_start{0};
 };
 } // namespace cluon
 
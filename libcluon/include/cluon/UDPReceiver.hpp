@@ -9,6 +9,8 @@
 #ifndef CLUON_UDPRECEIVER_HPP
 #define CLUON_UDPRECEIVER_HPP
 
+#include "cluon/BufferPool.hpp"
+#include "cluon/IOReactor.hpp"
 #include "cluon/NotifyingPipeline.hpp"
 #include "cluon/cluon.hpp"
 
@@ -21,6 +23,7 @@
 #endif
 // clang-format on
 
+#include <cstddef>
 #include <cstdint>
 #include <atomic>
 #include <condition_variable>
@@ -32,6 +35,7 @@
 #include <set>
 #include <string>
 #include <thread>
+#include <vector>
 
 namespace cluon {
 /**
@@ -64,10 +68,52 @@ cluon::UDPReceiver receiver("127.0.0.1", 1234,
 \endcode
 
 After creating an instance of class `cluon::UDPReceiver`, it is immediately
-activated and concurrently waiting for data in a separate thread. To check
+activated and concurrently waiting for data in a separate thread driven by an
+IOReactor, which wakes up only when data is available. On Linux, the thread
+drains up to 16 datagrams per system call using `recvmmsg` and takes their time
+stamps from the kernel (`SO_TIMESTAMPNS`). To check
 whether the instance was created successfully and running, the method
 `isRunning()` should be called.
 
+By default, every UDPReceiver uses its own IOReactor and a separate thread to
+call the delegate. When many UDPReceivers are used in one process, they can
+share one IOReactor with a configurable number of threads instead; the delegate
+of one UDPReceiver is still called in the order of the received datagrams:
+
+\code{.cpp}
+auto reactor = std::make_shared<cluon::IOReactor>(1, 2);
+cluon::UDPReceiver receiver1("225.0.0.111", 12175, delegate1, 0, reactor);
+cluon::UDPReceiver receiver2("225.0.0.112", 12175, delegate2, 0, reactor);
+\endcode
+
+Received datagrams are handed over to the delegate's thread via a
+NotifyingPipeline, which uses an unbounded deque by default. Passing
+`cluon::NotifyingPipelineType::SPSC_RING_BUFFER` selects a bounded lock-free
+ring buffer instead; datagrams that do not fit into a full ring buffer are
+dropped. In addition, the number of waiting datagrams can be limited with
+`setPipelineCapacity` and an overflow policy; the current queue depth and the
+number of dropped datagrams are available from `pipelineSize()` and
+`numberOfDroppedDatagrams()`.
+
+Datagrams are received directly into reference-counted buffers taken from a
+BufferPool that are reused once the delegate has released them. To avoid
+copying the bytes into an `std::string` and formatting the sender's address
+for every datagram, a delegate can receive the buffer and the sender's
+address directly:
+
+\code{.cpp}
+cluon::UDPReceiver receiver("127.0.0.1", 1234,
+    [](cluon::PooledBuffer &&data, const struct sockaddr_storage &sender, std::chrono::system_clock::time_point &&ts) noexcept {
+        std::cout << "Received " << data.size() << " bytes." << std::endl;
+    }, 0, nullptr, cluon::NotifyingPipelineType::SPSC_RING_BUFFER);
+\endcode
+
+Together with the SPSC_RING_BUFFER pipeline, a datagram of up to 2048 bytes
+reaches this delegate without any heap allocation and without copying the
+bytes after the kernel has written them into the buffer. Larger datagrams are
+assembled with one copy into a buffer of the maximum UDP payload size from a
+second pool.
+
 A complete example is available
 [here](https://github.com/chrberger/libcluon/blob/master/libcluon/examples/cluon-UDPReceiver.cpp).
 */
@@ -86,18 +132,79 @@ class LIBCLUON_API UDPReceiver {
      * @param receiveFromPort Port to receive UDP packets from.
      * @param delegate Functional (noexcept) to handle received bytes; parameters are received data, sender, timestamp.
      * @param localSendFromPort Port that an application is using to send data. This port (> 0) is ignored when data is received.
+     * @param reactor IOReactor to be shared with other instances; if nullptr, a separate IOReactor and pipeline thread are used.
+     * @param pipelineType Storage for received datagrams in the pipeline thread when no shared IOReactor is used.
      */
     UDPReceiver(const std::string &receiveFromAddress,
                 uint16_t receiveFromPort,
                 std::function<void(std::string &&, std::string &&, std::chrono::system_clock::time_point &&)> delegate,
-                uint16_t localSendFromPort = 0) noexcept;
+                uint16_t localSendFromPort                = 0,
+                std::shared_ptr<cluon::IOReactor> reactor = nullptr,
+                NotifyingPipelineType pipelineType        = NotifyingPipelineType::DEQUE) noexcept;
+
+    /**
+     * Constructor.
+     *
+     * @param receiveFromAddress Numerical IPv4 address to receive UDP packets from.
+     * @param receiveFromPort Port to receive UDP packets from.
+     * @param delegate Functional (noexcept) to handle received bytes; parameters are the buffer holding the received data, sender's address, timestamp.
+     * @param localSendFromPort Port that an application is using to send data. This port (> 0) is ignored when data is received.
+     * @param reactor IOReactor to be shared with other instances; if nullptr, a separate IOReactor and pipeline thread are used.
+     * @param pipelineType Storage for received datagrams in the pipeline thread when no shared IOReactor is used.
+     */
+    UDPReceiver(const std::string &receiveFromAddress,
+                uint16_t receiveFromPort,
+                std::function<void(cluon::PooledBuffer &&, const struct sockaddr_storage &, std::chrono::system_clock::time_point &&)> delegate,
+                uint16_t localSendFromPort                = 0,
+                std::shared_ptr<cluon::IOReactor> reactor = nullptr,
+                NotifyingPipelineType pipelineType        = NotifyingPipelineType::DEQUE) noexcept;
+
+    /**
+     * Constructor for a UDPReceiver without delegate.
+     */
+    UDPReceiver(const std::string &receiveFromAddress,
+                uint16_t receiveFromPort,
+                std::nullptr_t delegate,
+                uint16_t localSendFromPort                = 0,
+                std::shared_ptr<cluon::IOReactor> reactor = nullptr,
+                NotifyingPipelineType pipelineType        = NotifyingPipelineType::DEQUE) noexcept;
     ~UDPReceiver() noexcept;
 
+   private:
+    UDPReceiver(const std::string &receiveFromAddress,
+                uint16_t receiveFromPort,
+                std::function<void(std::string &&, std::string &&, std::chrono::system_clock::time_point &&)> &&stringDelegate,
+                std::function<void(cluon::PooledBuffer &&, const struct sockaddr_storage &, std::chrono::system_clock::time_point &&)> &&pooledBufferDelegate,
+                uint16_t localSendFromPort,
+                std::shared_ptr<cluon::IOReactor> reactor,
+                NotifyingPipelineType pipelineType) noexcept;
+
+   public:
     /**
      * @return true if the UDPReceiver could successfully be created and is able to receive data.
      */
     bool isRunning() const noexcept;
 
+    /**
+     * This method limits the number of received datagrams waiting for or being
+     * processed by the delegate to protect against a delegate that is slower than the network.
+     * It has no effect when a shared IOReactor is used.
+     *
+     * @param capacity Maximum number of waiting or processed datagrams; 0 means unbounded (default).
+     * @param policy Behavior when a datagram is received while the capacity is reached.
+     */
+    void setPipelineCapacity(std::size_t capacity, NotifyingPipelineOverflowPolicy policy) noexcept;
+
+    /**
+     * @return Number of received datagrams waiting for or being processed by the delegate.
+     */
+    std::size_t pipelineSize() const noexcept;
+
+    /**
+     * @return Number of received datagrams that were dropped due to the pipeline's capacity.
+     */
+    uint64_t numberOfDroppedDatagrams() const noexcept;
+
    private:
     /**
      * This method closes the socket.
@@ -106,8 +213,32 @@ class LIBCLUON_API UDPReceiver {
      */
     void closeSocket(int errorCode) noexcept;
 
+    /**
+     * @return true if a delegate is set.
+     */
+    bool hasDelegate() const noexcept;
+
+    /**
+     * This method is called from the IOReactor to read all pending datagrams from the socket.
+     */
     void readFromSocket() noexcept;
 
+    /**
+     * This method checks whether a received datagram was sent by ourselves
+     * and queues it otherwise for the delegate.
+     *
+     * @param buffer Buffer holding the received bytes; it is moved into the pipeline when queued for a delegate for pooled buffers.
+     * @param overflow Pointer to the received bytes that did not fit into the buffer.
+     * @param length Number of received bytes.
+     * @param remote Address of the sender.
+     * @param timestamp Time point when the datagram was received.
+     */
+    void processDatagram(cluon::PooledBuffer &buffer,
+                         const char *overflow,
+                         std::size_t length,
+                         const struct sockaddr_storage &remote,
+                         std::chrono::system_clock::time_point &&timestamp) noexcept;
+
    private:
     int32_t m_socket{-1};
     bool m_isBlockingSocket{true};
@@ -117,21 +248,47 @@ class LIBCLUON_API UDPReceiver {
     struct ip_mreq m_mreq {};
     bool m_isMulticast{false};
 
-    std::atomic<bool> m_readFromSocketThreadRunning{false};
-    std::thread m_readFromSocketThread{};
+    std::atomic<bool> m_readFromSocketRunning{false};
+    std::shared_ptr<cluon::IOReactor> m_reactor{};
+    // Dispatch queue when using a shared IOReactor (0 otherwise).
+    uint32_t m_dispatchQueue{0};
+
+    // Buffers to receive datagrams; allocated on first use from the IOReactor's thread.
+    std::shared_ptr<cluon::BufferPool> m_bufferPool{};
+    std::vector<cluon::PooledBuffer> m_receiveBuffers{};
+    // Bytes of datagrams exceeding the pooled buffers' size.
+    std::vector<char> m_overflowBuffer{};
+    std::shared_ptr<cluon::BufferPool> m_largeBufferPool{};
+    bool m_useBatchedReceive{true};
 
    private:
-    std::function<void(std::string &&, std::string &&, std::chrono::system_clock::time_point)> m_delegate{};
+    std::function<void(std::string &&, std::string &&, std::chrono::system_clock::time_point &&)> m_delegate{};
+    std::function<void(cluon::PooledBuffer &&, const struct sockaddr_storage &, std::chrono::system_clock::time_point &&)> m_pooledBufferDelegate{};
 
    private:
+    /**
+     * A received datagram is either kept in its pooled buffer or, for a
+     * delegate expecting an std::string, copied right away to return the
+     * buffer to the pool.
+     */
     class PipelineEntry {
        public:
-        std::string m_data;
-        std::string m_from;
-        std::chrono::system_clock::time_point m_sampleTime;
+        cluon::PooledBuffer m_buffer{};
+        std::string m_data{};
+        struct sockaddr_storage m_from {};
+        std::chrono::system_clock::time_point m_sampleTime{};
     };
 
+    /**
+     * This method calls the delegate for a received datagram.
+     *
+     * @param entry Received datagram.
+     */
+    void callDelegate(PipelineEntry &entry) noexcept;
+
     std::shared_ptr<cluon::NotifyingPipeline<PipelineEntry>> m_pipeline{};
+    // Entries of one read pass to be dispatched via a shared IOReactor.
+    std::vector<PipelineEntry> m_dispatchEntries{};
 };
 } // namespace cluon
 
@@ -20,10 +20,12 @@
 #endif
 // clang-format on
 
+#include <cstddef>
 #include <cstdint>
 #include <mutex>
 #include <string>
 #include <utility>
+#include <vector>
 
 namespace cluon {
 /**
@@ -50,6 +52,15 @@ std::pair<ssize_t, int32_t> retVal = sender.send(std::move("Hello World!"));
 std::cout << "Send " << retVal.first << " bytes, error code = " << retVal.second << std::endl;
 \endcode
 
+Many small packets can be sent as a batch, which needs only one system call
+for up to MAX_NUMBER_OF_PACKETS_PER_SYSCALL packets on Linux (`sendmmsg`);
+here, the first element of the returned pair is the number of sent packets:
+
+\code{.cpp}
+const std::string a{"Hello"}, b{"World!"};
+std::pair<ssize_t, int32_t> retVal = sender.send({{a.data(), a.size()}, {b.data(), b.size()}});
+\endcode
+
 A complete example is available
 [here](https://github.com/chrberger/libcluon/blob/master/libcluon/examples/cluon-UDPSender.cpp).
 */
@@ -78,6 +89,38 @@ class LIBCLUON_API UDPSender {
      */
     std::pair<ssize_t, int32_t> send(std::string &&data) const noexcept;
 
+    /**
+     * Send the given bytes without taking ownership of them.
+     *
+     * @param data Pointer to the first byte to send.
+     * @param size Number of bytes to send.
+     * @return Pair: Number of bytes sent and errno.
+     */
+    std::pair<ssize_t, int32_t> send(const char *data, std::size_t size) const noexcept;
+
+    /**
+     * Send the given parts as one UDP packet without joining them first
+     * (scatter/gather I/O).
+     *
+     * @param parts Pointer to the first part given as pointer to its first byte and number of bytes.
+     * @param numberOfParts Number of parts; at most MAX_NUMBER_OF_PARTS.
+     * @return Pair: Number of bytes sent and errno.
+     */
+    std::pair<ssize_t, int32_t> send(const std::pair<const char *, std::size_t> *parts, std::size_t numberOfParts) const noexcept;
+
+    /**
+     * Send the given packets as separate UDP packets with as few system calls
+     * as possible; empty packets are skipped.
+     *
+     * @param packets Packets given as pointer to their first byte and number of bytes.
+     * @return Pair: Number of packets sent and errno; no packet is sent if one is too large.
+     */
+    std::pair<ssize_t, int32_t> send(const std::vector<std::pair<const char *, std::size_t>> &packets) const noexcept;
+
+   public:
+    static constexpr std::size_t MAX_NUMBER_OF_PARTS{16};
+    static constexpr std::size_t MAX_NUMBER_OF_PACKETS_PER_SYSCALL{64};
+
    public:
     /**
      * @return Port that this UDP sender will use for sending or 0 if no information available.
@@ -0,0 +1,113 @@
+/*
+ * Copyright (C) 2017-2018  Christian Berger
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef CLUON_VARINT_HPP
+#define CLUON_VARINT_HPP
+
+#include "cluon/cluon.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#ifdef _MSC_VER
+    #include <intrin.h>
+#endif
+
+namespace cluon {
+/**
+These functions encode and decode the VarInts of the Proto format. Decoding a
+single VarInt processes up to eight bytes at once instead of looping over every
+byte; encoding keeps the byte-wise loop as it is faster for the short VarInts
+of the keys and values in typical messages.
+*/
+
+// Maximum number of bytes of a VarInt encoding a 64-bit value.
+constexpr std::size_t MAX_VARINT_SIZE{10};
+
+/**
+ * @param v Value that must not be 0.
+ * @return Number of trailing 0-bits.
+ */
+inline uint32_t countTrailingZeroBits(uint64_t v) noexcept {
+#ifdef _MSC_VER
+    unsigned long index{0};
+    _BitScanForward64(&index, v);
+    return static_cast<uint32_t>(index);
+#else
+    return static_cast<uint32_t>(__builtin_ctzll(v));
+#endif
+}
+
+/**
+ * This function encodes a given value as VarInt.
+ *
+ * @param out Memory to write to with at least MAX_VARINT_SIZE bytes.
+ * @param value Value to encode.
+ * @return Number of bytes of the VarInt.
+ */
+inline std::size_t encodeVarInt(char *out, uint64_t value) noexcept {
+    // Minimum size is of the encoded data.
+    std::size_t size{1};
+    while (0x7f < value) {
+        // Use the MSB to indicate value overflow for more bytes to come.
+        *out++ = static_cast<char>((static_cast<uint8_t>(value & 0x7f)) | 0x80);
+        value >>= 7;
+        size++;
+    }
+    // Write final byte.
+    *out = static_cast<char>((static_cast<uint8_t>(value)) & 0x7f);
+    return size;
+}
+
+/**
+ * This function decodes a VarInt from memory.
+ *
+ * @param pos Pointer to the first byte of the VarInt; moved behind the VarInt.
+ * @param end Pointer behind the last readable byte.
+ * @param value Decoded value.
+ * @return true if a complete VarInt of at most MAX_VARINT_SIZE bytes was decoded before end.
+ */
+inline bool decodeVarInt(const char *&pos, const char *end, uint64_t &value) noexcept {
+    // Keys and small values are the most frequent case.
+    if ((pos < end) && (0 == (*pos & 0x80))) {
+        value = static_cast<uint8_t>(*pos++);
+        return true;
+    }
+    if (8 <= (end - pos)) {
+        uint64_t word{0};
+        std::memcpy(&word, pos, sizeof(word));
+        word = le64toh(word);
+        const uint64_t STOPS{~word & 0x8080808080808080ull};
+        if (0 != STOPS) {
+            // Keep the bytes up to the first one without MSB and join their 7-bit groups.
+            word &= 0x7f7f7f7f7f7f7f7full & (STOPS ^ (STOPS - 1));
+            word = (word & 0x007f007f007f007full) | ((word & 0x7f007f007f007f00ull) >> 1);
+            word = (word & 0x00003fff00003fffull) | ((word & 0x3fff00003fff0000ull) >> 2);
+            word = (word & 0x000000000fffffffull) | ((word & 0x0fffffff00000000ull) >> 4);
+            value = word;
+            pos += (countTrailingZeroBits(STOPS) + 1) / 8;
+            return true;
+        }
+    }
+
+    // Close to the end of the data or more than eight bytes.
+    value = 0;
+    for (uint32_t size{0}; (pos < end) && (size < MAX_VARINT_SIZE); size++) {
+        const uint64_t C{static_cast<uint8_t>(*pos++)};
+        value |= (C & 0x7f) << (7 * size);
+        if (0 == (C & 0x80)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+} // namespace cluon
+
+#endif
@@ -0,0 +1,108 @@
+/*
+ * Copyright (C) 2017-2018  Christian Berger
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "cluon/Arena.hpp"
+
+#include <algorithm>
+
+namespace cluon {
+
+Arena::Arena(std::size_t blockSize) noexcept
+    : m_blockSize{std::max<std::size_t>(blockSize, 1)} {}
+
+void *Arena::allocate(std::size_t size, std::size_t alignment) noexcept {
+    // Try the current block first and continue with the already allocated blocks.
+    while (m_currentBlock < m_blocks.size()) {
+        Block &block{m_blocks[m_currentBlock]};
+        const uintptr_t BEGIN{reinterpret_cast<uintptr_t>(block.m_data.get())};
+        const uintptr_t ALIGNED{(BEGIN + m_offset + alignment - 1) & ~(static_cast<uintptr_t>(alignment) - 1)};
+        const std::size_t OFFSET{static_cast<std::size_t>(ALIGNED - BEGIN)};
+        if (OFFSET + size <= block.m_size) {
+            m_offset = OFFSET + size;
+            return block.m_data.get() + OFFSET;
+        }
+        if (m_currentBlock + 1 == m_blocks.size()) {
+            break;
+        }
+        m_currentBlock++;
+        m_offset = 0;
+    }
+
+    // Add a new block behind the current one that is large enough.
+    try {
+        Block block;
+        block.m_size = std::max(m_blockSize, size + alignment);
+        block.m_data.reset(new char[block.m_size]);
+        const std::size_t POSITION{m_blocks.empty() ? 0 : m_currentBlock + 1};
+        m_blocks.insert(m_blocks.begin() + static_cast<std::ptrdiff_t>(POSITION), std::move(block));
+        m_currentBlock = POSITION;
+        m_offset       = 0;
+    } catch (...) { return nullptr; } // LCOV_EXCL_LINE
+    return allocate(size, alignment);
+}
+
+Arena::Mark Arena::mark() const noexcept {
+    Mark mark;
+    mark.m_block  = m_currentBlock;
+    mark.m_offset = m_offset;
+    return mark;
+}
+
+void Arena::rewind(const Mark &mark) noexcept {
+    m_currentBlock = mark.m_block;
+    m_offset       = mark.m_offset;
+}
+
+void Arena::reset() noexcept {
+    rewind(Mark());
+}
+
+std::size_t Arena::numberOfBytesInUse() const noexcept {
+    std::size_t numberOfBytesInUse{m_offset};
+    for (std::size_t i{0}; (i < m_currentBlock) && (i < m_blocks.size()); i++) { numberOfBytesInUse += m_blocks[i].m_size; }
+    return numberOfBytesInUse;
+}
+
+std::size_t Arena::capacity() const noexcept {
+    std::size_t capacity{0};
+    for (const auto &block : m_blocks) { capacity += block.m_size; }
+    return capacity;
+}
+
+std::size_t Arena::numberOfBlocks() const noexcept {
+    return m_blocks.size();
+}
+
+Arena &Arena::ofThisThread() noexcept {
+    static thread_local Arena arena;
+    return arena;
+}
+
+Arena *&Arena::currentOfThisThread() noexcept {
+    static thread_local Arena *current{nullptr};
+    return current;
+}
+
+Arena *Arena::current() noexcept {
+    return currentOfThisThread();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+ArenaScope::ArenaScope(Arena &arena) noexcept
+    : m_arena{arena}
+    , m_mark{arena.mark()}
+    , m_previous{Arena::currentOfThisThread()} {
+    Arena::currentOfThisThread() = &m_arena;
+}
+
+ArenaScope::~ArenaScope() noexcept {
+    m_arena.rewind(m_mark);
+    Arena::currentOfThisThread() = m_previous;
+}
+} // namespace cluon
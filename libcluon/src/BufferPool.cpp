@@ -0,0 +1,183 @@
+/*
+ * Copyright (C) 2017-2018  Christian Berger
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "cluon/BufferPool.hpp"
+
+#include <algorithm>
+#include <utility>
+
+namespace cluon {
+
+PooledBuffer::PooledBuffer(std::shared_ptr<BufferPool> pool, Slot *slot) noexcept
+    : m_pool(std::move(pool))
+    , m_slot(slot) {
+    if (nullptr != m_slot) {
+        m_slot->m_references.store(1);
+        m_slot->m_size = 0;
+    }
+}
+
+PooledBuffer::~PooledBuffer() noexcept {
+    release();
+}
+
+PooledBuffer::PooledBuffer(const PooledBuffer &other) noexcept
+    : m_pool(other.m_pool)
+    , m_slot(other.m_slot) {
+    if (nullptr != m_slot) {
+        m_slot->m_references++;
+    }
+}
+
+PooledBuffer::PooledBuffer(PooledBuffer &&other) noexcept
+    : m_pool(std::move(other.m_pool))
+    , m_slot(other.m_slot) {
+    other.m_slot = nullptr;
+}
+
+PooledBuffer &PooledBuffer::operator=(const PooledBuffer &other) noexcept {
+    if (this != &other) {
+        release();
+        m_pool = other.m_pool;
+        m_slot = other.m_slot;
+        if (nullptr != m_slot) {
+            m_slot->m_references++;
+        }
+    }
+    return *this;
+}
+
+PooledBuffer &PooledBuffer::operator=(PooledBuffer &&other) noexcept {
+    if (this != &other) {
+        release();
+        m_pool       = std::move(other.m_pool);
+        m_slot       = other.m_slot;
+        other.m_slot = nullptr;
+    }
+    return *this;
+}
+
+void PooledBuffer::release() noexcept {
+    if ((nullptr != m_slot) && (1 == m_slot->m_references.fetch_sub(1))) {
+        // We were the last user of this buffer; thus, return it to its pool.
+        if (m_pool) {
+            m_pool->release(m_slot);
+        }
+    }
+    m_slot = nullptr;
+    m_pool.reset();
+}
+
+char *PooledBuffer::data() noexcept {
+    return (nullptr != m_slot) ? m_slot->m_data.get() : nullptr;
+}
+
+const char *PooledBuffer::data() const noexcept {
+    return (nullptr != m_slot) ? m_slot->m_data.get() : nullptr;
+}
+
+std::size_t PooledBuffer::size() const noexcept {
+    return (nullptr != m_slot) ? m_slot->m_size : 0;
+}
+
+std::size_t PooledBuffer::capacity() const noexcept {
+    return m_pool ? m_pool->bufferSize() : 0;
+}
+
+void PooledBuffer::resize(std::size_t size) noexcept {
+    if (nullptr != m_slot) {
+        m_slot->m_size = std::min(size, capacity());
+    }
+}
+
+bool PooledBuffer::empty() const noexcept {
+    return (0 == size());
+}
+
+std::string PooledBuffer::toString() const noexcept {
+    std::string retVal;
+    try {
+        if (!empty()) {
+            retVal.assign(data(), size());
+        }
+    } catch (...) {} // LCOV_EXCL_LINE
+    return retVal;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+std::shared_ptr<BufferPool> BufferPool::create(std::size_t bufferSize, std::size_t numberOfBuffers) noexcept {
+    std::shared_ptr<BufferPool> pool;
+    try {
+        pool.reset(new BufferPool(bufferSize));
+
+        // Allocate the requested buffers upfront by acquiring and releasing them.
+        std::vector<PooledBuffer> buffers;
+        buffers.reserve(numberOfBuffers);
+        for (std::size_t i{0}; i < numberOfBuffers; i++) { buffers.emplace_back(pool->acquire()); }
+    } catch (...) { pool.reset(); } // LCOV_EXCL_LINE
+    return pool;
+}
+
+BufferPool::BufferPool(std::size_t bufferSize) noexcept
+    : m_bufferSize(bufferSize) {}
+
+PooledBuffer BufferPool::acquire() noexcept {
+    PooledBuffer::Slot *slot{nullptr};
+    try {
+        std::lock_guard<std::mutex> lck(m_slotsMutex);
+        if (m_availableSlots.empty()) {
+            // Take all buffers that were released in the meantime; the most
+            // recently released one is reused first as it is likely still cached.
+            for (PooledBuffer::Slot *released = m_releasedSlots.exchange(nullptr, std::memory_order_acquire); nullptr != released;) {
+                PooledBuffer::Slot *next = released->m_nextReleased;
+                m_availableSlots.push_back(released);
+                m_numberOfReleasedSlots--;
+                released = next;
+            }
+            std::reverse(m_availableSlots.begin(), m_availableSlots.end());
+        }
+        if (m_availableSlots.empty()) {
+            // All buffers are in use; thus, grow the pool.
+            std::unique_ptr<PooledBuffer::Slot> newSlot(new PooledBuffer::Slot());
+            newSlot->m_data.reset(new char[m_bufferSize]);
+            m_slots.emplace_back(std::move(newSlot));
+            // Reserve the space to take back all slots without allocating.
+            m_availableSlots.reserve(m_slots.capacity());
+            slot = m_slots.back().get();
+        } else {
+            slot = m_availableSlots.back();
+            m_availableSlots.pop_back();
+        }
+    } catch (...) { slot = nullptr; } // LCOV_EXCL_LINE
+
+    return (nullptr != slot) ? PooledBuffer(shared_from_this(), slot) : PooledBuffer();
+}
+
+void BufferPool::release(PooledBuffer::Slot *slot) noexcept {
+    // Slots are only taken from m_releasedSlots all at once; thus, pushing is not prone to ABA.
+    m_numberOfReleasedSlots++;
+    slot->m_nextReleased = m_releasedSlots.load(std::memory_order_relaxed);
+    while (!m_releasedSlots.compare_exchange_weak(slot->m_nextReleased, slot, std::memory_order_release, std::memory_order_relaxed)) {}
+}
+
+std::size_t BufferPool::bufferSize() const noexcept {
+    return m_bufferSize;
+}
+
+std::size_t BufferPool::numberOfBuffers() noexcept {
+    std::lock_guard<std::mutex> lck(m_slotsMutex);
+    return m_slots.size();
+}
+
+std::size_t BufferPool::numberOfAvailableBuffers() noexcept {
+    std::lock_guard<std::mutex> lck(m_slotsMutex);
+    return m_availableSlots.size() + m_numberOfReleasedSlots.load();
+}
+
+} // namespace cluon
@@ -7,7 +7,9 @@
  */
 
 #include "cluon/EnvelopeConverter.hpp"
+#include "cluon/Arena.hpp"
 #include "cluon/Envelope.hpp"
+#include "cluon/EnvelopeView.hpp"
 #include "cluon/FromJSONVisitor.hpp"
 #include "cluon/FromProtoVisitor.hpp"
 #include "cluon/GenericMessage.hpp"
@@ -42,32 +44,22 @@ int32_t EnvelopeConverter::setMessageSpecification(const std::string &ms) noexce
 std::string EnvelopeConverter::getJSONFromProtoEncodedEnvelope(const std::string &protoEncodedEnvelope) noexcept {
     std::string retVal{"{}"};
     if (!m_listOfMetaMessages.empty()) {
-        cluon::data::Envelope envelope;
-        std::stringstream sstr(protoEncodedEnvelope);
+        // Try viewing complete OD4-encoded Envelope including header.
         constexpr uint8_t OD4_HEADER_SIZE{5};
-        if (OD4_HEADER_SIZE < protoEncodedEnvelope.size()) {
-            // Try decoding complete OD4-encoded Envelope including header.
-            constexpr uint8_t byte0{0x0D};
-            constexpr uint8_t byte1{0xA4};
-            if ((static_cast<uint8_t>(protoEncodedEnvelope.at(0)) == byte0) && (static_cast<uint8_t>(protoEncodedEnvelope.at(1)) == byte1)) {
-                uint32_t length = (*reinterpret_cast<const uint32_t *>(protoEncodedEnvelope.data() + 1));
-                length          = le32toh(length) >> 8;
-                if ((OD4_HEADER_SIZE + length) == protoEncodedEnvelope.size()) {
-                    auto result{extractEnvelope(sstr)};
-                    if (result.first) {
-                        envelope = result.second;
-                    }
-                }
-            }
+        auto protoEncoded = unframeEnvelope(protoEncodedEnvelope.data(), protoEncodedEnvelope.size());
+        cluon::EnvelopeView view;
+        if ((nullptr != protoEncoded.first) && (0 < protoEncoded.second) && ((OD4_HEADER_SIZE + protoEncoded.second) == protoEncodedEnvelope.size())) {
+            view = cluon::EnvelopeView(protoEncoded.first, protoEncoded.second);
+        } else {
+            // Directly viewing complete OD4 container failed, try viewing without header.
+            view = cluon::EnvelopeView(protoEncodedEnvelope.data(), protoEncodedEnvelope.size());
         }
 
-        if (0 == envelope.dataType()) {
-            // Directly decoding complete OD4 container failed, try decoding without header.
-            cluon::FromProtoVisitor protoDecoder;
-            protoDecoder.decodeFrom(sstr, envelope);
+        // Decode only Envelopes with a known message specification.
+        if (0 < m_scopeOfMetaMessages.count(view.dataType())) {
+            cluon::data::Envelope envelope{view.toEnvelope()};
+            retVal = getJSONFromEnvelope(envelope);
         }
-
-        retVal = getJSONFromEnvelope(envelope);
     }
     return retVal;
 }
@@ -83,9 +75,11 @@ std::string EnvelopeConverter::getJSONFromEnvelope(cluon::data::Envelope &envelo
             ToJSONVisitor envelopeToJSON{OUTER_CURLY_BRACES, mask};
             envelope.accept(envelopeToJSON);
 
-            std::stringstream sstr{envelope.serializedData()};
+            // Scratch memory to decode the nested messages is reused for the next Envelope.
+            cluon::ArenaScope scope{cluon::Arena::ofThisThread()};
+            const std::string serializedData{envelope.serializedData()};
             cluon::FromProtoVisitor protoDecoder;
-            protoDecoder.decodeFrom(sstr);
+            protoDecoder.decodeFrom(serializedData.data(), serializedData.size());
 
             // Now, create JSON from payload.
             cluon::MetaMessage payload{m_scopeOfMetaMessages[envelope.dataType()]};
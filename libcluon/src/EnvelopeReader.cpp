@@ -0,0 +1,136 @@
+/*
+ * Copyright (C) 2017-2018  Christian Berger
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "cluon/EnvelopeReader.hpp"
+#include "cluon/Envelope.hpp"
+
+// clang-format off
+#ifdef WIN32
+    #include <io.h>
+#else
+    #include <unistd.h>
+#endif
+// clang-format on
+
+#include <cerrno>
+#include <cstring>
+#include <algorithm>
+
+namespace cluon {
+
+EnvelopeReader::EnvelopeReader(int32_t fd, std::size_t bufferSize) noexcept
+    : m_fd{fd} {
+    try {
+        m_buffer.resize(std::max<std::size_t>(bufferSize, 1));
+    } catch (...) { m_endOfData = true; } // LCOV_EXCL_LINE
+}
+
+EnvelopeReader::EnvelopeReader(std::istream &in, std::size_t bufferSize) noexcept
+    : m_in{&in} {
+    try {
+        m_buffer.resize(std::max<std::size_t>(bufferSize, 1));
+    } catch (...) { m_endOfData = true; } // LCOV_EXCL_LINE
+}
+
+EnvelopeReader::EnvelopeReader(const char *data, std::size_t size) noexcept
+    : m_memory{data}
+    , m_endOfData{true}
+    , m_end{(nullptr != data) ? size : 0} {}
+
+const char *EnvelopeReader::bytes() const noexcept {
+    return (nullptr != m_memory) ? m_memory : m_buffer.data();
+}
+
+uint64_t EnvelopeReader::numberOfSkippedBytes() const noexcept {
+    return m_numberOfSkippedBytes;
+}
+
+bool EnvelopeReader::fill(std::size_t minimum) noexcept {
+    if (minimum <= (m_end - m_begin)) {
+        return true;
+    }
+    if (nullptr != m_memory) {
+        return false;
+    }
+
+    // Move the remaining bytes to the front and grow the buffer for large Envelopes.
+    if (0 < m_begin) {
+        std::memmove(m_buffer.data(), m_buffer.data() + m_begin, m_end - m_begin);
+        m_end -= m_begin;
+        m_begin = 0;
+    }
+    if (m_buffer.size() < minimum) {
+        try {
+            m_buffer.resize(minimum);
+        } catch (...) { return false; } // LCOV_EXCL_LINE
+    }
+
+    while (!m_endOfData && (m_end < minimum)) {
+        const std::size_t FREE{m_buffer.size() - m_end};
+        if (nullptr != m_in) {
+            // Read more bytes than needed only when they are available without blocking.
+            const std::streamsize AVAILABLE{m_in->good() ? m_in->rdbuf()->in_avail() : 0};
+            const std::size_t TO_READ{std::max(minimum - m_end, std::min(FREE, static_cast<std::size_t>(std::max<std::streamsize>(AVAILABLE, 0))))};
+            m_in->read(m_buffer.data() + m_end, static_cast<std::streamsize>(TO_READ));
+            const std::size_t BYTES_READ{static_cast<std::size_t>(m_in->gcount())};
+            m_endOfData = (BYTES_READ < TO_READ);
+            m_end += BYTES_READ;
+        } else {
+#ifdef WIN32
+            const int BYTES_READ{::_read(m_fd, m_buffer.data() + m_end, static_cast<unsigned int>(FREE))};
+#else
+            const ssize_t BYTES_READ{::read(m_fd, m_buffer.data() + m_end, FREE)};
+#endif
+            if ((0 > BYTES_READ) && (EINTR == errno)) {
+                continue; // LCOV_EXCL_LINE
+            }
+            m_endOfData = (0 >= BYTES_READ);
+            m_end += (m_endOfData ? 0 : static_cast<std::size_t>(BYTES_READ));
+        }
+    }
+    return (minimum <= m_end);
+}
+
+bool EnvelopeReader::next(EnvelopeFrame &frame) noexcept {
+    constexpr std::size_t OD4_HEADER_SIZE{5};
+    while (fill(OD4_HEADER_SIZE)) {
+        const char *begin{bytes() + m_begin};
+        if ((0x0D == static_cast<uint8_t>(begin[0])) && (0xA4 == static_cast<uint8_t>(begin[1]))) {
+            const std::size_t LENGTH{static_cast<std::size_t>(static_cast<uint8_t>(begin[2])) | (static_cast<std::size_t>(static_cast<uint8_t>(begin[3])) << 8)
+                                     | (static_cast<std::size_t>(static_cast<uint8_t>(begin[4])) << 16)};
+            if (fill(OD4_HEADER_SIZE + LENGTH)) {
+                // The buffer might have been moved.
+                begin = bytes() + m_begin;
+                if (forEachProtoField(begin + OD4_HEADER_SIZE, LENGTH, [](uint32_t, ProtoConstants, uint64_t, const char *) {})) {
+                    frame.m_position = m_position;
+                    frame.m_data     = begin;
+                    frame.m_size     = OD4_HEADER_SIZE + LENGTH;
+                    m_begin += frame.m_size;
+                    m_position += frame.m_size;
+                    return true;
+                }
+            }
+        }
+
+        // No well-formed Envelope here: Skip to the next byte that might start an OD4 header.
+        const char *start{bytes() + m_begin};
+        const char *end{bytes() + m_end};
+        const void *candidate{std::memchr(start + 1, 0x0D, static_cast<std::size_t>(end - start - 1))};
+        const std::size_t SKIPPED{static_cast<std::size_t>(((nullptr != candidate) ? static_cast<const char *>(candidate) : end) - start)};
+        m_begin += SKIPPED;
+        m_position += SKIPPED;
+        m_numberOfSkippedBytes += SKIPPED;
+    }
+
+    // The remaining bytes are too few for an Envelope.
+    m_position += (m_end - m_begin);
+    m_numberOfSkippedBytes += (m_end - m_begin);
+    m_begin = m_end;
+    return false;
+}
+} // namespace cluon
@@ -0,0 +1,135 @@
+/*
+ * Copyright (C) 2017-2018  Christian Berger
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "cluon/EnvelopeView.hpp"
+
+#include <string>
+
+namespace cluon {
+
+// int32 fields are ZigZag-encoded.
+static int32_t zigZagToInt32(uint64_t value) noexcept {
+    const uint32_t V{static_cast<uint32_t>(value)};
+    return static_cast<int32_t>((V >> 1) ^ (~(V & 1) + 1));
+}
+
+// Like FromProtoVisitor, only the first occurrence of a field identifier is
+// used; a first occurrence with an unexpected Proto type hides later ones.
+static bool isFirstOccurrence(uint32_t &visited, uint32_t fieldId) noexcept {
+    const uint32_t BIT{(fieldId < 32) ? (static_cast<uint32_t>(1) << fieldId) : 0};
+    const bool retVal{0 == (visited & BIT)};
+    visited |= BIT;
+    return retVal;
+}
+
+EnvelopeView::EnvelopeView(const char *data, std::size_t size) noexcept
+    : m_data{data}
+    , m_size{size} {}
+
+void EnvelopeView::locateFields() const noexcept {
+    if (m_located) {
+        return;
+    }
+    m_located = true;
+    uint32_t visited{0};
+    m_valid = (nullptr != m_data) && forEachProtoField(m_data, m_size, [this, &visited](uint32_t fieldId, ProtoConstants type, uint64_t value, const char *bytes) {
+                  if (!isFirstOccurrence(visited, fieldId)) {
+                      return;
+                  }
+                  if (ProtoConstants::VARINT == type) {
+                      if (1 == fieldId) {
+                          m_dataType = zigZagToInt32(value);
+                      } else if (6 == fieldId) {
+                          m_senderStamp = static_cast<uint32_t>(value);
+                      }
+                  } else if (ProtoConstants::LENGTH_DELIMITED == type) {
+                      if (2 == fieldId) {
+                          m_serializedData = std::make_pair(bytes, static_cast<std::size_t>(value));
+                      } else if ((3 <= fieldId) && (fieldId <= 5)) {
+                          m_timeStampBytes[fieldId - 3] = std::make_pair(bytes, static_cast<std::size_t>(value));
+                      }
+                  }
+              });
+}
+
+const cluon::data::TimeStamp &EnvelopeView::timeStamp(uint8_t index) const noexcept {
+    locateFields();
+    if (!m_timeStampDecoded[index]) {
+        m_timeStampDecoded[index] = true;
+        cluon::data::TimeStamp &ts{m_timeStamps[index]};
+        if (nullptr != m_timeStampBytes[index].first) {
+            uint32_t visited{0};
+            forEachProtoField(m_timeStampBytes[index].first, m_timeStampBytes[index].second, [&ts, &visited](uint32_t fieldId, ProtoConstants type, uint64_t value, const char *) {
+                if (!isFirstOccurrence(visited, fieldId)) {
+                    return;
+                }
+                if ((ProtoConstants::VARINT == type) && (1 == fieldId)) {
+                    ts.seconds(zigZagToInt32(value));
+                } else if ((ProtoConstants::VARINT == type) && (2 == fieldId)) {
+                    ts.microseconds(zigZagToInt32(value));
+                }
+            });
+        }
+    }
+    return m_timeStamps[index];
+}
+
+bool EnvelopeView::valid() const noexcept {
+    locateFields();
+    return m_valid;
+}
+
+int32_t EnvelopeView::dataType() const noexcept {
+    locateFields();
+    return m_dataType;
+}
+
+uint32_t EnvelopeView::senderStamp() const noexcept {
+    locateFields();
+    return m_senderStamp;
+}
+
+std::pair<const char *, std::size_t> EnvelopeView::serializedData() const noexcept {
+    locateFields();
+    return m_serializedData;
+}
+
+const cluon::data::TimeStamp &EnvelopeView::sent() const noexcept {
+    return timeStamp(0);
+}
+
+const cluon::data::TimeStamp &EnvelopeView::received() const noexcept {
+    return timeStamp(1);
+}
+
+const cluon::data::TimeStamp &EnvelopeView::sampleTimeStamp() const noexcept {
+    return timeStamp(2);
+}
+
+EnvelopeMeta EnvelopeView::meta() const noexcept {
+    EnvelopeMeta meta;
+    meta.m_dataType        = dataType();
+    meta.m_sent            = sent();
+    meta.m_received        = received();
+    meta.m_sampleTimeStamp = sampleTimeStamp();
+    meta.m_senderStamp     = senderStamp();
+    return meta;
+}
+
+cluon::data::Envelope EnvelopeView::toEnvelope() const noexcept {
+    cluon::data::Envelope env;
+    if (valid()) {
+        const std::pair<const char *, std::size_t> SERIALIZED_DATA{serializedData()};
+        try {
+            env.serializedData((nullptr != SERIALIZED_DATA.first) ? std::string(SERIALIZED_DATA.first, SERIALIZED_DATA.second) : std::string());
+        } catch (...) {} // LCOV_EXCL_LINE
+        env.dataType(dataType()).sent(sent()).received(received()).sampleTimeStamp(sampleTimeStamp()).senderStamp(senderStamp());
+    }
+    return env;
+}
+} // namespace cluon
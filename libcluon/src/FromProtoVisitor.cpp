@@ -8,6 +8,7 @@
 
 #include "cluon/FromProtoVisitor.hpp"
 
+#include <algorithm>
 #include <cstddef>
 #include <cstring>
 #include <utility>
@@ -33,56 +34,138 @@ void FromProtoVisitor::readBytesFromStream(std::istream &in, std::size_t bytesTo
 }
 
 void FromProtoVisitor::decodeFrom(std::istream &in) noexcept {
-    // Reset internal states as this deserializer could be reused.
-    m_mapOfKeyValues.clear();
-    while (in.good()) {
-        // First stage: Read keyFieldType (encoded as VarInt).
-        if (0 < fromVarInt(in, m_keyFieldType)) {
-            // Succeeded to read keyFieldType entry; extract information.
-            m_protoType = static_cast<ProtoConstants>(m_keyFieldType & 0x7);
-            m_fieldId = static_cast<uint32_t>(m_keyFieldType >> 3);
-            switch (m_protoType) {
-                case ProtoConstants::VARINT:
-                {
-                    // Directly decode VarInt value.
-                    fromVarInt(in, m_value);
-                    m_mapOfKeyValues.emplace(m_fieldId, linb::any(m_value));
-                }
-                break;
-                case ProtoConstants::EIGHT_BYTES:
-                {
-                    readBytesFromStream(in, sizeof(double), m_doubleValue.buffer.data());
-                    m_doubleValue.uint64Value = le64toh(m_doubleValue.uint64Value);
-                    m_mapOfKeyValues.emplace(m_fieldId, linb::any(m_doubleValue.doubleValue));
-                }
-                break;
-                case ProtoConstants::FOUR_BYTES:
-                {
-                    readBytesFromStream(in, sizeof(float), m_floatValue.buffer.data());
-                    m_floatValue.uint32Value = le32toh(m_floatValue.uint32Value);
-                    m_mapOfKeyValues.emplace(m_fieldId, linb::any(m_floatValue.floatValue));
+    // Collect all bytes to decode them from memory.
+    m_source.clear();
+    try {
+        const constexpr std::size_t CHUNK_SIZE{1024};
+        char buffer[CHUNK_SIZE];
+        while (in.good()) {
+            in.read(buffer, CHUNK_SIZE);
+            m_source.append(buffer, static_cast<std::size_t>(in.gcount()));
+        }
+    } catch (...) {} // LCOV_EXCL_LINE
+    indexFields();
+}
+
+bool FromProtoVisitor::decodeFrom(const char *data, std::size_t size) noexcept {
+    try {
+        if (0 < size) {
+            m_source.assign(data, size);
+        } else {
+            m_source.clear();
+        }
+    } catch (...) { // LCOV_EXCL_LINE
+        m_source.clear(); // LCOV_EXCL_LINE
+    }
+    return indexFields() && (m_source.size() == size);
+}
+
+bool FromProtoVisitor::indexFields() noexcept {
+    // Reset internal states as this deserializer could be reused; the
+    // memory of m_fields and m_fieldIndex is kept.
+    m_fields.clear();
+    std::fill(m_fieldIndex.begin(), m_fieldIndex.end(), 0);
+
+    bool retVal{true};
+    const char *begin{m_source.data()};
+    const char *pos{begin};
+    const char *end{begin + m_source.size()};
+    try {
+        while (retVal && (pos < end)) {
+            retVal = readField(pos, end);
+            if (retVal) {
+                Field field;
+                field.m_fieldId   = m_fieldId;
+                field.m_protoType = m_protoType;
+                switch (m_protoType) {
+                    case ProtoConstants::EIGHT_BYTES: field.m_value = m_doubleValue.uint64Value; break;
+                    case ProtoConstants::FOUR_BYTES: field.m_value = m_floatValue.uint32Value; break;
+                    case ProtoConstants::LENGTH_DELIMITED: field.m_offset = static_cast<std::size_t>(m_bytes - begin); // FALLTHROUGH
+                    case ProtoConstants::VARINT: field.m_value = m_value; break;
                 }
-                break;
-                case ProtoConstants::LENGTH_DELIMITED:
-                {
-                    fromVarInt(in, m_value);
-                    const std::size_t BYTES_TO_READ_FROM_STREAM{static_cast<std::size_t>(m_value)};
-                    if (m_stringValue.capacity() < BYTES_TO_READ_FROM_STREAM) {
-                        m_stringValue.reserve(BYTES_TO_READ_FROM_STREAM);
+                m_fields.push_back(field);
+
+                // Only the first occurrence of a field identifier is visited.
+                if (m_fieldId < MAX_INDEXED_FIELD_ID) {
+                    if (m_fieldIndex.size() <= m_fieldId) {
+                        m_fieldIndex.resize(m_fieldId + 1, 0);
+                    }
+                    if (0 == m_fieldIndex[m_fieldId]) {
+                        m_fieldIndex[m_fieldId] = static_cast<uint32_t>(m_fields.size());
                     }
-                    readBytesFromStream(in, BYTES_TO_READ_FROM_STREAM, m_stringValue.data());
-                    m_mapOfKeyValues.emplace(m_fieldId, linb::any(std::string(m_stringValue.data(), static_cast<std::size_t>(m_value))));
                 }
+            }
+        }
+    } catch (...) { retVal = false; } // LCOV_EXCL_LINE
+    return retVal;
+}
+
+const FromProtoVisitor::Field *FromProtoVisitor::findField(uint32_t fieldId, ProtoConstants protoType) const noexcept {
+    const Field *field{nullptr};
+    if (fieldId < MAX_INDEXED_FIELD_ID) {
+        if ((fieldId < m_fieldIndex.size()) && (0 < m_fieldIndex[fieldId])) {
+            field = &m_fields[m_fieldIndex[fieldId] - 1];
+        }
+    } else {
+        for (const auto &f : m_fields) {
+            if (f.m_fieldId == fieldId) {
+                field = &f;
                 break;
             }
         }
     }
+    // Fields encoded with another Proto type than expected are ignored.
+    return ((nullptr != field) && (field->m_protoType == protoType)) ? field : nullptr;
+}
+
+bool FromProtoVisitor::readField(const char *&pos, const char *end) noexcept {
+    if (!fromVarInt(pos, end, m_keyFieldType)) {
+        return false;
+    }
+    m_protoType = static_cast<ProtoConstants>(m_keyFieldType & 0x7);
+    m_fieldId   = static_cast<uint32_t>(m_keyFieldType >> 3);
+    switch (m_protoType) {
+        case ProtoConstants::VARINT: return fromVarInt(pos, end, m_value);
+        case ProtoConstants::EIGHT_BYTES:
+            if (static_cast<std::size_t>(end - pos) < sizeof(double)) {
+                return false;
+            }
+            std::memcpy(m_doubleValue.buffer.data(), pos, sizeof(double));
+            m_doubleValue.uint64Value = le64toh(m_doubleValue.uint64Value);
+            pos += sizeof(double);
+            return true;
+        case ProtoConstants::FOUR_BYTES:
+            if (static_cast<std::size_t>(end - pos) < sizeof(float)) {
+                return false;
+            }
+            std::memcpy(m_floatValue.buffer.data(), pos, sizeof(float));
+            m_floatValue.uint32Value = le32toh(m_floatValue.uint32Value);
+            pos += sizeof(float);
+            return true;
+        case ProtoConstants::LENGTH_DELIMITED:
+            if (!fromVarInt(pos, end, m_value) || (static_cast<uint64_t>(end - pos) < m_value)) {
+                return false;
+            }
+            m_bytes = pos;
+            pos += m_value;
+            return true;
+    }
+    // Unknown Proto type.
+    return false;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
 FromProtoVisitor &FromProtoVisitor::operator=(const FromProtoVisitor &other) noexcept {
-    m_mapOfKeyValues = other.m_mapOfKeyValues;
+    try {
+        m_source     = other.m_source;
+        m_fields     = other.m_fields;
+        m_fieldIndex = other.m_fieldIndex;
+    } catch (...) { // LCOV_EXCL_LINE
+        m_source.clear(); // LCOV_EXCL_LINE
+        m_fields.clear(); // LCOV_EXCL_LINE
+        m_fieldIndex.clear(); // LCOV_EXCL_LINE
+    }
     return *this;
 }
 
@@ -102,11 +185,8 @@ void FromProtoVisitor::visit(uint32_t id, std::string &&typeName, std::string &&
     if (m_callToDecodeFromWithDirectVisit) {
         v = (0 != m_value);
     }
-    else if (m_mapOfKeyValues.count(id) > 0) {
-        try {
-            v = (0 != linb::any_cast<uint64_t>(m_mapOfKeyValues[id]));
-        } catch (const linb::bad_any_cast &) { // LCOV_EXCL_LINE
-        }
+    else if (const Field *field = findField(id, ProtoConstants::VARINT)) {
+        v = (0 != field->m_value);
     }
 }
 
@@ -116,12 +196,8 @@ void FromProtoVisitor::visit(uint32_t id, std::string &&typeName, std::string &&
     if (m_callToDecodeFromWithDirectVisit) {
         v = static_cast<char>(m_value);
     }
-    else if (m_mapOfKeyValues.count(id) > 0) {
-        try {
-            uint64_t _v = linb::any_cast<uint64_t>(m_mapOfKeyValues[id]);
-            v           = static_cast<char>(_v);
-        } catch (const linb::bad_any_cast &) { // LCOV_EXCL_LINE
-        }
+    else if (const Field *field = findField(id, ProtoConstants::VARINT)) {
+        v = static_cast<char>(field->m_value);
     }
 }
 
@@ -131,12 +207,8 @@ void FromProtoVisitor::visit(uint32_t id, std::string &&typeName, std::string &&
     if (m_callToDecodeFromWithDirectVisit) {
         v = static_cast<int8_t>(fromZigZag8(static_cast<uint8_t>(m_value)));
     }
-    else if (m_mapOfKeyValues.count(id) > 0) {
-        try {
-            uint64_t _v = linb::any_cast<uint64_t>(m_mapOfKeyValues[id]);
-            v           = static_cast<int8_t>(fromZigZag8(static_cast<uint8_t>(_v)));
-        } catch (const linb::bad_any_cast &) { // LCOV_EXCL_LINE
-        }
+    else if (const Field *field = findField(id, ProtoConstants::VARINT)) {
+        v = static_cast<int8_t>(fromZigZag8(static_cast<uint8_t>(field->m_value)));
     }
 }
 
@@ -146,12 +218,8 @@ void FromProtoVisitor::visit(uint32_t id, std::string &&typeName, std::string &&
     if (m_callToDecodeFromWithDirectVisit) {
         v = static_cast<uint8_t>(m_value);
     }
-    else if (m_mapOfKeyValues.count(id) > 0) {
-        try {
-            uint64_t _v = linb::any_cast<uint64_t>(m_mapOfKeyValues[id]);
-            v           = static_cast<uint8_t>(_v);
-        } catch (const linb::bad_any_cast &) { // LCOV_EXCL_LINE
-        }
+    else if (const Field *field = findField(id, ProtoConstants::VARINT)) {
+        v = static_cast<uint8_t>(field->m_value);
     }
 }
 
@@ -161,12 +229,8 @@ void FromProtoVisitor::visit(uint32_t id, std::string &&typeName, std::string &&
     if (m_callToDecodeFromWithDirectVisit) {
         v = static_cast<int16_t>(fromZigZag16(static_cast<uint16_t>(m_value)));
     }
-    else if (m_mapOfKeyValues.count(id) > 0) {
-        try {
-            uint64_t _v = linb::any_cast<uint64_t>(m_mapOfKeyValues[id]);
-            v           = static_cast<int16_t>(fromZigZag16(static_cast<uint16_t>(_v)));
-        } catch (const linb::bad_any_cast &) { // LCOV_EXCL_LINE
-        }
+    else if (const Field *field = findField(id, ProtoConstants::VARINT)) {
+        v = static_cast<int16_t>(fromZigZag16(static_cast<uint16_t>(field->m_value)));
     }
 }
 
@@ -176,12 +240,8 @@ void FromProtoVisitor::visit(uint32_t id, std::string &&typeName, std::string &&
     if (m_callToDecodeFromWithDirectVisit) {
         v = static_cast<uint16_t>(m_value);
     }
-    else if (m_mapOfKeyValues.count(id) > 0) {
-        try {
-            uint64_t _v = linb::any_cast<uint64_t>(m_mapOfKeyValues[id]);
-            v           = static_cast<uint16_t>(_v);
-        } catch (const linb::bad_any_cast &) { // LCOV_EXCL_LINE
-        }
+    else if (const Field *field = findField(id, ProtoConstants::VARINT)) {
+        v = static_cast<uint16_t>(field->m_value);
     }
 }
 
@@ -191,12 +251,8 @@ void FromProtoVisitor::visit(uint32_t id, std::string &&typeName, std::string &&
     if (m_callToDecodeFromWithDirectVisit) {
         v = static_cast<int32_t>(fromZigZag32(static_cast<uint32_t>(m_value)));
     }
-    else if (m_mapOfKeyValues.count(id) > 0) {
-        try {
-            uint64_t _v = linb::any_cast<uint64_t>(m_mapOfKeyValues[id]);
-            v           = static_cast<int32_t>(fromZigZag32(static_cast<uint32_t>(_v)));
-        } catch (const linb::bad_any_cast &) { // LCOV_EXCL_LINE
-        }
+    else if (const Field *field = findField(id, ProtoConstants::VARINT)) {
+        v = static_cast<int32_t>(fromZigZag32(static_cast<uint32_t>(field->m_value)));
     }
 }
 
@@ -206,12 +262,8 @@ void FromProtoVisitor::visit(uint32_t id, std::string &&typeName, std::string &&
     if (m_callToDecodeFromWithDirectVisit) {
         v = static_cast<uint32_t>(m_value);
     }
-    else if (m_mapOfKeyValues.count(id) > 0) {
-        try {
-            uint64_t _v = linb::any_cast<uint64_t>(m_mapOfKeyValues[id]);
-            v           = static_cast<uint32_t>(_v);
-        } catch (const linb::bad_any_cast &) { // LCOV_EXCL_LINE
-        }
+    else if (const Field *field = findField(id, ProtoConstants::VARINT)) {
+        v = static_cast<uint32_t>(field->m_value);
     }
 }
 
@@ -221,12 +273,8 @@ void FromProtoVisitor::visit(uint32_t id, std::string &&typeName, std::string &&
     if (m_callToDecodeFromWithDirectVisit) {
         v = static_cast<int64_t>(fromZigZag64(static_cast<uint64_t>(m_value)));
     }
-    else if (m_mapOfKeyValues.count(id) > 0) {
-        try {
-            uint64_t _v = linb::any_cast<uint64_t>(m_mapOfKeyValues[id]);
-            v           = static_cast<int64_t>(fromZigZag64(_v));
-        } catch (const linb::bad_any_cast &) { // LCOV_EXCL_LINE
-        }
+    else if (const Field *field = findField(id, ProtoConstants::VARINT)) {
+        v = static_cast<int64_t>(fromZigZag64(field->m_value));
     }
 }
 
@@ -236,11 +284,8 @@ void FromProtoVisitor::visit(uint32_t id, std::string &&typeName, std::string &&
     if (m_callToDecodeFromWithDirectVisit) {
         v = m_value;
     }
-    else if (m_mapOfKeyValues.count(id) > 0) {
-        try {
-            v = linb::any_cast<uint64_t>(m_mapOfKeyValues[id]);
-        } catch (const linb::bad_any_cast &) { // LCOV_EXCL_LINE
-        }
+    else if (const Field *field = findField(id, ProtoConstants::VARINT)) {
+        v = field->m_value;
     }
 }
 
@@ -250,11 +295,9 @@ void FromProtoVisitor::visit(uint32_t id, std::string &&typeName, std::string &&
     if (m_callToDecodeFromWithDirectVisit) {
         v = m_floatValue.floatValue;
     }
-    else if (m_mapOfKeyValues.count(id) > 0) {
-        try {
-            v = linb::any_cast<float>(m_mapOfKeyValues[id]);
-        } catch (const linb::bad_any_cast &) { // LCOV_EXCL_LINE
-        }
+    else if (const Field *field = findField(id, ProtoConstants::FOUR_BYTES)) {
+        const uint32_t BITS{static_cast<uint32_t>(field->m_value)};
+        std::memcpy(&v, &BITS, sizeof(float));
     }
 }
 
@@ -264,11 +307,8 @@ void FromProtoVisitor::visit(uint32_t id, std::string &&typeName, std::string &&
     if (m_callToDecodeFromWithDirectVisit) {
         v = m_doubleValue.doubleValue;
     }
-    else if (m_mapOfKeyValues.count(id) > 0) {
-        try {
-            v = linb::any_cast<double>(m_mapOfKeyValues[id]);
-        } catch (const linb::bad_any_cast &) { // LCOV_EXCL_LINE
-        }
+    else if (const Field *field = findField(id, ProtoConstants::EIGHT_BYTES)) {
+        std::memcpy(&v, &field->m_value, sizeof(double));
     }
 }
 
@@ -276,13 +316,14 @@ void FromProtoVisitor::visit(uint32_t id, std::string &&typeName, std::string &&
     (void)typeName;
     (void)name;
     if (m_callToDecodeFromWithDirectVisit) {
-        v = std::string(m_stringValue.data(), static_cast<std::size_t>(m_value));
+        if (ProtoConstants::LENGTH_DELIMITED == m_protoType) {
+            v.assign(m_bytes, static_cast<std::size_t>(m_value));
+        }
     }
-    else if (m_mapOfKeyValues.count(id) > 0) {
+    else if (const Field *field = findField(id, ProtoConstants::LENGTH_DELIMITED)) {
         try {
-            v = linb::any_cast<std::string>(m_mapOfKeyValues[id]);
-        } catch (const linb::bad_any_cast &) { // LCOV_EXCL_LINE
-        }
+            v.assign(m_source.data() + field->m_offset, static_cast<std::size_t>(field->m_value));
+        } catch (...) {} // LCOV_EXCL_LINE
     }
 }
 
@@ -324,4 +365,8 @@ std::size_t FromProtoVisitor::fromVarInt(std::istream &in, uint64_t &value) noex
 
     return size;
 }
+
+bool FromProtoVisitor::fromVarInt(const char *&pos, const char *end, uint64_t &value) noexcept {
+    return decodeVarInt(pos, end, value);
+}
 } // namespace cluon
@@ -0,0 +1,484 @@
+/*
+ * Copyright (C) 2017-2018  Christian Berger
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "cluon/IOReactor.hpp"
+
+// clang-format off
+#ifdef WIN32
+    #include <Winsock2.h>
+#else
+    #include <sys/select.h>
+    #include <sys/time.h>
+    #include <sys/types.h>
+    #include <unistd.h>
+#endif
+
+#ifdef __linux__
+    #include <sys/epoll.h>
+    #include <sys/eventfd.h>
+#endif
+// clang-format on
+
+#include <cerrno>
+#include <cstring>
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <iostream>
+#include <utility>
+#include <vector>
+
+namespace cluon {
+
+IOReactor::IOReactor(uint8_t numberOfIOThreads, uint8_t numberOfDispatchThreads) noexcept {
+    // Constructing the event loops and dispatch threads could fail.
+    try {
+        // Without dispatch threads, at least one I/O thread is needed to be useful.
+        const uint8_t IO_THREADS{(0 < numberOfDispatchThreads) ? numberOfIOThreads : std::max(numberOfIOThreads, static_cast<uint8_t>(1))};
+        for (uint8_t i{0}; i < IO_THREADS; i++) {
+            m_eventLoops.emplace_back(std::unique_ptr<EventLoop>(new EventLoop()));
+        }
+        if (0 < numberOfDispatchThreads) {
+            m_dispatcher.reset(new Dispatcher(numberOfDispatchThreads));
+        }
+    } catch (...) {                                                                        // LCOV_EXCL_LINE
+        std::cerr << "[cluon::IOReactor] Error while creating threads." << std::endl; // LCOV_EXCL_LINE
+    }
+}
+
+IOReactor::~IOReactor() noexcept {
+    // Stop the I/O threads first as they are feeding the dispatch threads.
+    m_eventLoops.clear();
+    if (m_dispatcher && m_dispatcher->isDispatchThread()) {
+        // Called from within a dispatched task: As a thread cannot join itself,
+        // the dispatch threads are joined from another thread after this task.
+        m_dispatcher->stop();
+        Dispatcher *dispatcher{m_dispatcher.release()};
+        try {
+            std::thread([dispatcher]() { delete dispatcher; }).detach();
+        } catch (...) {                                                                       // LCOV_EXCL_LINE
+            std::cerr << "[cluon::IOReactor] Error while creating thread." << std::endl; // LCOV_EXCL_LINE
+        }
+    }
+    m_dispatcher.reset();
+}
+
+bool IOReactor::isRunning() const noexcept {
+    bool retVal{!m_eventLoops.empty() || (nullptr != m_dispatcher)};
+    for (const auto &eventLoop : m_eventLoops) { retVal &= eventLoop->isRunning(); }
+    if (m_dispatcher) {
+        retVal &= m_dispatcher->isRunning();
+    }
+    return retVal;
+}
+
+uint8_t IOReactor::numberOfDispatchThreads() const noexcept {
+    return (m_dispatcher ? m_dispatcher->numberOfThreads() : 0);
+}
+
+bool IOReactor::addSocket(int32_t socket, std::function<void()> delegate) noexcept {
+    bool retVal{false};
+    if (!(socket < 0) && (nullptr != delegate) && !m_eventLoops.empty()) {
+        std::size_t eventLoop{0};
+        try {
+            // Reserve the socket and assign it to the next event loop.
+            std::lock_guard<std::mutex> lck(m_socketsMutex);
+            if (0 == m_eventLoopForSocket.count(socket)) {
+                eventLoop                     = m_nextEventLoop;
+                m_nextEventLoop               = (m_nextEventLoop + 1) % m_eventLoops.size();
+                m_eventLoopForSocket[socket] = eventLoop;
+                retVal                        = true;
+            }
+        } catch (...) { retVal = false; } // LCOV_EXCL_LINE
+
+        // The event loop is called without holding m_socketsMutex as delegates might add or remove sockets.
+        if (retVal && !m_eventLoops[eventLoop]->addSocket(socket, std::move(delegate))) {
+            std::lock_guard<std::mutex> lck(m_socketsMutex); // LCOV_EXCL_LINE
+            m_eventLoopForSocket.erase(socket);               // LCOV_EXCL_LINE
+            retVal = false;                                   // LCOV_EXCL_LINE
+        }
+    }
+    return retVal;
+}
+
+void IOReactor::removeSocket(int32_t socket) noexcept {
+    bool found{false};
+    std::size_t eventLoop{0};
+    {
+        std::lock_guard<std::mutex> lck(m_socketsMutex);
+        auto it = m_eventLoopForSocket.find(socket);
+        if (it != m_eventLoopForSocket.end()) {
+            eventLoop = it->second;
+            found     = true;
+            m_eventLoopForSocket.erase(it);
+        }
+    }
+    if (found) {
+        m_eventLoops[eventLoop]->removeSocket(socket);
+    }
+}
+
+uint32_t IOReactor::createDispatchQueue() noexcept {
+    return m_nextDispatchQueue.fetch_add(1);
+}
+
+void IOReactor::dispatch(uint32_t dispatchQueue, std::function<void()> &&task) noexcept {
+    if (nullptr != task) {
+        if (!m_dispatcher) {
+            // Execute the task directly in the calling I/O thread.
+            try {
+                task();
+            } catch (...) {} // LCOV_EXCL_LINE
+        } else {
+            m_dispatcher->dispatch(dispatchQueue, std::move(task));
+        }
+    }
+}
+
+void IOReactor::removeDispatchQueue(uint32_t dispatchQueue) noexcept {
+    if (m_dispatcher) {
+        m_dispatcher->removeDispatchQueue(dispatchQueue);
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+IOReactor::EventLoop::EventLoop() noexcept {
+#ifdef __linux__
+    m_epollFileDescriptor  = ::epoll_create1(EPOLL_CLOEXEC);
+    m_wakeUpFileDescriptor = ::eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    if ((m_epollFileDescriptor < 0) || (m_wakeUpFileDescriptor < 0)) {
+        std::cerr << "[cluon::IOReactor] Error while creating epoll/eventfd: " << ::strerror(errno) << std::endl; // LCOV_EXCL_LINE
+        return;                                                                                                     // LCOV_EXCL_LINE
+    }
+
+    // The wake-up file descriptor is identified by 0 as registration identifiers start at 1.
+    struct epoll_event event {};
+    event.events   = EPOLLIN;
+    event.data.u64 = 0;
+    if (0 != ::epoll_ctl(m_epollFileDescriptor, EPOLL_CTL_ADD, m_wakeUpFileDescriptor, &event)) {
+        std::cerr << "[cluon::IOReactor] Error while adding eventfd: " << ::strerror(errno) << std::endl; // LCOV_EXCL_LINE
+        return;                                                                                            // LCOV_EXCL_LINE
+    }
+#endif
+
+    // Constructing the thread could fail.
+    try {
+        m_processEventsThreadRunning.store(true);
+        m_processEventsThread = std::thread(&IOReactor::EventLoop::processEvents, this);
+    } catch (...) {                                                                 // LCOV_EXCL_LINE
+        m_processEventsThreadRunning.store(false);                                  // LCOV_EXCL_LINE
+        std::cerr << "[cluon::IOReactor] Error while creating thread." << std::endl; // LCOV_EXCL_LINE
+    }
+}
+
+IOReactor::EventLoop::~EventLoop() noexcept {
+    m_processEventsThreadRunning.store(false);
+
+#ifdef __linux__
+    if (!(m_wakeUpFileDescriptor < 0)) {
+        // Wake up epoll_wait immediately.
+        const uint64_t WAKE_UP{1};
+        auto retVal = ::write(m_wakeUpFileDescriptor, &WAKE_UP, sizeof(WAKE_UP));
+        (void)retVal;
+    }
+#endif
+
+    // Joining the thread could fail.
+    try {
+        if (m_processEventsThread.joinable()) {
+            m_processEventsThread.join();
+        }
+    } catch (...) {} // LCOV_EXCL_LINE
+
+#ifdef __linux__
+    if (!(m_epollFileDescriptor < 0)) {
+        ::close(m_epollFileDescriptor);
+    }
+    if (!(m_wakeUpFileDescriptor < 0)) {
+        ::close(m_wakeUpFileDescriptor);
+    }
+#endif
+    m_epollFileDescriptor  = -1;
+    m_wakeUpFileDescriptor = -1;
+}
+
+bool IOReactor::EventLoop::isRunning() const noexcept {
+    return m_processEventsThreadRunning.load();
+}
+
+bool IOReactor::EventLoop::addSocket(int32_t socket, std::function<void()> &&delegate) noexcept {
+    bool retVal{false};
+    if (m_processEventsThreadRunning.load()) {
+        try {
+            std::lock_guard<std::mutex> lck(m_registrationsMutex);
+            if (0 == m_registrations.count(socket)) {
+                Registration registration;
+                registration.m_identifier = m_nextRegistrationIdentifier++;
+                registration.m_delegate   = std::make_shared<std::function<void()>>(std::move(delegate));
+                if (0 == m_nextRegistrationIdentifier) {
+                    m_nextRegistrationIdentifier = 1; // LCOV_EXCL_LINE
+                }
+
+#ifdef __linux__
+                // Encode registration identifier and socket into the event to detect stale events for reused socket numbers.
+                struct epoll_event event {};
+                event.events   = EPOLLIN;
+                event.data.u64 = (static_cast<uint64_t>(registration.m_identifier) << 32) | static_cast<uint32_t>(socket);
+                retVal         = (0 == ::epoll_ctl(m_epollFileDescriptor, EPOLL_CTL_ADD, socket, &event));
+#else
+                retVal = true;
+#endif
+                if (retVal) {
+                    m_registrations[socket] = registration;
+                }
+            }
+        } catch (...) { retVal = false; } // LCOV_EXCL_LINE
+    }
+    return retVal;
+}
+
+void IOReactor::EventLoop::removeSocket(int32_t socket) noexcept {
+    try {
+        std::unique_lock<std::mutex> lck(m_registrationsMutex);
+        auto it = m_registrations.find(socket);
+        if (it != m_registrations.end()) {
+#ifdef __linux__
+            struct epoll_event event {};
+            ::epoll_ctl(m_epollFileDescriptor, EPOLL_CTL_DEL, socket, &event);
+#endif
+            m_registrations.erase(it);
+        }
+
+        // Wait for a running delegate unless we are called from within it.
+        if (std::this_thread::get_id() != m_processEventsThread.get_id()) {
+            m_delegateFinished.wait(lck, [this, socket] { return (socket != this->m_socketInDelegate); });
+        }
+    } catch (...) {} // LCOV_EXCL_LINE
+}
+
+void IOReactor::EventLoop::callDelegate(int32_t socket, uint32_t registrationIdentifier) noexcept {
+    try {
+        std::shared_ptr<std::function<void()>> delegate;
+        {
+            std::lock_guard<std::mutex> lck(m_registrationsMutex);
+            auto it = m_registrations.find(socket);
+            if ((it != m_registrations.end()) && (it->second.m_identifier == registrationIdentifier)) {
+                // Keep the delegate alive in case it removes its own socket.
+                delegate           = it->second.m_delegate;
+                m_socketInDelegate = socket;
+            }
+        }
+        if (delegate && (nullptr != *delegate)) {
+            (*delegate)();
+        }
+        {
+            std::lock_guard<std::mutex> lck(m_registrationsMutex);
+            m_socketInDelegate = -1;
+        }
+        m_delegateFinished.notify_all();
+    } catch (...) {} // LCOV_EXCL_LINE
+}
+
+void IOReactor::EventLoop::processEvents() noexcept {
+#ifdef __linux__
+    constexpr int32_t MAX_EVENTS{64};
+    std::array<struct epoll_event, MAX_EVENTS> events{};
+
+    while (m_processEventsThreadRunning.load()) {
+        // Block until at least one socket is readable or we are woken up.
+        const int32_t numberOfEvents = ::epoll_wait(m_epollFileDescriptor, events.data(), MAX_EVENTS, -1);
+        for (int32_t i{0}; i < numberOfEvents; i++) {
+            const uint64_t DATA{events[static_cast<std::size_t>(i)].data.u64};
+            if (0 == DATA) {
+                uint64_t value{0};
+                auto retVal = ::read(m_wakeUpFileDescriptor, &value, sizeof(value));
+                (void)retVal;
+            } else {
+                callDelegate(static_cast<int32_t>(DATA & 0xFFFFFFFF), static_cast<uint32_t>(DATA >> 32));
+            }
+        }
+    }
+#else
+    struct timeval timeout {};
+
+    // Define file descriptor set to watch for read operations.
+    fd_set setOfFiledescriptorsToReadFrom{};
+
+    std::vector<std::pair<int32_t, uint32_t>> sockets;
+    while (m_processEventsThreadRunning.load()) {
+        int32_t maxSocket{-1};
+        sockets.clear();
+        FD_ZERO(&setOfFiledescriptorsToReadFrom); // NOLINT
+        try {
+            std::lock_guard<std::mutex> lck(m_registrationsMutex);
+            for (const auto &registration : m_registrations) {
+                sockets.emplace_back(std::make_pair(registration.first, registration.second.m_identifier));
+                FD_SET(registration.first, &setOfFiledescriptorsToReadFrom); // NOLINT
+                maxSocket = std::max(maxSocket, registration.first);
+            }
+        } catch (...) {} // LCOV_EXCL_LINE
+
+        if (maxSocket < 0) {
+            // Nothing to watch yet.
+            using namespace std::literals::chrono_literals; // NOLINT
+            std::this_thread::sleep_for(20ms);
+            continue;
+        }
+
+        // Define timeout for select system call. The timeval struct must be
+        // reinitialized for every select call as it might be modified containing
+        // the actual time slept.
+        timeout.tv_sec  = 0;
+        timeout.tv_usec = 20 * 1000; // Check for new data with 50Hz.
+        ::select(maxSocket + 1, &setOfFiledescriptorsToReadFrom, nullptr, nullptr, &timeout);
+
+        for (const auto &s : sockets) {
+            if (FD_ISSET(s.first, &setOfFiledescriptorsToReadFrom)) { // NOLINT
+                callDelegate(s.first, s.second);
+            }
+        }
+    }
+#endif
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+IOReactor::Dispatcher::Dispatcher(uint8_t numberOfThreads) noexcept {
+    // Constructing the threads could fail.
+    try {
+        m_processTasksThreadsRunning.store(true);
+        for (uint8_t i{0}; i < numberOfThreads; i++) { m_processTasksThreads.emplace_back(&IOReactor::Dispatcher::processTasks, this); }
+    } catch (...) {                                                                  // LCOV_EXCL_LINE
+        m_processTasksThreadsRunning.store(false);                                   // LCOV_EXCL_LINE
+        std::cerr << "[cluon::IOReactor] Error while creating thread." << std::endl; // LCOV_EXCL_LINE
+    }
+}
+
+IOReactor::Dispatcher::~Dispatcher() noexcept {
+    stop();
+
+    // Joining the threads could fail.
+    try {
+        for (auto &t : m_processTasksThreads) {
+            if (t.joinable()) {
+                t.join();
+            }
+        }
+    } catch (...) {} // LCOV_EXCL_LINE
+}
+
+void IOReactor::Dispatcher::stop() noexcept {
+    try {
+        std::lock_guard<std::mutex> lck(m_tasksMutex);
+        m_processTasksThreadsRunning.store(false);
+    } catch (...) {} // LCOV_EXCL_LINE
+    m_tasksCondition.notify_all();
+}
+
+bool IOReactor::Dispatcher::isDispatchThread() const noexcept {
+    const std::thread::id ID{std::this_thread::get_id()};
+    return std::any_of(m_processTasksThreads.begin(), m_processTasksThreads.end(), [&ID](const std::thread &t) { return ID == t.get_id(); });
+}
+
+bool IOReactor::Dispatcher::isRunning() const noexcept {
+    return m_processTasksThreadsRunning.load();
+}
+
+uint8_t IOReactor::Dispatcher::numberOfThreads() const noexcept {
+    return static_cast<uint8_t>(m_processTasksThreads.size());
+}
+
+void IOReactor::Dispatcher::dispatch(uint32_t dispatchQueue, std::function<void()> &&task) noexcept {
+    bool notify{false};
+    try {
+        std::lock_guard<std::mutex> lck(m_tasksMutex);
+        auto &queue = m_dispatchQueues[dispatchQueue];
+        queue.m_tasks.emplace_back(std::move(task));
+        // A running queue is made ready again by its thread after the current task.
+        if (!queue.m_isReady && !queue.m_isRunning) {
+            m_readyDispatchQueues.push_back(dispatchQueue);
+            queue.m_isReady = true;
+            notify          = true;
+        }
+    } catch (...) {} // LCOV_EXCL_LINE
+    if (notify) {
+        m_tasksCondition.notify_one();
+    }
+}
+
+void IOReactor::Dispatcher::removeDispatchQueue(uint32_t dispatchQueue) noexcept {
+    try {
+        std::unique_lock<std::mutex> lck(m_tasksMutex);
+        auto it = m_dispatchQueues.find(dispatchQueue);
+        if (it != m_dispatchQueues.end()) {
+            it->second.m_tasks.clear();
+            if (it->second.m_isRunning && (std::this_thread::get_id() == it->second.m_runningThread)) {
+                // Called from within a task of this queue; the queue is removed afterwards.
+                it->second.m_isRemoved = true;
+            } else {
+                // Wait for a running task.
+                m_taskFinished.wait(lck, [this, dispatchQueue] {
+                    auto e = this->m_dispatchQueues.find(dispatchQueue);
+                    return ((e == this->m_dispatchQueues.end()) || !e->second.m_isRunning);
+                });
+                // A queue waiting in m_readyDispatchQueues is skipped when not found.
+                m_dispatchQueues.erase(dispatchQueue);
+            }
+        }
+    } catch (...) {} // LCOV_EXCL_LINE
+}
+
+void IOReactor::Dispatcher::processTasks() noexcept {
+    std::unique_lock<std::mutex> lck(m_tasksMutex);
+    while (m_processTasksThreadsRunning.load()) {
+        // Wait until the threads should stop or a dispatch queue has pending tasks.
+        m_tasksCondition.wait(lck, [this] { return (!this->m_processTasksThreadsRunning.load() || !this->m_readyDispatchQueues.empty()); });
+
+        while (m_processTasksThreadsRunning.load() && !m_readyDispatchQueues.empty()) {
+            const uint32_t DISPATCH_QUEUE{m_readyDispatchQueues.front()};
+            m_readyDispatchQueues.pop_front();
+
+            auto it = m_dispatchQueues.find(DISPATCH_QUEUE);
+            if ((it == m_dispatchQueues.end()) || it->second.m_tasks.empty()) {
+                if (it != m_dispatchQueues.end()) {
+                    it->second.m_isReady = false;
+                }
+                continue;
+            }
+
+            // References to elements of an std::unordered_map stay valid while other elements are added.
+            DispatchQueue &queue{it->second};
+            std::function<void()> task{std::move(queue.m_tasks.front())};
+            queue.m_tasks.pop_front();
+            queue.m_isReady       = false;
+            queue.m_isRunning     = true;
+            queue.m_runningThread = std::this_thread::get_id();
+
+            // Run the task without holding the lock.
+            lck.unlock();
+            try {
+                task();
+            } catch (...) {} // LCOV_EXCL_LINE
+            task = nullptr;
+            lck.lock();
+
+            queue.m_isRunning     = false;
+            queue.m_runningThread = std::thread::id();
+            if (queue.m_isRemoved) {
+                m_dispatchQueues.erase(DISPATCH_QUEUE);
+            } else if (!queue.m_tasks.empty()) {
+                // Let other dispatch queues go first to not starve them.
+                m_readyDispatchQueues.push_back(DISPATCH_QUEUE);
+                queue.m_isReady = true;
+            }
+            m_taskFinished.notify_all();
+        }
+    }
+}
+} // namespace cluon
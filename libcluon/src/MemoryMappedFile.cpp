@@ -0,0 +1,122 @@
+/*
+ * Copyright (C) 2017-2018  Christian Berger
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "cluon/MemoryMappedFile.hpp"
+
+// clang-format off
+#ifdef WIN32
+    #include <Windows.h>
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <sys/types.h>
+    #include <unistd.h>
+#endif
+// clang-format on
+
+#include <algorithm>
+#include <limits>
+
+namespace cluon {
+
+MemoryMappedFile::MemoryMappedFile(const std::string &file) noexcept {
+#ifdef WIN32
+    HANDLE fileHandle = CreateFileA(file.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (INVALID_HANDLE_VALUE != fileHandle) {
+        LARGE_INTEGER fileSize;
+        if (GetFileSizeEx(fileHandle, &fileSize) && (0 < fileSize.QuadPart)
+            && (static_cast<uint64_t>(fileSize.QuadPart) <= std::numeric_limits<std::size_t>::max())) {
+            HANDLE mappingHandle = CreateFileMappingA(fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+            if (nullptr != mappingHandle) {
+                const void *mapping = MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0);
+                if (nullptr != mapping) {
+                    m_data          = static_cast<const char *>(mapping);
+                    m_size          = static_cast<std::size_t>(fileSize.QuadPart);
+                    m_mappingHandle = mappingHandle;
+                    m_fileHandle    = fileHandle;
+                    return;
+                }
+                CloseHandle(mappingHandle);
+            }
+        }
+        CloseHandle(fileHandle);
+    }
+#else
+    const int fd{::open(file.c_str(), O_RDONLY)};
+    if (0 <= fd) {
+        struct stat fileStatus;
+        if ((0 == ::fstat(fd, &fileStatus)) && (0 < fileStatus.st_size)
+            && (static_cast<uint64_t>(fileStatus.st_size) <= std::numeric_limits<std::size_t>::max())) {
+            void *mapping{::mmap(nullptr, static_cast<std::size_t>(fileStatus.st_size), PROT_READ, MAP_PRIVATE, fd, 0)};
+            if (MAP_FAILED != mapping) {
+                m_data = static_cast<const char *>(mapping);
+                m_size = static_cast<std::size_t>(fileStatus.st_size);
+            }
+        }
+        // The mapping remains valid after closing the file.
+        ::close(fd);
+    }
+#endif
+}
+
+MemoryMappedFile::~MemoryMappedFile() noexcept {
+    if (nullptr != m_data) {
+#ifdef WIN32
+        UnmapViewOfFile(m_data);
+        CloseHandle(m_mappingHandle);
+        CloseHandle(m_fileHandle);
+#else
+        ::munmap(const_cast<char *>(m_data), m_size);
+#endif
+    }
+}
+
+bool MemoryMappedFile::isMapped() const noexcept {
+    return (nullptr != m_data);
+}
+
+const char *MemoryMappedFile::data() const noexcept {
+    return m_data;
+}
+
+std::size_t MemoryMappedFile::size() const noexcept {
+    return m_size;
+}
+
+void MemoryMappedFile::advise(MemoryMappedFileAccess access) const noexcept {
+#ifdef WIN32
+    (void)access;
+#else
+    if (nullptr != m_data) {
+        int advice{MADV_NORMAL};
+        if (MemoryMappedFileAccess::SEQUENTIAL == access) {
+            advice = MADV_SEQUENTIAL;
+        } else if (MemoryMappedFileAccess::RANDOM == access) {
+            advice = MADV_RANDOM;
+        }
+        ::madvise(const_cast<char *>(m_data), m_size, advice);
+    }
+#endif
+}
+
+void MemoryMappedFile::prefetch(uint64_t offset, std::size_t length) const noexcept {
+#ifdef WIN32
+    (void)offset;
+    (void)length;
+#else
+    if ((nullptr != m_data) && (offset < m_size) && (0 < length)) {
+        // madvise requires an address at a page boundary.
+        const uint64_t PAGE_SIZE_IN_BYTES{static_cast<uint64_t>(::sysconf(_SC_PAGESIZE))};
+        const uint64_t BEGIN{offset - (offset % PAGE_SIZE_IN_BYTES)};
+        const uint64_t END{std::min<uint64_t>(offset + length, m_size)};
+        ::madvise(const_cast<char *>(m_data) + BEGIN, static_cast<std::size_t>(END - BEGIN), MADV_WILLNEED);
+    }
+#endif
+}
+} // namespace cluon
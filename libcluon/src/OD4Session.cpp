@@ -8,29 +8,66 @@
 
 #include "cluon/OD4Session.hpp"
 #include "cluon/Envelope.hpp"
+#include "cluon/EnvelopeView.hpp"
 #include "cluon/FromProtoVisitor.hpp"
 #include "cluon/TerminateHandler.hpp"
 #include "cluon/Time.hpp"
+#include "cluon/UDPPacketSizeConstraints.hpp"
 
+#include <algorithm>
+#include <cerrno>
 #include <iostream>
-#include <sstream>
 #include <thread>
 
 namespace cluon {
 
-OD4Session::OD4Session(uint16_t CID, std::function<void(cluon::data::Envelope &&envelope)> delegate) noexcept
+OD4Session::OD4Session(uint16_t CID, std::function<void(cluon::data::Envelope &&envelope)> delegate, std::shared_ptr<cluon::IOReactor> reactor) noexcept
     : m_receiver{nullptr}
     , m_sender{"225.0.0." + std::to_string(CID), 12175}
-    , m_delegate(std::move(delegate))
-    , m_mapOfDataTriggeredDelegatesMutex{}
-    , m_mapOfDataTriggeredDelegates{} {
+    , m_delegate(std::move(delegate)) {
+    m_dataTriggers.store(new DataTriggers());
+    m_dispatch.store(new Dispatch());
     m_receiver = std::make_unique<cluon::UDPReceiver>(
         "225.0.0." + std::to_string(CID),
         12175,
-        [this](std::string &&data, std::string &&from, std::chrono::system_clock::time_point &&timepoint) {
-            this->callback(std::move(data), std::move(from), std::move(timepoint));
+        [this](cluon::PooledBuffer &&data, const struct sockaddr_storage &from, std::chrono::system_clock::time_point &&timepoint) {
+            this->callback(std::move(data), from, std::move(timepoint));
         },
-        m_sender.getSendFromPort() /* passing our local send from port to the UDPReceiver to filter out our own bytes */);
+        m_sender.getSendFromPort() /* passing our local send from port to the UDPReceiver to filter out our own bytes */,
+        reactor);
+}
+
+OD4Session::~OD4Session() noexcept {
+    // Stop receiving before the worker threads and the delegates are gone.
+    m_receiver.reset();
+    delete m_dispatch.exchange(nullptr);
+    delete m_dataTriggers.exchange(nullptr);
+}
+
+void OD4Session::waitForReaders() noexcept {
+    // Readers only look up a delegate and leave quickly; thus, yield first and
+    // back off to sleeping to not occupy a core while a reader is preempted.
+    constexpr uint32_t NUMBER_OF_YIELDS{16};
+    constexpr std::chrono::microseconds MAX_SLEEP{1000};
+    std::chrono::microseconds sleep{1};
+    for (uint32_t i{0}; 0 < m_numberOfReaders.load(); i++) {
+        if (i < NUMBER_OF_YIELDS) {
+            std::this_thread::yield();
+        } else {
+            std::this_thread::sleep_for(sleep);
+            sleep = std::min(sleep * 2, MAX_SLEEP);
+        }
+    }
+}
+
+void OD4Session::Dispatch::addDispatchQueues(int32_t messageIdentifier) noexcept {
+    if (m_dispatcher && (0 == m_dispatchQueues.count(messageIdentifier))) {
+        try {
+            std::vector<uint32_t> queues;
+            for (uint8_t i{0}; i < m_numberOfQueuesPerMessageIdentifier; i++) { queues.push_back(m_dispatcher->createDispatchQueue()); }
+            m_dispatchQueues[messageIdentifier] = std::move(queues);
+        } catch (...) {} // LCOV_EXCL_LINE
+    }
 }
 
 void OD4Session::timeTrigger(float freq, std::function<bool()> delegate) noexcept {
@@ -63,67 +100,268 @@ void OD4Session::timeTrigger(float freq, std::function<bool()> delegate) noexcep
 }
 
 bool OD4Session::dataTrigger(int32_t messageIdentifier, std::function<void(cluon::data::Envelope &&envelope)> delegate) noexcept {
+    bool retVal{false};
+    try {
+        std::shared_ptr<DataTrigger> dataTrigger;
+        if (nullptr != delegate) {
+            dataTrigger             = std::make_shared<DataTrigger>();
+            dataTrigger->m_delegate = std::move(delegate);
+        }
+        retVal = setDataTrigger(messageIdentifier, dataTrigger);
+    } catch (...) {} // LCOV_EXCL_LINE
+    return retVal;
+}
+
+bool OD4Session::setDataTrigger(int32_t messageIdentifier, std::shared_ptr<DataTrigger> dataTrigger) noexcept {
     bool retVal{false};
     if (nullptr == m_delegate) {
         try {
-            std::lock_guard<std::mutex> lck{m_mapOfDataTriggeredDelegatesMutex};
-            if ((nullptr == delegate) && (m_mapOfDataTriggeredDelegates.count(messageIdentifier) > 0)) {
-                auto element = m_mapOfDataTriggeredDelegates.find(messageIdentifier);
-                if (element != m_mapOfDataTriggeredDelegates.end()) {
-                    m_mapOfDataTriggeredDelegates.erase(element);
-                }
+            std::lock_guard<std::mutex> lck{m_writersMutex};
+            // Copy-on-write: The receiving thread might still read the current delegates.
+            std::unique_ptr<DataTriggers> dataTriggers{new DataTriggers(*m_dataTriggers.load())};
+            std::unique_ptr<Dispatch> previousDispatch;
+            if (nullptr == dataTrigger) {
+                // The dispatch queues are kept for registering this message identifier again.
+                dataTriggers->erase(messageIdentifier);
             } else {
-                m_mapOfDataTriggeredDelegates[messageIdentifier] = delegate;
+                const Dispatch *current{m_dispatch.load()};
+                if (current->m_dispatcher && (0 == current->m_dispatchQueues.count(messageIdentifier))) {
+                    // Publish the dispatch queues before the delegate so that the
+                    // receiving thread finds them together with the delegate.
+                    std::unique_ptr<Dispatch> dispatch{new Dispatch(*current)};
+                    dispatch->addDispatchQueues(messageIdentifier);
+                    previousDispatch.reset(m_dispatch.exchange(dispatch.release()));
+                }
+                (*dataTriggers)[messageIdentifier] = std::move(dataTrigger);
             }
+            std::unique_ptr<DataTriggers> previous{m_dataTriggers.exchange(dataTriggers.release())};
+            waitForReaders();
             retVal = true;
         } catch (...) {} // LCOV_EXCL_LINE
     }
     return retVal;
 }
 
-void OD4Session::callback(std::string &&data, std::string && /*from*/, std::chrono::system_clock::time_point &&timepoint) noexcept {
-    size_t numberOfDataTriggeredDelegates{0};
-    {
-        try {
-            std::lock_guard<std::mutex> lck{m_mapOfDataTriggeredDelegatesMutex};
-            numberOfDataTriggeredDelegates = m_mapOfDataTriggeredDelegates.size();
-        } catch (...) {} // LCOV_EXCL_LINE
+bool OD4Session::setDispatchMode(OD4SessionDispatchMode mode, uint8_t numberOfWorkers) noexcept {
+    bool retVal{false};
+    try {
+        std::unique_ptr<Dispatch> dispatch{new Dispatch()};
+        dispatch->m_mode = mode;
+        if (OD4SessionDispatchMode::PIPELINE_THREAD != mode) {
+            // Worker threads only; the Envelopes are received by m_receiver.
+            numberOfWorkers        = std::max(numberOfWorkers, static_cast<uint8_t>(1));
+            dispatch->m_dispatcher = std::make_shared<cluon::IOReactor>(0, numberOfWorkers);
+            // Envelopes from different senders can be processed in parallel.
+            dispatch->m_numberOfQueuesPerMessageIdentifier
+                = (OD4SessionDispatchMode::PER_MESSAGE_IDENTIFIER_AND_SENDER_STAMP == mode) ? numberOfWorkers : 1;
+        }
+        if ((OD4SessionDispatchMode::PIPELINE_THREAD == mode) || dispatch->m_dispatcher->isRunning()) {
+            std::unique_ptr<Dispatch> previous;
+            {
+                std::lock_guard<std::mutex> lck{m_writersMutex};
+                for (const auto &e : *m_dataTriggers.load()) { dispatch->addDispatchQueues(e.first); }
+                previous.reset(m_dispatch.exchange(dispatch.release()));
+                waitForReaders();
+            }
+            // Stop the previous worker threads without holding the lock.
+            previous.reset();
+            retVal = true;
+        }
+    } catch (...) {} // LCOV_EXCL_LINE
+    return retVal;
+}
+
+std::map<int32_t, OD4Session::DataTriggerStatistics> OD4Session::dataTriggerStatistics() noexcept {
+    std::map<int32_t, DataTriggerStatistics> retVal;
+    try {
+        std::lock_guard<std::mutex> lck{m_writersMutex};
+        for (const auto &e : *m_dataTriggers.load()) {
+            DataTriggerStatistics statistics;
+            statistics.m_numberOfCalls        = e.second->m_numberOfCalls.load();
+            statistics.m_totalExecutionTime   = std::chrono::nanoseconds(e.second->m_totalExecutionTime.load());
+            statistics.m_maximumExecutionTime = std::chrono::nanoseconds(e.second->m_maximumExecutionTime.load());
+            retVal[e.first]                   = statistics;
+        }
+    } catch (...) {} // LCOV_EXCL_LINE
+    return retVal;
+}
+
+template <typename F>
+void OD4Session::DataTrigger::measure(F &&f) noexcept {
+    const auto before = std::chrono::steady_clock::now();
+    try {
+        f();
+    } catch (...) {} // LCOV_EXCL_LINE
+    const int64_t DURATION{std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - before).count()};
+
+    m_numberOfCalls++;
+    m_totalExecutionTime += DURATION;
+    int64_t maximum{m_maximumExecutionTime.load()};
+    while ((maximum < DURATION) && !m_maximumExecutionTime.compare_exchange_weak(maximum, DURATION)) {}
+}
+
+void OD4Session::DataTrigger::call(cluon::data::Envelope &&envelope) noexcept {
+    if (nullptr != m_delegate) {
+        measure([this, &envelope]() { m_delegate(std::move(envelope)); });
     }
-    // Only unpack the envelope when it needs to be post-processed.
-    if ((nullptr != m_delegate) || (0 < numberOfDataTriggeredDelegates)) {
-        std::stringstream sstr(data);
-        auto retVal = extractEnvelope(sstr);
-
-        if (retVal.first) {
-            cluon::data::Envelope env{retVal.second};
-            env.received(cluon::time::convert(timepoint));
-
-            // "Catch all"-delegate.
-            if (nullptr != m_delegate) {
-                m_delegate(std::move(env));
-            } else {
-                try {
-                    // Data triggered-delegates.
-                    std::lock_guard<std::mutex> lck{m_mapOfDataTriggeredDelegatesMutex};
-                    if (m_mapOfDataTriggeredDelegates.count(env.dataType()) > 0) {
-                        m_mapOfDataTriggeredDelegates[env.dataType()](std::move(env));
-                    }
-                } catch (...) {} // LCOV_EXCL_LINE
+}
+
+void OD4Session::DataTrigger::call(const char *serializedData, std::size_t size, const cluon::EnvelopeMeta &meta) noexcept {
+    if (nullptr != m_serializedDataDelegate) {
+        measure([this, serializedData, size, &meta]() { m_serializedDataDelegate(serializedData, size, meta); });
+    }
+}
+
+void OD4Session::callback(cluon::PooledBuffer &&data, const struct sockaddr_storage & /*from*/, std::chrono::system_clock::time_point &&timepoint) noexcept {
+    // The fields of the received Envelope are decoded only when needed.
+    const cluon::EnvelopeView VIEW{cluon::viewEnvelope(data.data(), data.size())};
+    if (!VIEW.valid()) {
+        return;
+    }
+
+    // "Catch all"-delegate.
+    if (nullptr != m_delegate) {
+        cluon::data::Envelope env{VIEW.toEnvelope()};
+        env.received(cluon::time::convert(timepoint));
+        m_delegate(std::move(env));
+        return;
+    }
+
+    // Data-triggered delegates: Read only the message identifier and sender
+    // stamp to discard Envelopes without delegate before decoding them.
+    const int32_t dataType{VIEW.dataType()};
+    const uint32_t senderStamp{VIEW.senderStamp()};
+
+    // Look up the delegate and its dispatch queue without locking; the
+    // delegate is called after leaving the snapshots.
+    std::shared_ptr<DataTrigger> dataTrigger;
+    std::shared_ptr<cluon::IOReactor> dispatcher;
+    uint32_t dispatchQueue{0};
+    m_numberOfReaders++;
+    {
+        const DataTriggers *dataTriggers{m_dataTriggers.load()};
+        auto element = dataTriggers->find(dataType);
+        if (element != dataTriggers->end()) {
+            dataTrigger = element->second;
+
+            const Dispatch *dispatch{m_dispatch.load()};
+            auto queues = dispatch->m_dispatchQueues.find(dataType);
+            if (queues != dispatch->m_dispatchQueues.end()) {
+                // Envelopes of one stream are always dispatched to the same queue to keep
+                // their order; the sender stamp selects one of the message identifier's queues.
+                dispatcher    = dispatch->m_dispatcher;
+                dispatchQueue = queues->second[senderStamp % queues->second.size()];
             }
         }
     }
+    m_numberOfReaders--;
+
+    if (dataTrigger && (nullptr != dataTrigger->m_serializedDataDelegate)) {
+        // Typed delegate: Decode the message directly from the received buffer.
+        cluon::EnvelopeMeta meta{VIEW.meta()};
+        const char *serializedData{VIEW.serializedData().first};
+        const std::size_t serializedDataSize{VIEW.serializedData().second};
+        meta.m_received = cluon::time::convert(timepoint);
+        if (dispatcher) {
+            try {
+                // The received buffer is shared with the worker thread.
+                cluon::PooledBuffer buffer{std::move(data)};
+                dispatcher->dispatch(dispatchQueue, [dataTrigger, buffer, serializedData, serializedDataSize, meta]() {
+                    dataTrigger->call(serializedData, serializedDataSize, meta);
+                });
+            } catch (...) {} // LCOV_EXCL_LINE
+        } else {
+            dataTrigger->call(serializedData, serializedDataSize, meta);
+        }
+    } else if (dataTrigger) {
+        cluon::data::Envelope env{VIEW.toEnvelope()};
+        env.received(cluon::time::convert(timepoint));
+        if (dispatcher) {
+            try {
+                auto envelope = std::make_shared<cluon::data::Envelope>(std::move(env));
+                dispatcher->dispatch(dispatchQueue, [dataTrigger, envelope]() { dataTrigger->call(std::move(*envelope)); });
+            } catch (...) {} // LCOV_EXCL_LINE
+        } else {
+            dataTrigger->call(std::move(env));
+        }
+    }
 }
 
 void OD4Session::send(cluon::data::Envelope &&envelope) noexcept {
-    sendInternal(cluon::serializeEnvelope(std::move(envelope)));
+    std::lock_guard<std::mutex> lck(m_senderMutex);
+    const cluon::EnvelopeParts PARTS{cluon::serializeEnvelopeParts(m_sendBuffer, envelope)};
+    m_sender.send(PARTS.data(), PARTS.size());
 }
 
-void OD4Session::sendInternal(std::string &&dataToSend) noexcept {
-    m_sender.send(std::move(dataToSend));
+OD4Session::Batch::Batch(OD4Session &session) noexcept
+    : m_session{session} {}
+
+OD4Session::Batch::~Batch() noexcept {
+    flush();
+}
+
+bool OD4Session::Batch::send(cluon::data::Envelope &&envelope) noexcept {
+    return append(cluon::serializeEnvelopeParts(m_partsBuffer, envelope));
+}
+
+bool OD4Session::Batch::append(const cluon::EnvelopeParts &parts) noexcept {
+    constexpr uint16_t MAX_LENGTH = static_cast<uint16_t>(UDPPacketSizeConstraints::MAX_SIZE_UDP_PACKET)
+                                    - static_cast<uint16_t>(UDPPacketSizeConstraints::SIZE_IPv4_HEADER)
+                                    - static_cast<uint16_t>(UDPPacketSizeConstraints::SIZE_UDP_HEADER);
+    if (0 == parts[0].second) {
+        return false; // LCOV_EXCL_LINE
+    }
+    std::size_t size{0};
+    for (const auto &part : parts) { size += part.second; }
+    if (MAX_LENGTH < size) {
+        // UDPSender would reject the entire batch because of this Envelope.
+        std::cerr << "[cluon::OD4Session]: Envelope with " << size << " bytes exceeds the maximum UDP payload and is not added to the batch." << std::endl;
+        return false;
+    }
+
+    bool retVal{false};
+    try {
+        const std::size_t OFFSET{m_frames.size()};
+        for (const auto &part : parts) { m_frames.append(part.first, part.second); }
+        m_frameOffsetsAndSizes.emplace_back(OFFSET, m_frames.size() - OFFSET);
+        retVal = true;
+    } catch (...) {} // LCOV_EXCL_LINE
+    return retVal;
+}
+
+std::pair<ssize_t, int32_t> OD4Session::Batch::flush() noexcept {
+    std::pair<ssize_t, int32_t> retVal{0, 0};
+    if (!m_frameOffsetsAndSizes.empty()) {
+        try {
+            // The frames are referenced only after all were appended as m_frames might have been reallocated.
+            m_packets.clear();
+            for (const auto &e : m_frameOffsetsAndSizes) { m_packets.emplace_back(m_frames.data() + e.first, e.second); }
+            retVal = m_session.m_sender.send(m_packets);
+        } catch (...) { retVal = {-1, ENOMEM}; } // LCOV_EXCL_LINE
+        m_frames.clear();
+        m_frameOffsetsAndSizes.clear();
+    }
+    return retVal;
+}
+
+std::size_t OD4Session::Batch::size() const noexcept {
+    return m_frameOffsetsAndSizes.size();
 }
 
 bool OD4Session::isRunning() noexcept {
     return m_receiver->isRunning();
 }
 
+void OD4Session::setPipelineCapacity(std::size_t capacity, NotifyingPipelineOverflowPolicy policy) noexcept {
+    m_receiver->setPipelineCapacity(capacity, policy);
+}
+
+std::size_t OD4Session::pipelineSize() const noexcept {
+    return m_receiver->pipelineSize();
+}
+
+uint64_t OD4Session::numberOfDroppedEnvelopes() const noexcept {
+    return m_receiver->numberOfDroppedDatagrams();
+}
+
 } // namespace cluon
@@ -8,40 +8,38 @@
 
 #include "cluon/Player.hpp"
 #include "cluon/Envelope.hpp"
+#include "cluon/EnvelopeView.hpp"
+#include "cluon/RecIndex.hpp"
 #include "cluon/Time.hpp"
 
 #include <algorithm>
 #include <chrono>
-#include <cmath>
 #include <cstdio>
 #include <fstream>
 #include <iostream>
 #include <limits>
 #include <thread>
 #include <utility>
+#include <vector>
 
 namespace cluon {
 
-IndexEntry::IndexEntry(const int64_t &sampleTimeStamp, const uint64_t &filePosition) noexcept
-    : m_sampleTimeStamp(sampleTimeStamp)
-    , m_filePosition(filePosition)
-    , m_available(false) {}
-
-////////////////////////////////////////////////////////////////////////
-
-Player::Player(const std::string &file, const bool &autoRewind, const bool &threading) noexcept
+Player::Player(const std::string &file, const bool &autoRewind, const bool &threading, const bool &memoryMapped) noexcept
     : m_threading(threading)
     , m_file(file)
     , m_recFile()
     , m_recFileValid(false)
+    , m_recFileSize(0)
+    , m_memoryMapped(memoryMapped)
+    , m_mappedRecFile()
+    , m_prefetchBegin(0)
     , m_autoRewind(autoRewind)
     , m_indexMutex()
-    , m_index()
-    , m_previousPreviousEnvelopeAlreadyReplayed(m_index.end())
-    , m_previousEnvelopeAlreadyReplayed(m_index.begin())
-    , m_currentEnvelopeToReplay(m_index.begin())
-    , m_nextEntryToReadFromRecFile(m_index.begin())
-    , m_desiredInitialLevel(0)
+    , m_indexSampleTimeStamps()
+    , m_indexFilePositions()
+    , m_previousEnvelopeAlreadyReplayed(0)
+    , m_currentEnvelopeToReplay(0)
+    , m_nextEntryToReadFromRecFile(0)
     , m_firstTimePointReturningAEnvelope()
     , m_numberOfReturnedEnvelopesInTotal(0)
     , m_delay(0)
@@ -49,6 +47,11 @@ Player::Player(const std::string &file, const bool &autoRewind, const bool &thre
     , m_envelopeCacheFillingThreadIsRunning(false)
     , m_envelopeCacheFillingThread()
     , m_envelopeCache()
+    , m_envelopeCacheBytes()
+    , m_envelopeCacheFilled()
+    , m_envelopeCacheConsumed()
+    , m_bytesReplayedInTotal(0)
+    , m_cacheStatistics()
     , m_playerListenerMutex()
     , m_playerListener(nullptr) {
     initializeIndex();
@@ -90,106 +93,237 @@ void Player::initializeIndex() noexcept {
         int64_t fileLength = m_recFile.tellg();
         m_recFile.seekg(0, m_recFile.beg);
 
+        // Read the Envelopes directly from the mapped pages if possible.
+        if (m_memoryMapped) {
+            try {
+                m_mappedRecFile = std::make_unique<cluon::MemoryMappedFile>(m_file);
+            } catch (...) {} // LCOV_EXCL_LINE
+            if (m_mappedRecFile && m_mappedRecFile->isMapped()) {
+                fileLength = static_cast<int64_t>(m_mappedRecFile->size());
+                m_recFile.close();
+            } else {
+                m_mappedRecFile.reset();
+            }
+        }
+        m_recFileSize = static_cast<uint64_t>(std::max<int64_t>(fileLength, 0));
+
+        // Use the sidecar index when it matches the .rec file.
+        const cluon::data::TimeStamp BEFORE{cluon::time::now()};
+        cluon::RecIndex recIndex;
+        if (recIndex.load(m_file)) {
+            // The entries are sorted by sample time stamp.
+            setIndex(recIndex.entries(), recIndex.size());
+            const cluon::data::TimeStamp AFTER{cluon::time::now()};
+
+            std::clog << "[cluon::Player]: " << m_file << " contains " << m_indexSampleTimeStamps.size() << " entries; "
+                      << "loaded " << cluon::RecIndex::filename(m_file) << " in " << cluon::time::deltaInMicroseconds(AFTER, BEFORE) / static_cast<int64_t>(1000)
+                      << "ms." << std::endl;
+            return;
+        }
+
         // Read complete file and store file positions to envelopes to create
         // index of available data. The actual reading of Envelopes is deferred.
         uint64_t totalBytesRead = 0;
-        const cluon::data::TimeStamp BEFORE{cluon::time::now()};
-        {
+        uint64_t numberOfSkippedBytes{0};
+        std::vector<cluon::RecIndexEntry> entries;
+        bool scanned{false};
+        if (m_mappedRecFile) {
+            // Scan chunks of the mapped .rec file concurrently.
+            const uint32_t NUMBER_OF_THREADS{std::max<uint32_t>(std::thread::hardware_concurrency(), 1)};
+            m_mappedRecFile->advise(cluon::MemoryMappedFileAccess::SEQUENTIAL);
+            scanned = cluon::RecIndex::scan(m_mappedRecFile->data(), m_mappedRecFile->size(), NUMBER_OF_THREADS, entries, numberOfSkippedBytes);
+            m_mappedRecFile->advise(cluon::MemoryMappedFileAccess::NORMAL);
+        } else {
             int32_t oldPercentage = -1;
-            while (m_recFile.good()) {
-                const uint64_t POS_BEFORE = static_cast<uint64_t>(m_recFile.tellg());
-                auto retVal               = extractEnvelope(m_recFile);
-                const uint64_t POS_AFTER  = static_cast<uint64_t>(m_recFile.tellg());
-
-                if (!m_recFile.eof() && retVal.first) {
-                    totalBytesRead += (POS_AFTER - POS_BEFORE);
-
-                    // Store mapping .rec file position --> index entry.
-                    const int64_t microseconds = cluon::time::toMicroseconds(retVal.second.sampleTimeStamp());
-                    m_index.emplace(std::make_pair(microseconds, IndexEntry(microseconds, POS_BEFORE)));
-
-                    const int32_t percentage = static_cast<int32_t>((static_cast<float>(m_recFile.tellg()) * 100.0f) / static_cast<float>(fileLength));
-                    if ((percentage % 5 == 0) && (percentage != oldPercentage)) {
-                        std::clog << "[cluon::Player]: Indexed " << percentage << "% from " << m_file << "." << std::endl;
-                        oldPercentage = percentage;
-                    }
+            scanned = cluon::RecIndex::scan(m_recFile, entries, numberOfSkippedBytes, [this, &oldPercentage, fileLength](uint64_t position) {
+                const int32_t percentage = static_cast<int32_t>((static_cast<float>(position) * 100.0f) / static_cast<float>(fileLength));
+                if ((percentage % 5 == 0) && (percentage != oldPercentage)) {
+                    std::clog << "[cluon::Player]: Indexed " << percentage << "% from " << m_file << "." << std::endl;
+                    oldPercentage = percentage;
                 }
+            });
+        }
+        if (scanned) {
+            // The entries are sorted by sample time stamp.
+            totalBytesRead = m_recFileSize - std::min<uint64_t>(numberOfSkippedBytes, m_recFileSize);
+            if (0 < numberOfSkippedBytes) {
+                std::clog << "[cluon::Player]: Skipped " << numberOfSkippedBytes << " corrupt bytes in " << m_file << "." << std::endl;
             }
         }
+        setIndex(entries.data(), entries.size());
         const cluon::data::TimeStamp AFTER{cluon::time::now()};
 
-        std::clog << "[cluon::Player]: " << m_file << " contains " << m_index.size() << " entries; "
+        std::clog << "[cluon::Player]: " << m_file << " contains " << m_indexSampleTimeStamps.size() << " entries; "
                   << "read " << totalBytesRead << " bytes "
                   << "in " << cluon::time::deltaInMicroseconds(AFTER, BEFORE) / static_cast<int64_t>(1000 * 1000) << "s." << std::endl;
+
+        // Store the index next to the .rec file to skip scanning it next time.
+        if (scanned && (entries.size() == m_indexSampleTimeStamps.size()) && !cluon::RecIndex::write(m_file, static_cast<uint64_t>(fileLength), entries)) {
+            std::clog << "[cluon::Player]: Could not write " << cluon::RecIndex::filename(m_file) << "." << std::endl;
+        }
     } else {
         std::clog << "[cluon::Player]: " << m_file << " could not be opened." << std::endl;
     }
 }
 
+void Player::setIndex(const cluon::RecIndexEntry *entries, const std::size_t &numberOfEntries) noexcept {
+    try {
+        std::lock_guard<std::mutex> lck(m_indexMutex);
+        m_indexSampleTimeStamps.resize(numberOfEntries);
+        m_indexFilePositions.resize(numberOfEntries);
+        for (std::size_t i{0}; i < numberOfEntries; i++) {
+            m_indexSampleTimeStamps[i] = entries[i].m_sampleTimeStamp;
+            m_indexFilePositions[i]    = entries[i].m_filePosition;
+        }
+    } catch (...) { m_indexSampleTimeStamps.clear(); m_indexFilePositions.clear(); } // LCOV_EXCL_LINE
+}
+
 void Player::resetCaches() noexcept {
     try {
         std::lock_guard<std::mutex> lck(m_indexMutex);
         m_delay                            = 0;
         m_numberOfReturnedEnvelopesInTotal = 0;
-        m_envelopeCache.clear();
+        m_cacheStatistics.m_bytesInCache   = 0;
     } catch (...) {} // LCOV_EXCL_LINE
 }
 
 void Player::resetIterators() noexcept {
     try {
         std::lock_guard<std::mutex> lck(m_indexMutex);
-        // Point to first entry in index.
-        m_nextEntryToReadFromRecFile = m_previousEnvelopeAlreadyReplayed = m_currentEnvelopeToReplay = m_index.begin();
-        // Invalidate iterator for erasing entries point.
-        m_previousPreviousEnvelopeAlreadyReplayed = m_index.end();
+        // Point to first entry in index; the cache is empty.
+        m_nextEntryToReadFromRecFile = m_previousEnvelopeAlreadyReplayed = m_currentEnvelopeToReplay = 0;
     } catch (...) {} // LCOV_EXCL_LINE
 }
 
 void Player::computeInitialCacheLevelAndFillCache() noexcept {
-    if (m_recFileValid && (m_index.size() > 0)) {
-        int64_t smallestSampleTimePoint = std::numeric_limits<int64_t>::max();
-        int64_t largestSampleTimePoint  = std::numeric_limits<int64_t>::min();
-        for (auto it = m_index.begin(); it != m_index.end(); it++) {
-            smallestSampleTimePoint = std::min(smallestSampleTimePoint, it->first);
-            largestSampleTimePoint  = std::max(largestSampleTimePoint, it->first);
-        }
-
-        const uint32_t ENTRIES_TO_READ_PER_SECOND_FOR_REALTIME_REPLAY
-            = static_cast<uint32_t>(std::ceil(static_cast<float>(m_index.size()) * (static_cast<float>(Player::ONE_SECOND_IN_MICROSECONDS))
-                                              / static_cast<float>(largestSampleTimePoint - smallestSampleTimePoint)));
-        m_desiredInitialLevel = std::max<uint32_t>(ENTRIES_TO_READ_PER_SECOND_FOR_REALTIME_REPLAY * Player::LOOK_AHEAD_IN_S, MIN_ENTRIES_FOR_LOOK_AHEAD);
+    if (m_recFileValid && (m_indexSampleTimeStamps.size() > 0)) {
+        // The index is sorted by sample time stamp.
+        const int64_t smallestSampleTimePoint = m_indexSampleTimeStamps.front();
+        const int64_t largestSampleTimePoint  = m_indexSampleTimeStamps.back();
+
+        // Until the consumption is measured, read ahead the bytes needed to replay in realtime.
+        const double NUMBER_OF_ENTRIES{static_cast<double>(m_indexSampleTimeStamps.size())};
+        const double BYTES_PER_ENTRY{static_cast<double>(sizeof(cluon::data::Envelope)) + static_cast<double>(m_recFileSize) / NUMBER_OF_ENTRIES};
+        const double DURATION_IN_S{static_cast<double>(largestSampleTimePoint - smallestSampleTimePoint) / Player::ONE_SECOND_IN_MICROSECONDS};
+        const double BYTES_PER_SECOND_FOR_REALTIME_REPLAY{(0 < DURATION_IN_S) ? NUMBER_OF_ENTRIES * BYTES_PER_ENTRY / DURATION_IN_S
+                                                                              : static_cast<double>(MAX_READ_AHEAD_IN_BYTES)};
+
+        uint64_t readAheadInBytes{0};
+        try {
+            std::lock_guard<std::mutex> lck(m_indexMutex);
+            m_cacheStatistics.m_consumedBytesPerSecond = BYTES_PER_SECOND_FOR_REALTIME_REPLAY;
+            m_cacheStatistics.m_readAheadInBytes       = static_cast<uint64_t>(
+                std::min<double>(std::max<double>(BYTES_PER_SECOND_FOR_REALTIME_REPLAY * READ_AHEAD_IN_S, MIN_READ_AHEAD_IN_BYTES), MAX_READ_AHEAD_IN_BYTES));
+            readAheadInBytes = m_cacheStatistics.m_readAheadInBytes;
+        } catch (...) {} // LCOV_EXCL_LINE
 
-        std::clog << "[cluon::Player]: Initializing cache with " << m_desiredInitialLevel << " entries." << std::endl;
+        std::clog << "[cluon::Player]: Initializing cache with " << readAheadInBytes << " bytes." << std::endl;
 
         resetCaches();
         resetIterators();
-        fillEnvelopeCache(m_desiredInitialLevel);
+        fillEnvelopeCache(std::numeric_limits<uint32_t>::max(), readAheadInBytes);
     }
 }
 
-uint32_t Player::fillEnvelopeCache(const uint32_t &maxNumberOfEntriesToReadFromFile) noexcept {
+uint32_t Player::numberOfEntriesInCache() const noexcept {
+    return static_cast<uint32_t>(m_nextEntryToReadFromRecFile - m_currentEnvelopeToReplay);
+}
+
+bool Player::isRefillingCacheNeeded() const noexcept {
+    return (m_nextEntryToReadFromRecFile < m_indexFilePositions.size()) && (m_cacheStatistics.m_bytesInCache < m_cacheStatistics.m_readAheadInBytes / 2);
+}
+
+uint32_t Player::fillEnvelopeCache(const uint32_t &maxNumberOfEntriesToReadFromFile, const uint64_t &maxBytesInCache) noexcept {
     uint32_t entriesReadFromFile = 0;
     if (m_recFileValid && (maxNumberOfEntriesToReadFromFile > 0)) {
         // Reset any fstream's error states.
         m_recFile.clear();
 
-        while ((m_nextEntryToReadFromRecFile != m_index.end()) && (entriesReadFromFile < maxNumberOfEntriesToReadFromFile)) {
-            // Move to corresponding position in the .rec file.
-            m_recFile.seekg(static_cast<std::streamoff>(m_nextEntryToReadFromRecFile->second.m_filePosition));
+        while (entriesReadFromFile < maxNumberOfEntriesToReadFromFile) {
+            // Stop at the end of the index or when the cache holds enough bytes.
+            bool hasFreeEntryInCache{false};
+            try {
+                std::lock_guard<std::mutex> lck(m_indexMutex);
+                hasFreeEntryInCache = (m_nextEntryToReadFromRecFile < m_indexFilePositions.size()) && (m_cacheStatistics.m_bytesInCache < maxBytesInCache);
+                if (hasFreeEntryInCache && (numberOfEntriesInCache() == m_envelopeCache.size())) {
+                    // All entries of the ring buffer are used: Move the cached entries into a larger one.
+                    const std::size_t CAPACITY{
+                        std::min<std::size_t>(m_indexFilePositions.size(), std::max<std::size_t>(2 * m_envelopeCache.size(), MIN_ENTRIES_IN_CACHE))};
+                    std::vector<cluon::data::Envelope> envelopeCache(CAPACITY);
+                    std::vector<uint32_t> envelopeCacheBytes(CAPACITY);
+                    for (std::size_t i{m_currentEnvelopeToReplay}; i < m_nextEntryToReadFromRecFile; i++) {
+                        envelopeCache[i % CAPACITY]      = std::move(m_envelopeCache[i % m_envelopeCache.size()]);
+                        envelopeCacheBytes[i % CAPACITY] = m_envelopeCacheBytes[i % m_envelopeCacheBytes.size()];
+                    }
+                    m_envelopeCache.swap(envelopeCache);
+                    m_envelopeCacheBytes.swap(envelopeCacheBytes);
+                }
+            } catch (...) { hasFreeEntryInCache = false; } // LCOV_EXCL_LINE
+            if (!hasFreeEntryInCache) {
+                break;
+            }
+
+            const uint64_t POSITION{m_indexFilePositions[m_nextEntryToReadFromRecFile]};
+            const int64_t SAMPLE_TIME_STAMP{m_indexSampleTimeStamps[m_nextEntryToReadFromRecFile]};
+            std::pair<bool, cluon::data::Envelope> retVal{false, cluon::data::Envelope()};
+            uint64_t bytesInRecFile{0};
+            if (m_mappedRecFile) {
+                // Keep the pages ahead of the next Envelope being read in background.
+                if ((POSITION < m_prefetchBegin) || (m_prefetchBegin + PREFETCH_IN_BYTES / 2 <= POSITION)) {
+                    m_mappedRecFile->prefetch(POSITION, PREFETCH_IN_BYTES);
+                    m_prefetchBegin = POSITION;
+                }
 
-            // Read the corresponding cluon::data::Envelope.
-            auto retVal = extractEnvelope(m_recFile);
-            if (retVal.first) {
-                // Store the envelope in the envelope cache.
+                // Decode the corresponding cluon::data::Envelope from the mapped pages.
+                if (POSITION < m_mappedRecFile->size()) {
+                    auto envelope = unframeEnvelope(m_mappedRecFile->data() + POSITION, m_mappedRecFile->size() - static_cast<std::size_t>(POSITION));
+                    const cluon::EnvelopeView VIEW{envelope.first, envelope.second};
+                    // The index might be stale: Accept only a well-formed Envelope with the indexed sample time stamp.
+                    if (VIEW.valid() && (SAMPLE_TIME_STAMP == cluon::time::toMicroseconds(VIEW.sampleTimeStamp()))) {
+                        retVal         = std::make_pair(true, VIEW.toEnvelope());
+                        bytesInRecFile = 5 + envelope.second;
+                    }
+                }
+            } else {
+                // Move to corresponding position in the .rec file.
+                m_recFile.seekg(static_cast<std::streamoff>(POSITION));
+
+                // Read the corresponding cluon::data::Envelope; the index might be stale.
+                retVal = extractEnvelope(m_recFile);
+                retVal.first &= (SAMPLE_TIME_STAMP == cluon::time::toMicroseconds(retVal.second.sampleTimeStamp()));
+                if (retVal.first) {
+                    bytesInRecFile = static_cast<uint64_t>(std::max<std::streamoff>(static_cast<std::streamoff>(m_recFile.tellg()), 0)) - POSITION;
+                }
+            }
+            if (!retVal.first) {
+                // Skip the entry as it cannot be read; an entry without bytes is not replayed.
                 try {
                     std::lock_guard<std::mutex> lck(m_indexMutex);
-                    m_nextEntryToReadFromRecFile->second.m_available
-                        = m_envelopeCache.emplace(std::make_pair(m_nextEntryToReadFromRecFile->second.m_filePosition, retVal.second)).second;
+                    const std::size_t ENTRY{m_nextEntryToReadFromRecFile % m_envelopeCache.size()};
+                    m_envelopeCache[ENTRY]      = cluon::data::Envelope();
+                    m_envelopeCacheBytes[ENTRY] = 0;
+                    if (0 == m_cacheStatistics.m_numberOfSkippedEntries++) {
+                        std::clog << "[cluon::Player]: Skipping entries that cannot be read from " << m_file << " at position " << POSITION << "."
+                                  << std::endl;
+                    }
+                    m_nextEntryToReadFromRecFile++;
                 } catch (...) {} // LCOV_EXCL_LINE
+                m_envelopeCacheFilled.notify_one();
+                continue;
+            }
 
+            // Store the envelope in the envelope cache.
+            try {
+                std::lock_guard<std::mutex> lck(m_indexMutex);
+                const std::size_t ENTRY{m_nextEntryToReadFromRecFile % m_envelopeCache.size()};
+                m_envelopeCache[ENTRY]      = std::move(retVal.second);
+                m_envelopeCacheBytes[ENTRY] = static_cast<uint32_t>(sizeof(cluon::data::Envelope) + bytesInRecFile);
+                m_cacheStatistics.m_bytesInCache += m_envelopeCacheBytes[ENTRY];
                 m_nextEntryToReadFromRecFile++;
-                entriesReadFromFile++;
-            }
+            } catch (...) {} // LCOV_EXCL_LINE
+            m_envelopeCacheFilled.notify_one();
+
+            entriesReadFromFile++;
         }
     }
 
@@ -201,7 +335,7 @@ std::pair<bool, cluon::data::Envelope> Player::getNextEnvelopeToBeReplayed() noe
     cluon::data::Envelope envelopeToReturn;
 
     // If at "EOF", either throw exception or autorewind.
-    if (m_currentEnvelopeToReplay == m_index.end()) {
+    if (m_currentEnvelopeToReplay == m_indexSampleTimeStamps.size()) {
         if (!m_autoRewind) {
             return std::make_pair(hasEnvelopeToReturn, envelopeToReturn);
         } else {
@@ -209,67 +343,91 @@ std::pair<bool, cluon::data::Envelope> Player::getNextEnvelopeToBeReplayed() noe
         }
     }
 
-    if (m_currentEnvelopeToReplay != m_index.end()) {
-        checkAvailabilityOfNextEnvelopeToBeReplayed();
-
+    while ((m_currentEnvelopeToReplay != m_indexSampleTimeStamps.size()) && checkAvailabilityOfNextEnvelopeToBeReplayed()) {
         try {
+            bool isRefillingCacheNeededNow{false};
+            uint64_t readAheadInBytes{0};
             {
                 std::lock_guard<std::mutex> lck(m_indexMutex);
 
-                cluon::data::Envelope &nextEnvelope = m_envelopeCache[m_currentEnvelopeToReplay->second.m_filePosition];
-                envelopeToReturn                    = nextEnvelope;
-
-                m_delay = static_cast<uint32_t>(m_currentEnvelopeToReplay->first - m_previousEnvelopeAlreadyReplayed->first);
-
-                // TODO: Delegate deleting into own thread.
-                if (m_previousPreviousEnvelopeAlreadyReplayed != m_index.end()) {
-                    auto it = m_envelopeCache.find(m_previousEnvelopeAlreadyReplayed->second.m_filePosition);
-                    if (it != m_envelopeCache.end()) {
-                        m_envelopeCache.erase(it);
-                    }
+                // The entry in the cache is not needed anymore after returning it.
+                const std::size_t ENTRY{m_currentEnvelopeToReplay % m_envelopeCache.size()};
+                if (0 == m_envelopeCacheBytes[ENTRY]) {
+                    // Skipped entry: Continue with the next one.
+                    m_currentEnvelopeToReplay++;
+                    continue;
                 }
+                envelopeToReturn = std::move(m_envelopeCache[ENTRY]);
+                m_cacheStatistics.m_bytesInCache -= m_envelopeCacheBytes[ENTRY];
+                m_bytesReplayedInTotal += m_envelopeCacheBytes[ENTRY];
+
+                m_delay = static_cast<uint32_t>(m_indexSampleTimeStamps[m_currentEnvelopeToReplay] - m_indexSampleTimeStamps[m_previousEnvelopeAlreadyReplayed]);
 
-                m_previousPreviousEnvelopeAlreadyReplayed = m_previousEnvelopeAlreadyReplayed;
-                m_previousEnvelopeAlreadyReplayed         = m_currentEnvelopeToReplay++;
+                m_previousEnvelopeAlreadyReplayed = m_currentEnvelopeToReplay++;
 
                 m_numberOfReturnedEnvelopesInTotal++;
+
+                isRefillingCacheNeededNow = isRefillingCacheNeeded();
+                readAheadInBytes          = m_cacheStatistics.m_readAheadInBytes;
             }
 
             // TODO compensate for internal data processing.
 
-            // If Player is non-threaded, read next entry sequentially.
             if (!m_threading) {
-                fillEnvelopeCache(1);
+                // If Player is non-threaded, read next entry sequentially.
+                fillEnvelopeCache(1, readAheadInBytes);
+            } else if (isRefillingCacheNeededNow) {
+                m_envelopeCacheConsumed.notify_one();
             }
 
             // Store sample time stamp as int64 to avoid unnecessary copying of Envelopes.
             hasEnvelopeToReturn = true;
         } catch (...) {} // LCOV_EXCL_LINE
+        break;
     }
     return std::make_pair(hasEnvelopeToReturn, envelopeToReturn);
 }
 
-void Player::checkAvailabilityOfNextEnvelopeToBeReplayed() noexcept {
-    uint64_t numberOfEntries = 0;
-    do {
-        {
-            try {
-                std::lock_guard<std::mutex> lck(m_indexMutex);
-                numberOfEntries = m_envelopeCache.size();
-            } catch (...) {} // LCOV_EXCL_LINE
+bool Player::checkAvailabilityOfNextEnvelopeToBeReplayed() noexcept {
+    bool isAvailable{false};
+    try {
+        std::unique_lock<std::mutex> lck(m_indexMutex);
+        if (0 < numberOfEntriesInCache()) {
+            m_cacheStatistics.m_numberOfHits++;
+            return true;
         }
-        if (0 == numberOfEntries) {
-            using namespace std::chrono_literals; // LCOV_EXCL_LINE
-            std::this_thread::sleep_for(10ms);    // LCOV_EXCL_LINE
+        m_cacheStatistics.m_numberOfMisses++;
+
+        const auto BEFORE{std::chrono::steady_clock::now()};
+        if (!m_threading) {
+            // Read the next entry in this thread.
+            lck.unlock();
+            fillEnvelopeCache(1, std::numeric_limits<uint64_t>::max());
+            lck.lock();
+            isAvailable = (0 < numberOfEntriesInCache());
+        } else {
+            // Wake up the thread filling the cache and wait for the next entry.
+            m_envelopeCacheConsumed.notify_one();
+            while (!isAvailable) {
+                using namespace std::chrono_literals;
+                isAvailable = m_envelopeCacheFilled.wait_for(lck, 100ms, [this]() { return 0 < numberOfEntriesInCache(); });
+            }
         }
-    } while (0 == numberOfEntries);
+        m_cacheStatistics.m_stallTime += std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - BEFORE);
+    } catch (...) {} // LCOV_EXCL_LINE
+    return isAvailable;
 }
 
 ////////////////////////////////////////////////////////////////////////
 
 uint32_t Player::totalNumberOfEnvelopesInRecFile() const noexcept {
     std::lock_guard<std::mutex> lck(m_indexMutex);
-    return static_cast<uint32_t>(m_index.size());
+    return static_cast<uint32_t>(m_indexSampleTimeStamps.size());
+}
+
+Player::CacheStatistics Player::cacheStatistics() const noexcept {
+    std::lock_guard<std::mutex> lck(m_indexMutex);
+    return m_cacheStatistics;
 }
 
 uint32_t Player::delay() const noexcept {
@@ -312,24 +470,29 @@ void Player::seekTo(float ratio) noexcept {
         uint32_t numberOfEntriesInIndex = 0;
         try {
             std::lock_guard<std::mutex> lck(m_indexMutex);
-            numberOfEntriesInIndex = static_cast<uint32_t>(m_index.size());
+            numberOfEntriesInIndex = static_cast<uint32_t>(m_indexSampleTimeStamps.size());
         } catch (...) {} // LCOV_EXCL_LINE
 
         // Fast forward.
         m_numberOfReturnedEnvelopesInTotal = 0;
         std::clog << "[cluon::Player]: Seeking to " << static_cast<float>(numberOfEntriesInIndex) * ratio << "/" << numberOfEntriesInIndex << std::endl;
         if (0 < ratio) {
-            for (m_numberOfReturnedEnvelopesInTotal = 0;
-                 m_numberOfReturnedEnvelopesInTotal < static_cast<uint32_t>(static_cast<float>(numberOfEntriesInIndex) * ratio) - 1;
-                 m_numberOfReturnedEnvelopesInTotal++) {
-                m_currentEnvelopeToReplay++;
-            }
+            const uint32_t ENTRY{static_cast<uint32_t>(static_cast<float>(numberOfEntriesInIndex) * ratio)};
+            m_numberOfReturnedEnvelopesInTotal = (0 < ENTRY) ? ENTRY - 1 : 0;
         }
-        m_nextEntryToReadFromRecFile = m_previousEnvelopeAlreadyReplayed = m_currentEnvelopeToReplay;
+        try {
+            std::lock_guard<std::mutex> lck(m_indexMutex);
+            m_nextEntryToReadFromRecFile = m_previousEnvelopeAlreadyReplayed = m_currentEnvelopeToReplay
+                = static_cast<std::size_t>(m_numberOfReturnedEnvelopesInTotal);
+        } catch (...) {} // LCOV_EXCL_LINE
 
         // Refill cache.
-        m_envelopeCache.clear();
-        fillEnvelopeCache(static_cast<uint32_t>(static_cast<float>(m_desiredInitialLevel) * .3f));
+        uint64_t readAheadInBytes{0};
+        try {
+            std::lock_guard<std::mutex> lck(m_indexMutex);
+            readAheadInBytes = m_cacheStatistics.m_readAheadInBytes;
+        } catch (...) {} // LCOV_EXCL_LINE
+        fillEnvelopeCache(std::numeric_limits<uint32_t>::max(), static_cast<uint64_t>(static_cast<float>(readAheadInBytes) * .3f));
 
         // Correct iterators if not at the beginning.
         if ((0 < ratio) && (ratio < 1)) {
@@ -355,14 +518,18 @@ bool Player::hasMoreDataFromRecFile() const noexcept {
     // File must be successfully opened AND
     //  the Player must be configured as m_autoRewind OR
     //  some entries are left to replay.
-    return (m_recFileValid && (m_autoRewind || (m_currentEnvelopeToReplay != m_index.end())));
+    return (m_recFileValid && (m_autoRewind || (m_currentEnvelopeToReplay != m_indexSampleTimeStamps.size())));
 }
 
 ////////////////////////////////////////////////////////////////////////
 
 void Player::setEnvelopeCacheFillingRunning(const bool &running) noexcept {
-    std::lock_guard<std::mutex> lck(m_envelopeCacheFillingThreadIsRunningMutex);
-    m_envelopeCacheFillingThreadIsRunning = running;
+    {
+        std::lock_guard<std::mutex> lck(m_envelopeCacheFillingThreadIsRunningMutex);
+        m_envelopeCacheFillingThreadIsRunning = running;
+    }
+    // Wake up the thread filling the cache to check its state.
+    m_envelopeCacheConsumed.notify_all();
 }
 
 bool Player::isEnvelopeCacheFillingRunning() const noexcept {
@@ -371,33 +538,57 @@ bool Player::isEnvelopeCacheFillingRunning() const noexcept {
 }
 
 void Player::manageCache() noexcept {
-    uint8_t statisticsCounter = 0;
-    float refillMultiplicator = 1.1f;
-    uint32_t numberOfEntries  = 0;
+    auto lastStatistics{std::chrono::steady_clock::now()};
+    auto lastMeasurement{lastStatistics};
+    uint64_t bytesReplayedInTotalAtLastMeasurement{0};
+    try {
+        std::lock_guard<std::mutex> lck(m_indexMutex);
+        bytesReplayedInTotalAtLastMeasurement = m_bytesReplayedInTotal;
+    } catch (...) {} // LCOV_EXCL_LINE
 
     while (isEnvelopeCacheFillingRunning()) {
+        bool isRefillingCacheNeededNow{false};
+        uint64_t bytesInCache{0};
+        uint64_t readAheadInBytes{0};
         try {
-            std::lock_guard<std::mutex> lck(m_indexMutex);
-            numberOfEntries = static_cast<uint32_t>(m_envelopeCache.size());
+            // Wait until the replay has consumed half of the read-ahead bytes but wake up at 10 Hz to publish statistics.
+            using namespace std::chrono_literals;
+            std::unique_lock<std::mutex> lck(m_indexMutex);
+            isRefillingCacheNeededNow = m_envelopeCacheConsumed.wait_for(lck, 100ms, [this]() { return isRefillingCacheNeeded(); });
+
+            // Adapt the read-ahead bytes to the consumption measured once per second.
+            const auto NOW{std::chrono::steady_clock::now()};
+            const double ELAPSED_IN_S{std::chrono::duration<double>(NOW - lastMeasurement).count()};
+            if (1.0 <= ELAPSED_IN_S) {
+                const double CONSUMED_BYTES_PER_SECOND{static_cast<double>(m_bytesReplayedInTotal - bytesReplayedInTotalAtLastMeasurement) / ELAPSED_IN_S};
+                m_cacheStatistics.m_consumedBytesPerSecond = .5 * m_cacheStatistics.m_consumedBytesPerSecond + .5 * CONSUMED_BYTES_PER_SECOND;
+                m_cacheStatistics.m_readAheadInBytes       = static_cast<uint64_t>(std::min<double>(
+                    std::max<double>(m_cacheStatistics.m_consumedBytesPerSecond * READ_AHEAD_IN_S, MIN_READ_AHEAD_IN_BYTES), MAX_READ_AHEAD_IN_BYTES));
+                lastMeasurement                       = NOW;
+                bytesReplayedInTotalAtLastMeasurement = m_bytesReplayedInTotal;
+            }
+            bytesInCache     = m_cacheStatistics.m_bytesInCache;
+            readAheadInBytes = m_cacheStatistics.m_readAheadInBytes;
         } catch (...) {} // LCOV_EXCL_LINE
 
         // Check if refilling of the cache is needed.
-        refillMultiplicator = checkRefillingCache(numberOfEntries, refillMultiplicator);
-        (void)refillMultiplicator;
-
-        // Manage cache at 10 Hz.
-        using namespace std::chrono_literals;
-        std::this_thread::sleep_for(100ms);
+        if (isRefillingCacheNeededNow) {
+            const uint32_t entriesReadFromFile = fillEnvelopeCache(std::numeric_limits<uint32_t>::max(), readAheadInBytes);
+            if (entriesReadFromFile > 0) {
+                std::clog << "[cluon::Player]: Bytes in cache: " << bytesInCache << ". " << entriesReadFromFile << " entries added to cache to read ahead "
+                          << readAheadInBytes << " bytes." << std::endl;
+            }
+        }
 
         // Publish some statistics at 1 Hz.
-        if (0 == ((++statisticsCounter) % 10)) {
+        if (std::chrono::seconds(1) <= std::chrono::steady_clock::now() - lastStatistics) {
             uint64_t numberOfReturnedEnvelopesInTotal = 0;
             uint32_t totalNumberOfEnvelopes           = 0;
             try {
                 // m_numberOfReturnedEnvelopesInTotal is modified in a different thread.
                 std::lock_guard<std::mutex> lck(m_indexMutex);
                 numberOfReturnedEnvelopesInTotal = m_numberOfReturnedEnvelopesInTotal;
-                totalNumberOfEnvelopes           = static_cast<uint32_t>(m_index.size());
+                totalNumberOfEnvelopes           = static_cast<uint32_t>(m_indexSampleTimeStamps.size());
             } catch (...) {} // LCOV_EXCL_LINE
 
             try {
@@ -411,22 +602,9 @@ void Player::manageCache() noexcept {
                 }
             } catch (...) {} // LCOV_EXCL_LINE
 
-            statisticsCounter = 0;
-        }
-    }
-}
-
-float Player::checkRefillingCache(const uint32_t &numberOfEntries, float refillMultiplicator) noexcept {
-    // If filling level is around 35%, pour in more from the recording.
-    if (numberOfEntries < 0.35 * m_desiredInitialLevel) {
-        const uint32_t entriesReadFromFile = fillEnvelopeCache(static_cast<uint32_t>(refillMultiplicator * static_cast<float>(m_desiredInitialLevel)));
-        if (entriesReadFromFile > 0) {
-            std::clog << "[cluon::Player]: Number of entries in cache: " << numberOfEntries << ". " << entriesReadFromFile << " added to cache. "
-                      << m_envelopeCache.size() << " entries available." << std::endl;
-            refillMultiplicator *= 1.25f;
+            lastStatistics = std::chrono::steady_clock::now();
         }
     }
-    return refillMultiplicator;
 }
 
 } // namespace cluon
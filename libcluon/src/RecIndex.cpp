@@ -0,0 +1,343 @@
+/*
+ * Copyright (C) 2017-2018  Christian Berger
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "cluon/RecIndex.hpp"
+#include "cluon/EnvelopeReader.hpp"
+#include "cluon/EnvelopeView.hpp"
+#include "cluon/Time.hpp"
+
+#include <sys/stat.h>
+#include <sys/types.h>
+
+#include <algorithm>
+#include <array>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <thread>
+
+namespace cluon {
+
+// Written as first bytes of an index to detect a different byte order.
+static constexpr uint32_t RECINDEX_BYTE_ORDER{0x01020304};
+static constexpr uint32_t RECINDEX_VERSION{2};
+// Number of bytes at the beginning and at the end of a .rec file to compute its checksum.
+static constexpr std::size_t RECINDEX_CHECKSUM_BYTES{64 * 1024};
+// Minimum number of bytes of a .rec file to be scanned by one thread.
+static constexpr std::size_t RECINDEX_MIN_CHUNK_SIZE{4 * 1024 * 1024};
+
+/**
+ * This class describes the 64 bytes in front of the entries of an index.
+ */
+class RecIndexHeader {
+   public:
+    std::array<char, 8> m_magic{{'C', 'L', 'U', 'O', 'N', 'I', 'D', 'X'}};
+    uint32_t m_byteOrder{RECINDEX_BYTE_ORDER};
+    uint32_t m_version{RECINDEX_VERSION};
+    uint64_t m_recFileSize{0};
+    int64_t m_recFileModificationTime{0}; // Nanoseconds where available.
+    uint64_t m_recFileChecksum{0};
+    uint64_t m_numberOfEntries{0};
+    std::array<uint64_t, 2> m_reserved{{0, 0}};
+};
+
+static_assert(64 == sizeof(RecIndexHeader), "Unexpected size of RecIndexHeader.");
+static_assert(24 == sizeof(RecIndexEntry), "Unexpected size of RecIndexEntry.");
+
+// Determines size, modification time, and checksum of the given .rec file.
+static bool fingerprintOf(const std::string &recFile, RecIndexHeader &header) noexcept {
+    bool retVal{false};
+    try {
+#ifdef WIN32
+        struct _stat64 fileStatus;
+        const bool STATUS_AVAILABLE{0 == ::_stat64(recFile.c_str(), &fileStatus)};
+#else
+        struct stat fileStatus;
+        const bool STATUS_AVAILABLE{0 == ::stat(recFile.c_str(), &fileStatus)};
+#endif
+        std::ifstream in(recFile, std::ios::in | std::ios::binary);
+        if (STATUS_AVAILABLE && in.good()) {
+            header.m_recFileSize             = static_cast<uint64_t>(fileStatus.st_size);
+#if defined(WIN32)
+            header.m_recFileModificationTime = static_cast<int64_t>(fileStatus.st_mtime) * 1000 * 1000 * 1000;
+#elif defined(__APPLE__)
+            header.m_recFileModificationTime
+                = static_cast<int64_t>(fileStatus.st_mtimespec.tv_sec) * 1000 * 1000 * 1000 + static_cast<int64_t>(fileStatus.st_mtimespec.tv_nsec);
+#else
+            header.m_recFileModificationTime
+                = static_cast<int64_t>(fileStatus.st_mtim.tv_sec) * 1000 * 1000 * 1000 + static_cast<int64_t>(fileStatus.st_mtim.tv_nsec);
+#endif
+
+            // FNV-1a over the first and the last bytes: Reading the complete
+            // .rec file would take as long as scanning it.
+            const std::size_t BYTES_TO_READ{static_cast<std::size_t>(std::min<uint64_t>(header.m_recFileSize, RECINDEX_CHECKSUM_BYTES))};
+            std::vector<char> buffer(BYTES_TO_READ);
+            uint64_t checksum{0xcbf29ce484222325ull};
+            retVal = true;
+            for (uint64_t position : {static_cast<uint64_t>(0), header.m_recFileSize - BYTES_TO_READ}) {
+                in.seekg(static_cast<std::streamoff>(position));
+                in.read(buffer.data(), static_cast<std::streamsize>(BYTES_TO_READ));
+                retVal &= (static_cast<std::streamsize>(BYTES_TO_READ) == in.gcount());
+                for (char c : buffer) {
+                    checksum ^= static_cast<uint8_t>(c);
+                    checksum *= 0x100000001b3ull;
+                }
+            }
+            header.m_recFileChecksum = checksum;
+        }
+    } catch (...) { retVal = false; } // LCOV_EXCL_LINE
+    return retVal;
+}
+
+/**
+ * This class describes the result of scanning the Envelopes that start in
+ * [m_begin, m_end) of a .rec file.
+ */
+class RecIndexChunk {
+   public:
+    uint64_t m_begin{0};
+    uint64_t m_end{0};
+    // Position of the first Envelope found by the scan; it is behind m_begin when the scan needed to resynchronize.
+    uint64_t m_firstPosition{std::numeric_limits<uint64_t>::max()};
+    // Position of the first Envelope at or behind m_end.
+    uint64_t m_nextPosition{0};
+    uint64_t m_numberOfEnvelopeBytes{0};
+    std::vector<RecIndexEntry> m_entries{};
+};
+
+static bool isEarlier(const RecIndexEntry &a, const RecIndexEntry &b) noexcept {
+    return a.m_sampleTimeStamp < b.m_sampleTimeStamp;
+}
+
+// Appends the entry for the given Envelope if it is well-formed; only the sampleTimeStamp is decoded.
+static void appendEntry(const cluon::EnvelopeFrame &frame, uint64_t position, std::vector<RecIndexEntry> &entries) {
+    const cluon::EnvelopeView VIEW{cluon::viewEnvelope(frame.m_data, frame.m_size)};
+    if (VIEW.valid()) {
+        RecIndexEntry entry;
+        entry.m_sampleTimeStamp = cluon::time::toMicroseconds(VIEW.sampleTimeStamp());
+        entry.m_filePosition    = position;
+        entry.m_dataType        = VIEW.dataType();
+        entry.m_senderStamp     = VIEW.senderStamp();
+        entries.push_back(entry);
+    }
+}
+
+// Scans the Envelopes in the given chunk starting at the given position.
+static void scanChunk(const char *data, std::size_t size, uint64_t from, RecIndexChunk &chunk) noexcept {
+    chunk.m_firstPosition         = size;
+    chunk.m_nextPosition          = size;
+    chunk.m_numberOfEnvelopeBytes = 0;
+    chunk.m_entries.clear();
+    try {
+        // The reader may pass m_end to complete the last Envelope of this chunk.
+        cluon::EnvelopeReader reader{data + from, static_cast<std::size_t>(size - from)};
+        cluon::EnvelopeFrame frame;
+        bool isFirst{true};
+        while (reader.next(frame)) {
+            const uint64_t POSITION{from + frame.m_position};
+            if (isFirst) {
+                chunk.m_firstPosition = POSITION;
+                isFirst               = false;
+            }
+            if (chunk.m_end <= POSITION) {
+                chunk.m_nextPosition = POSITION;
+                break;
+            }
+            chunk.m_numberOfEnvelopeBytes += frame.m_size;
+            appendEntry(frame, POSITION, chunk.m_entries);
+        }
+        std::stable_sort(chunk.m_entries.begin(), chunk.m_entries.end(), isEarlier);
+    } catch (...) { chunk.m_firstPosition = std::numeric_limits<uint64_t>::max(); } // LCOV_EXCL_LINE
+}
+
+bool RecIndex::scan(const char *data, std::size_t size, uint32_t numberOfThreads, std::vector<RecIndexEntry> &entries, uint64_t &numberOfSkippedBytes) noexcept {
+    entries.clear();
+    numberOfSkippedBytes = size;
+    if (nullptr == data) {
+        return (0 == size);
+    }
+
+    bool retVal{false};
+    try {
+        const std::size_t NUMBER_OF_CHUNKS{
+            std::max<std::size_t>(1, std::min<std::size_t>(std::max<uint32_t>(numberOfThreads, 1), size / RECINDEX_MIN_CHUNK_SIZE))};
+        std::vector<RecIndexChunk> chunks(NUMBER_OF_CHUNKS);
+        for (std::size_t i{0}; i < NUMBER_OF_CHUNKS; i++) {
+            chunks[i].m_begin = (size / NUMBER_OF_CHUNKS) * i;
+            chunks[i].m_end   = (NUMBER_OF_CHUNKS == i + 1) ? size : (size / NUMBER_OF_CHUNKS) * (i + 1);
+        }
+
+        // Scan the first chunk in this thread and all others concurrently.
+        std::vector<std::thread> threads;
+        try {
+            for (std::size_t i{1}; i < NUMBER_OF_CHUNKS; i++) {
+                RecIndexChunk &chunk{chunks[i]};
+                threads.emplace_back([data, size, &chunk]() noexcept { scanChunk(data, size, chunk.m_begin, chunk); });
+            }
+        } catch (...) {} // LCOV_EXCL_LINE
+        scanChunk(data, size, 0, chunks[0]);
+        for (auto &t : threads) {
+            t.join();
+        }
+
+        // A chunk is only valid when it started with the Envelope where its
+        // predecessor stopped; otherwise, the scan has synchronized on bytes
+        // inside an Envelope (or a thread could not be started) and the chunk
+        // is scanned again from that Envelope.
+        uint64_t numberOfEnvelopeBytes{0};
+        std::size_t numberOfEntries{0};
+        for (std::size_t i{0}; i < NUMBER_OF_CHUNKS; i++) {
+            if ((0 < i) && (chunks[i].m_firstPosition != chunks[i - 1].m_nextPosition)) {
+                scanChunk(data, size, chunks[i - 1].m_nextPosition, chunks[i]);
+            }
+            if (std::numeric_limits<uint64_t>::max() == chunks[i].m_firstPosition) {
+                return false; // LCOV_EXCL_LINE
+            }
+            numberOfEnvelopeBytes += chunks[i].m_numberOfEnvelopeBytes;
+            numberOfEntries += chunks[i].m_entries.size();
+        }
+
+        // Merge the sorted chunks pairwise; std::inplace_merge keeps the entries
+        // of earlier chunks first for equal sample time stamps.
+        entries.reserve(numberOfEntries);
+        std::vector<std::size_t> bounds{0};
+        for (auto &chunk : chunks) {
+            entries.insert(entries.end(), chunk.m_entries.begin(), chunk.m_entries.end());
+            bounds.push_back(entries.size());
+            std::vector<RecIndexEntry>().swap(chunk.m_entries);
+        }
+        for (std::size_t width{1}; width < NUMBER_OF_CHUNKS; width *= 2) {
+            for (std::size_t i{0}; i + width < NUMBER_OF_CHUNKS; i += 2 * width) {
+                std::inplace_merge(entries.begin() + static_cast<std::ptrdiff_t>(bounds[i]),
+                                   entries.begin() + static_cast<std::ptrdiff_t>(bounds[i + width]),
+                                   entries.begin() + static_cast<std::ptrdiff_t>(bounds[std::min(i + 2 * width, NUMBER_OF_CHUNKS)]),
+                                   isEarlier);
+            }
+        }
+        numberOfSkippedBytes = size - numberOfEnvelopeBytes;
+        retVal               = true;
+    } catch (...) { entries.clear(); } // LCOV_EXCL_LINE
+    return retVal;
+}
+
+bool RecIndex::scan(std::istream &in,
+                    std::vector<RecIndexEntry> &entries,
+                    uint64_t &numberOfSkippedBytes,
+                    std::function<void(uint64_t position)> progress) noexcept {
+    entries.clear();
+    numberOfSkippedBytes = 0;
+
+    bool retVal{false};
+    try {
+        cluon::EnvelopeReader reader{in};
+        cluon::EnvelopeFrame frame;
+        while (reader.next(frame)) {
+            appendEntry(frame, frame.m_position, entries);
+            if (nullptr != progress) {
+                progress(frame.m_position + frame.m_size);
+            }
+        }
+        std::stable_sort(entries.begin(), entries.end(), isEarlier);
+        numberOfSkippedBytes = reader.numberOfSkippedBytes();
+        retVal               = true;
+    } catch (...) { entries.clear(); } // LCOV_EXCL_LINE
+    return retVal;
+}
+
+std::string RecIndex::filename(const std::string &recFile) noexcept {
+    return recFile + ".idx";
+}
+
+bool RecIndex::load(const std::string &recFile) noexcept {
+    m_file.reset();
+
+    RecIndexHeader expected;
+    if (!fingerprintOf(recFile, expected)) {
+        return false;
+    }
+
+    bool retVal{false};
+    try {
+        m_file.reset(new MemoryMappedFile(filename(recFile)));
+        if (m_file->isMapped() && (sizeof(RecIndexHeader) <= m_file->size())) {
+            RecIndexHeader header;
+            std::memcpy(&header, m_file->data(), sizeof(RecIndexHeader));
+            retVal = (expected.m_magic == header.m_magic) && (expected.m_byteOrder == header.m_byteOrder) && (expected.m_version == header.m_version)
+                     && (expected.m_recFileSize == header.m_recFileSize) && (expected.m_recFileModificationTime == header.m_recFileModificationTime)
+                     && (expected.m_recFileChecksum == header.m_recFileChecksum)
+                     && ((m_file->size() - sizeof(RecIndexHeader)) == header.m_numberOfEntries * sizeof(RecIndexEntry));
+        }
+    } catch (...) {} // LCOV_EXCL_LINE
+    if (!retVal) {
+        m_file.reset();
+    }
+    return retVal;
+}
+
+const RecIndexEntry *RecIndex::entries() const noexcept {
+    return m_file ? reinterpret_cast<const RecIndexEntry *>(m_file->data() + sizeof(RecIndexHeader)) : nullptr;
+}
+
+std::size_t RecIndex::size() const noexcept {
+    return m_file ? (m_file->size() - sizeof(RecIndexHeader)) / sizeof(RecIndexEntry) : 0;
+}
+
+bool RecIndex::write(const std::string &recFile, uint64_t recFileSize, std::vector<RecIndexEntry> &entries) noexcept {
+    bool retVal{false};
+    try {
+        RecIndexHeader header;
+        if (fingerprintOf(recFile, header) && (recFileSize == header.m_recFileSize)) {
+            std::stable_sort(entries.begin(), entries.end(), [](const RecIndexEntry &a, const RecIndexEntry &b) {
+                return a.m_sampleTimeStamp < b.m_sampleTimeStamp;
+            });
+            header.m_numberOfEntries = entries.size();
+
+            // Write to a temporary file first to never leave a partial index behind.
+            const std::string INDEX{filename(recFile)};
+            const std::string TMP{INDEX + ".tmp"};
+            {
+                std::ofstream out(TMP, std::ios::out | std::ios::binary | std::ios::trunc);
+                out.write(reinterpret_cast<const char *>(&header), sizeof(RecIndexHeader));
+                out.write(reinterpret_cast<const char *>(entries.data()), static_cast<std::streamsize>(entries.size() * sizeof(RecIndexEntry)));
+                out.close();
+                retVal = !out.fail();
+            }
+#ifdef WIN32
+            std::remove(INDEX.c_str());
+#endif
+            retVal = retVal && (0 == std::rename(TMP.c_str(), INDEX.c_str()));
+            if (!retVal) {
+                std::remove(TMP.c_str());
+            }
+        }
+    } catch (...) { retVal = false; } // LCOV_EXCL_LINE
+    return retVal;
+}
+
+bool RecIndex::create(const std::string &recFile) noexcept {
+    bool retVal{false};
+    try {
+        std::vector<RecIndexEntry> entries;
+        MemoryMappedFile file{recFile};
+        if (file.isMapped()) {
+            uint64_t numberOfSkippedBytes{0};
+            retVal = scan(file.data(), file.size(), std::thread::hardware_concurrency(), entries, numberOfSkippedBytes)
+                     && write(recFile, file.size(), entries);
+        } else {
+            // Empty or non-mappable .rec file.
+            RecIndexHeader header;
+            std::ifstream in(recFile, std::ios::in | std::ios::binary);
+            uint64_t numberOfSkippedBytes{0};
+            retVal = in.good() && fingerprintOf(recFile, header) && scan(in, entries, numberOfSkippedBytes)
+                     && write(recFile, header.m_recFileSize, entries);
+        }
+    } catch (...) { retVal = false; } // LCOV_EXCL_LINE
+    return retVal;
+}
+} // namespace cluon
@@ -33,19 +33,21 @@
 
 namespace cluon {
 
-TCPConnection::TCPConnection(const int32_t &socket) noexcept
+TCPConnection::TCPConnection(const int32_t &socket, std::shared_ptr<cluon::IOReactor> reactor) noexcept
     : m_socket(socket)
     , m_newDataDelegate(nullptr)
     , m_connectionLostDelegate(nullptr) {
     if (!(m_socket < 0)) {
-        startReadingFromSocket();
+        startReadingFromSocket(reactor, NotifyingPipelineType::DEQUE);
     }
 }
 
 TCPConnection::TCPConnection(const std::string &address,
                              uint16_t port,
                              std::function<void(std::string &&, std::chrono::system_clock::time_point &&)> newDataDelegate,
-                             std::function<void()> connectionLostDelegate) noexcept
+                             std::function<void()> connectionLostDelegate,
+                             std::shared_ptr<cluon::IOReactor> reactor,
+                             NotifyingPipelineType pipelineType) noexcept
     : m_newDataDelegate(std::move(newDataDelegate))
     , m_connectionLostDelegate(std::move(connectionLostDelegate)) {
     // Decompose given address string to check validity with numerical IPv4 address.
@@ -91,7 +93,7 @@ TCPConnection::TCPConnection(const std::string &address,
 #endif                                      // LCOV_EXCL_LINE
                     closeSocket(errorCode); // LCOV_EXCL_LINE
                 } else {
-                    startReadingFromSocket();
+                    startReadingFromSocket(reactor, pipelineType);
                 }
             }
         }
@@ -99,16 +101,17 @@ TCPConnection::TCPConnection(const std::string &address,
 }
 
 TCPConnection::~TCPConnection() noexcept {
-    {
-        m_readFromSocketThreadRunning.store(false);
-
-        // Joining the thread could fail.
-        try {
-            if (m_readFromSocketThread.joinable()) {
-                m_readFromSocketThread.join();
-            }
-        } catch (...) {} // LCOV_EXCL_LINE
+    m_readFromSocketRunning.store(false);
+
+    // Stop reading before the socket is closed; the IOReactor wakes up its thread immediately.
+    if (m_reactor) {
+        m_reactor->removeSocket(m_socket);
+        // Drop pending data that was not delivered yet when using a shared IOReactor.
+        if (0 != m_dispatchQueue) {
+            m_reactor->removeDispatchQueue(m_dispatchQueue);
+        }
     }
+    m_reactor.reset();
 
     m_pipeline.reset();
 
@@ -138,32 +141,61 @@ void TCPConnection::closeSocket(int errorCode) noexcept {
     m_socket = -1;
 }
 
-void TCPConnection::startReadingFromSocket() noexcept {
-    // Constructing a thread could fail.
-    try {
-        m_readFromSocketThread = std::thread(&TCPConnection::readFromSocket, this);
+void TCPConnection::startReadingFromSocket(std::shared_ptr<cluon::IOReactor> reactor, NotifyingPipelineType pipelineType) noexcept {
+    if (nullptr != reactor) {
+        // Received data is handed over to the shared IOReactor's dispatch threads.
+        m_reactor       = reactor;
+        m_dispatchQueue = m_reactor->createDispatchQueue();
+    } else {
+        // The pipeline must be available before the first bytes are read.
+        try {
+            m_pipeline = std::make_shared<cluon::NotifyingPipeline<PipelineEntry>>(
+                [this](PipelineEntry &&entry) { this->m_newDataDelegate(std::move(entry.m_data), std::move(entry.m_sampleTime)); }, pipelineType);
+        } catch (...) { closeSocket(ECHILD); } // LCOV_EXCL_LINE
+    }
 
-        // Let the operating system spawn the thread.
-        using namespace std::literals::chrono_literals;
-        do { std::this_thread::sleep_for(1ms); } while (!m_readFromSocketThreadRunning.load());
-    } catch (...) {          // LCOV_EXCL_LINE
-        closeSocket(ECHILD); // LCOV_EXCL_LINE
+    if (!(m_socket < 0)) {
+        // Constructing the IOReactor could fail.
+        try {
+            if (!m_reactor) {
+                m_reactor = std::make_shared<cluon::IOReactor>();
+            }
+            m_readFromSocketRunning.store(m_reactor->isRunning());
+        } catch (...) {} // LCOV_EXCL_LINE
+        if (!m_readFromSocketRunning.load()) {
+            closeSocket(ECHILD); // LCOV_EXCL_LINE
+        }
     }
 
-    try {
-        m_pipeline = std::make_shared<cluon::NotifyingPipeline<PipelineEntry>>(
-            [this](PipelineEntry &&entry) { this->m_newDataDelegate(std::move(entry.m_data), std::move(entry.m_sampleTime)); });
-        if (m_pipeline) {
-            // Let the operating system spawn the thread.
-            using namespace std::literals::chrono_literals; // NOLINT
-            do { std::this_thread::sleep_for(1ms); } while (!m_pipeline->isRunning());
+    bool hasNewDataDelegate{false};
+    {
+        std::lock_guard<std::mutex> lck(m_newDataDelegateMutex);
+        hasNewDataDelegate = (nullptr != m_newDataDelegate);
+    }
+    if (hasNewDataDelegate) {
+        registerSocket();
+    }
+}
+
+void TCPConnection::registerSocket() noexcept {
+    // Only register once; the socket is not read until a newDataDelegate is set.
+    if (m_readFromSocketRunning.load() && m_reactor && !m_isSocketRegistered.exchange(true)) {
+        if (!m_reactor->addSocket(m_socket, [this]() { this->readFromSocket(); })) {
+            m_isSocketRegistered.store(false); // LCOV_EXCL_LINE
         }
-    } catch (...) { closeSocket(ECHILD); } // LCOV_EXCL_LINE
+    }
 }
 
 void TCPConnection::setOnNewData(std::function<void(std::string &&, std::chrono::system_clock::time_point &&)> newDataDelegate) noexcept {
-    std::lock_guard<std::mutex> lck(m_newDataDelegateMutex);
-    m_newDataDelegate = newDataDelegate;
+    const bool hasNewDataDelegate{nullptr != newDataDelegate};
+    {
+        std::lock_guard<std::mutex> lck(m_newDataDelegateMutex);
+        m_newDataDelegate = newDataDelegate;
+    }
+    // Register outside of the mutex as the IOReactor's thread acquires it while reading.
+    if (hasNewDataDelegate) {
+        registerSocket();
+    }
 }
 
 void TCPConnection::setOnConnectionLost(std::function<void()> connectionLostDelegate) noexcept {
@@ -172,7 +204,7 @@ void TCPConnection::setOnConnectionLost(std::function<void()> connectionLostDele
 }
 
 bool TCPConnection::isRunning() const noexcept {
-    return (m_readFromSocketThreadRunning.load() && !TerminateHandler::instance().isTerminated.load());
+    return (m_readFromSocketRunning.load() && !TerminateHandler::instance().isTerminated.load());
 }
 
 std::pair<ssize_t, int32_t> TCPConnection::send(std::string &&data) const noexcept {
@@ -184,7 +216,7 @@ std::pair<ssize_t, int32_t> TCPConnection::send(std::string &&data) const noexce
         return {0, 0};
     }
 
-    if (!m_readFromSocketThreadRunning.load()) {
+    if (!m_readFromSocketRunning.load()) {
         std::lock_guard<std::mutex> lck(m_connectionLostDelegateMutex); // LCOV_EXCL_LINE
         if (nullptr != m_connectionLostDelegate) {                      // LCOV_EXCL_LINE
             m_connectionLostDelegate();                                 // LCOV_EXCL_LINE
@@ -205,72 +237,61 @@ std::pair<ssize_t, int32_t> TCPConnection::send(std::string &&data) const noexce
 void TCPConnection::readFromSocket() noexcept {
     // Create buffer to store data from socket.
     constexpr uint16_t MAX_LENGTH{65535};
-    std::array<char, MAX_LENGTH> buffer{};
+    if (m_buffer.empty()) {
+        try {
+            m_buffer.resize(MAX_LENGTH);
+        } catch (...) { return; } // LCOV_EXCL_LINE
+    }
 
-    struct timeval timeout {};
+    ssize_t bytesRead = ::recv(m_socket, m_buffer.data(), m_buffer.size(), 0);
+    if (0 >= bytesRead) {
+        // 0 == bytesRead: peer shut down the connection; 0 > bytesRead: other error.
+        m_readFromSocketRunning.store(false);
 
-    // Define file descriptor set to watch for read operations.
-    fd_set setOfFiledescriptorsToReadFrom{};
+        // Stop watching the socket as it would remain readable.
+        if (m_reactor) {
+            m_reactor->removeSocket(m_socket);
+        }
 
-    // Indicate to main thread that we are ready.
-    m_readFromSocketThreadRunning.store(true);
+        {
+            std::lock_guard<std::mutex> lck(m_connectionLostDelegateMutex);
+            if (nullptr != m_connectionLostDelegate) {
+                m_connectionLostDelegate();
+            }
+        }
+        return;
+    }
 
-    // This flag is used to not read data from the socket until this TCPConnection has a proper onNewDataHandler set.
     bool hasNewDataDelegate{false};
+    {
+        std::lock_guard<std::mutex> lck(m_newDataDelegateMutex);
+        hasNewDataDelegate = (nullptr != m_newDataDelegate);
+    }
 
-    while (m_readFromSocketThreadRunning.load()) {
-        // Define timeout for select system call. The timeval struct must be
-        // reinitialized for every select call as it might be modified containing
-        // the actual time slept.
-        timeout.tv_sec  = 0;
-        timeout.tv_usec = 20 * 1000; // Check for new data with 50Hz.
-
-        FD_ZERO(&setOfFiledescriptorsToReadFrom);
-        FD_SET(m_socket, &setOfFiledescriptorsToReadFrom);
-        ::select(m_socket + 1, &setOfFiledescriptorsToReadFrom, nullptr, nullptr, &timeout);
-
-        // Only read data when the newDataDelegate is set.
-        if (!hasNewDataDelegate) {
-            std::lock_guard<std::mutex> lck(m_newDataDelegateMutex);
-            hasNewDataDelegate = (nullptr != m_newDataDelegate);
-        }
-        if (FD_ISSET(m_socket, &setOfFiledescriptorsToReadFrom) && hasNewDataDelegate) {
-            ssize_t bytesRead = ::recv(m_socket, buffer.data(), buffer.max_size(), 0);
-            if (0 >= bytesRead) {
-                // 0 == bytesRead: peer shut down the connection; 0 > bytesRead: other error.
-                m_readFromSocketThreadRunning.store(false);
-
-                {
-                    std::lock_guard<std::mutex> lck(m_connectionLostDelegateMutex);
-                    if (nullptr != m_connectionLostDelegate) {
-                        m_connectionLostDelegate();
-                    }
-                }
-                break;
-            }
+    // The entry is handed over outside of m_newDataDelegateMutex as a dispatched
+    // task might be executed directly and a full ring buffer needs to be processed.
+    if ((0 < bytesRead) && hasNewDataDelegate) {
+        // SIOCGSTAMP is not available for a stream-based socket,
+        // thus, falling back to regular chrono timestamping.
+        std::chrono::system_clock::time_point timestamp = std::chrono::system_clock::now();
 
-            {
-                std::lock_guard<std::mutex> lck(m_newDataDelegateMutex);
-                if ((0 < bytesRead) && (nullptr != m_newDataDelegate)) {
-                    // SIOCGSTAMP is not available for a stream-based socket,
-                    // thus, falling back to regular chrono timestamping.
-                    std::chrono::system_clock::time_point timestamp = std::chrono::system_clock::now();
-                    {
-                        PipelineEntry pe;
-                        pe.m_data       = std::string(buffer.data(), static_cast<size_t>(bytesRead));
-                        pe.m_sampleTime = timestamp;
-
-                        // Store entry in queue.
-                        if (m_pipeline) {
-                            m_pipeline->add(std::move(pe));
-                        }
-                    }
-
-                    if (m_pipeline) {
-                        m_pipeline->notifyAll();
-                    }
-                }
+        PipelineEntry pe;
+        pe.m_data       = std::string(m_buffer.data(), static_cast<size_t>(bytesRead));
+        pe.m_sampleTime = timestamp;
+
+        // Store entry in queue.
+        if (m_pipeline) {
+            // Bytes of a stream must not be dropped; thus, wait for a full ring buffer to be processed.
+            while (!m_pipeline->add(std::move(pe)) && m_readFromSocketRunning.load()) {
+                m_pipeline->notifyAll();
+                std::this_thread::yield();
             }
+            m_pipeline->notifyAll();
+        } else if (m_reactor) {
+            try {
+                auto entry = std::make_shared<PipelineEntry>(std::move(pe));
+                m_reactor->dispatch(m_dispatchQueue, [this, entry]() { this->m_newDataDelegate(std::move(entry->m_data), std::move(entry->m_sampleTime)); });
+            } catch (...) {} // LCOV_EXCL_LINE
         }
     }
 }
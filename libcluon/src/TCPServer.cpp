@@ -30,8 +30,11 @@
 
 namespace cluon {
 
-TCPServer::TCPServer(uint16_t port, std::function<void(std::string &&from, std::shared_ptr<cluon::TCPConnection> connection)> newConnectionDelegate) noexcept
-    : m_newConnectionDelegate(newConnectionDelegate) {
+TCPServer::TCPServer(uint16_t port,
+                     std::function<void(std::string &&from, std::shared_ptr<cluon::TCPConnection> connection)> newConnectionDelegate,
+                     std::shared_ptr<cluon::IOReactor> reactor) noexcept
+    : m_sharedReactor(reactor)
+    , m_newConnectionDelegate(newConnectionDelegate) {
     if (0 < port) {
 #ifdef WIN32
         // Load Winsock 2.2 DLL.
@@ -78,14 +81,12 @@ TCPServer::TCPServer(uint16_t port, std::function<void(std::string &&from, std::
                 constexpr int32_t MAX_PENDING_CONNECTIONS{100};
                 retVal = ::listen(m_socket, MAX_PENDING_CONNECTIONS);
                 if (-1 != retVal) {
-                    // Constructing a thread could fail.
+                    // Constructing the IOReactor could fail.
                     try {
-                        m_readFromSocketThread = std::thread(&TCPServer::readFromSocket, this);
-
-                        // Let the operating system spawn the thread.
-                        using namespace std::literals::chrono_literals;
-                        do { std::this_thread::sleep_for(1ms); } while (!m_readFromSocketThreadRunning.load());
-                    } catch (...) {          // LCOV_EXCL_LINE
+                        m_reactor = (m_sharedReactor ? m_sharedReactor : std::make_shared<cluon::IOReactor>());
+                        m_readFromSocketRunning.store(m_reactor->addSocket(m_socket, [this]() { this->readFromSocket(); }));
+                    } catch (...) {} // LCOV_EXCL_LINE
+                    if (!m_readFromSocketRunning.load()) {
                         closeSocket(ECHILD); // LCOV_EXCL_LINE
                     }
                 } else { // LCOV_EXCL_LINE
@@ -109,15 +110,13 @@ TCPServer::TCPServer(uint16_t port, std::function<void(std::string &&from, std::
 }
 
 TCPServer::~TCPServer() noexcept {
-    m_readFromSocketThreadRunning.store(false);
+    m_readFromSocketRunning.store(false);
 
-    // Joining the thread could fail.
-    try {
-        if (m_readFromSocketThread.joinable()) {
-            m_readFromSocketThread.join();
-        }
-    } catch (...) { // LCOV_EXCL_LINE
+    // Stop accepting before the socket is closed; the IOReactor wakes up its thread immediately.
+    if (m_reactor) {
+        m_reactor->removeSocket(m_socket);
     }
+    m_reactor.reset();
 
     closeSocket(0);
 }
@@ -146,45 +145,24 @@ void TCPServer::closeSocket(int errorCode) noexcept {
 }
 
 bool TCPServer::isRunning() const noexcept {
-    return (m_readFromSocketThreadRunning.load() && !TerminateHandler::instance().isTerminated.load());
+    return (m_readFromSocketRunning.load() && !TerminateHandler::instance().isTerminated.load());
 }
 
 void TCPServer::readFromSocket() noexcept {
-    struct timeval timeout {};
-
-    // Define file descriptor set to watch for read operations.
-    fd_set setOfFiledescriptorsToReadFrom{};
-
-    // Indicate to main thread that we are ready.
-    m_readFromSocketThreadRunning.store(true);
-
     constexpr uint16_t MAX_ADDR_SIZE{1024};
     std::array<char, MAX_ADDR_SIZE> remoteAddress{};
 
-    while (m_readFromSocketThreadRunning.load()) {
-        // Define timeout for select system call. The timeval struct must be
-        // reinitialized for every select call as it might be modified containing
-        // the actual time slept.
-        timeout.tv_sec  = 0;
-        timeout.tv_usec = 20 * 1000; // Check for new data with 50Hz.
-
-        FD_ZERO(&setOfFiledescriptorsToReadFrom);
-        FD_SET(m_socket, &setOfFiledescriptorsToReadFrom);
-        ::select(m_socket + 1, &setOfFiledescriptorsToReadFrom, nullptr, nullptr, &timeout);
-        if (FD_ISSET(m_socket, &setOfFiledescriptorsToReadFrom)) {
-            struct sockaddr_storage remote;
-            socklen_t addrLength     = sizeof(remote);
-            int32_t connectingClient = ::accept(m_socket, reinterpret_cast<struct sockaddr *>(&remote), &addrLength);
-            if ((0 <= connectingClient) && (nullptr != m_newConnectionDelegate)) {
-                ::inet_ntop(remote.ss_family,
-                            &((reinterpret_cast<struct sockaddr_in *>(&remote))->sin_addr), // NOLINT
-                            remoteAddress.data(),
-                            remoteAddress.max_size());
-                const uint16_t RECVFROM_PORT{ntohs(reinterpret_cast<struct sockaddr_in *>(&remote)->sin_port)}; // NOLINT
-                m_newConnectionDelegate(std::string(remoteAddress.data()) + ':' + std::to_string(RECVFROM_PORT),
-                                        std::shared_ptr<cluon::TCPConnection>(new cluon::TCPConnection(connectingClient)));
-            }
-        }
+    struct sockaddr_storage remote;
+    socklen_t addrLength     = sizeof(remote);
+    int32_t connectingClient = ::accept(m_socket, reinterpret_cast<struct sockaddr *>(&remote), &addrLength);
+    if ((0 <= connectingClient) && (nullptr != m_newConnectionDelegate)) {
+        ::inet_ntop(remote.ss_family,
+                    &((reinterpret_cast<struct sockaddr_in *>(&remote))->sin_addr), // NOLINT
+                    remoteAddress.data(),
+                    remoteAddress.max_size());
+        const uint16_t RECVFROM_PORT{ntohs(reinterpret_cast<struct sockaddr_in *>(&remote)->sin_port)}; // NOLINT
+        m_newConnectionDelegate(std::string(remoteAddress.data()) + ':' + std::to_string(RECVFROM_PORT),
+                                std::shared_ptr<cluon::TCPConnection>(new cluon::TCPConnection(connectingClient, m_sharedReactor)));
     }
 }
 } // namespace cluon
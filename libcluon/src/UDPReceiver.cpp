@@ -29,6 +29,11 @@
     #include <unistd.h>
 #endif
 
+#ifdef __linux__
+    #include <linux/sockios.h>
+    #include <time.h>
+#endif
+
 #ifndef WIN32
     #include <ifaddrs.h>
     #include <netdb.h>
@@ -49,12 +54,57 @@ namespace cluon {
 UDPReceiver::UDPReceiver(const std::string &receiveFromAddress,
                          uint16_t receiveFromPort,
                          std::function<void(std::string &&, std::string &&, std::chrono::system_clock::time_point &&)> delegate,
-                         uint16_t localSendFromPort) noexcept
+                         uint16_t localSendFromPort,
+                         std::shared_ptr<cluon::IOReactor> reactor,
+                         NotifyingPipelineType pipelineType) noexcept
+    : UDPReceiver(receiveFromAddress,
+                  receiveFromPort,
+                  std::move(delegate),
+                  std::function<void(cluon::PooledBuffer &&, const struct sockaddr_storage &, std::chrono::system_clock::time_point &&)>{},
+                  localSendFromPort,
+                  reactor,
+                  pipelineType) {}
+
+UDPReceiver::UDPReceiver(const std::string &receiveFromAddress,
+                         uint16_t receiveFromPort,
+                         std::nullptr_t /*delegate*/,
+                         uint16_t localSendFromPort,
+                         std::shared_ptr<cluon::IOReactor> reactor,
+                         NotifyingPipelineType pipelineType) noexcept
+    : UDPReceiver(receiveFromAddress,
+                  receiveFromPort,
+                  std::function<void(std::string &&, std::string &&, std::chrono::system_clock::time_point &&)>{},
+                  std::function<void(cluon::PooledBuffer &&, const struct sockaddr_storage &, std::chrono::system_clock::time_point &&)>{},
+                  localSendFromPort,
+                  reactor,
+                  pipelineType) {}
+
+UDPReceiver::UDPReceiver(const std::string &receiveFromAddress,
+                         uint16_t receiveFromPort,
+                         std::function<void(cluon::PooledBuffer &&, const struct sockaddr_storage &, std::chrono::system_clock::time_point &&)> delegate,
+                         uint16_t localSendFromPort,
+                         std::shared_ptr<cluon::IOReactor> reactor,
+                         NotifyingPipelineType pipelineType) noexcept
+    : UDPReceiver(receiveFromAddress,
+                  receiveFromPort,
+                  std::function<void(std::string &&, std::string &&, std::chrono::system_clock::time_point &&)>{},
+                  std::move(delegate),
+                  localSendFromPort,
+                  reactor,
+                  pipelineType) {}
+
+UDPReceiver::UDPReceiver(const std::string &receiveFromAddress,
+                         uint16_t receiveFromPort,
+                         std::function<void(std::string &&, std::string &&, std::chrono::system_clock::time_point &&)> &&stringDelegate,
+                         std::function<void(cluon::PooledBuffer &&, const struct sockaddr_storage &, std::chrono::system_clock::time_point &&)> &&pooledBufferDelegate,
+                         uint16_t localSendFromPort,
+                         std::shared_ptr<cluon::IOReactor> reactor,
+                         NotifyingPipelineType pipelineType) noexcept
     : m_localSendFromPort(localSendFromPort)
     , m_receiveFromAddress()
     , m_mreq()
-    , m_readFromSocketThread()
-    , m_delegate(std::move(delegate)) {
+    , m_delegate(std::move(stringDelegate))
+    , m_pooledBufferDelegate(std::move(pooledBufferDelegate)) {
     // Decompose given address string to check validity with numerical IPv4 address.
     std::string tmp{receiveFromAddress};
     std::replace(tmp.begin(), tmp.end(), '.', ' ');
@@ -156,6 +206,17 @@ UDPReceiver::UDPReceiver(const std::string &receiveFromAddress,
             }
         }
 
+#ifdef __linux__
+        if (!(m_socket < 0)) {
+            // Let the kernel attach the receive time stamp as control message to each datagram.
+            int32_t YES{1};
+            auto retVal = ::setsockopt(m_socket, SOL_SOCKET, SO_TIMESTAMPNS, reinterpret_cast<char *>(&YES), sizeof(YES)); // NOLINT
+            if (retVal < 0) {
+                std::cerr << "[cluon::UDPReceiver] Error while trying to set SO_TIMESTAMPNS: " << errno << std::endl; // LCOV_EXCL_LINE
+            }
+        }
+#endif
+
         if (!(m_socket < 0)) {
             // Bind to receive address/port.
             // clang-format off
@@ -229,40 +290,46 @@ UDPReceiver::UDPReceiver(const std::string &receiveFromAddress,
 #endif
         }
 
-        if (!(m_socket < 0)) {
-            // Constructing the receiving thread could fail.
+        if (!(m_socket < 0) && (nullptr != reactor)) {
+            // Received datagrams are handed over to the shared IOReactor's dispatch threads.
+            m_reactor       = reactor;
+            m_dispatchQueue = m_reactor->createDispatchQueue();
+        } else if (!(m_socket < 0)) {
+            // The pipeline must be available before the first datagram is read.
             try {
-                m_readFromSocketThread = std::thread(&UDPReceiver::readFromSocket, this);
-
-                // Let the operating system spawn the thread.
-                using namespace std::literals::chrono_literals; // NOLINT
-                do { std::this_thread::sleep_for(1ms); } while (!m_readFromSocketThreadRunning.load());
+                m_pipeline = std::make_shared<cluon::NotifyingPipeline<PipelineEntry>>(
+                    [this](PipelineEntry &&entry) { this->callDelegate(entry); },
+                    pipelineType);
             } catch (...) { closeSocket(ECHILD); } // LCOV_EXCL_LINE
+        }
 
+        if (!(m_socket < 0)) {
+            // Constructing the IOReactor could fail.
             try {
-                m_pipeline = std::make_shared<cluon::NotifyingPipeline<PipelineEntry>>(
-                    [this](PipelineEntry &&entry) { this->m_delegate(std::move(entry.m_data), std::move(entry.m_from), std::move(entry.m_sampleTime)); });
-                if (m_pipeline) {
-                    // Let the operating system spawn the thread.
-                    using namespace std::literals::chrono_literals; // NOLINT
-                    do { std::this_thread::sleep_for(1ms); } while (!m_pipeline->isRunning());
+                if (!m_reactor) {
+                    m_reactor = std::make_shared<cluon::IOReactor>();
                 }
-            } catch (...) { closeSocket(ECHILD); } // LCOV_EXCL_LINE
+                m_readFromSocketRunning.store(m_reactor->addSocket(m_socket, [this]() { this->readFromSocket(); }));
+            } catch (...) {} // LCOV_EXCL_LINE
+            if (!m_readFromSocketRunning.load()) {
+                closeSocket(ECHILD); // LCOV_EXCL_LINE
+            }
         }
     }
 }
 
 UDPReceiver::~UDPReceiver() noexcept {
-    {
-        m_readFromSocketThreadRunning.store(false);
-
-        // Joining the thread could fail.
-        try {
-            if (m_readFromSocketThread.joinable()) {
-                m_readFromSocketThread.join();
-            }
-        } catch (...) {} // LCOV_EXCL_LINE
+    m_readFromSocketRunning.store(false);
+
+    // Stop reading before the socket is closed; the IOReactor wakes up its thread immediately.
+    if (m_reactor) {
+        m_reactor->removeSocket(m_socket);
+        // Drop pending datagrams that were not delivered yet when using a shared IOReactor.
+        if (0 != m_dispatchQueue) {
+            m_reactor->removeDispatchQueue(m_dispatchQueue);
+        }
     }
+    m_reactor.reset();
 
     m_pipeline.reset();
 
@@ -302,108 +369,285 @@ void UDPReceiver::closeSocket(int errorCode) noexcept {
 }
 
 bool UDPReceiver::isRunning() const noexcept {
-    return (m_readFromSocketThreadRunning.load() && !TerminateHandler::instance().isTerminated.load());
+    return (m_readFromSocketRunning.load() && !TerminateHandler::instance().isTerminated.load());
+}
+
+void UDPReceiver::setPipelineCapacity(std::size_t capacity, NotifyingPipelineOverflowPolicy policy) noexcept {
+    if (m_pipeline) {
+        m_pipeline->setCapacity(capacity, policy);
+    }
+}
+
+std::size_t UDPReceiver::pipelineSize() const noexcept {
+    return (m_pipeline ? m_pipeline->size() : 0);
+}
+
+uint64_t UDPReceiver::numberOfDroppedDatagrams() const noexcept {
+    return (m_pipeline ? m_pipeline->numberOfDroppedEntries() : 0);
+}
+
+bool UDPReceiver::hasDelegate() const noexcept {
+    return ((nullptr != m_delegate) || (nullptr != m_pooledBufferDelegate));
+}
+
+void UDPReceiver::callDelegate(PipelineEntry &entry) noexcept {
+    if (nullptr != m_pooledBufferDelegate) {
+        m_pooledBufferDelegate(std::move(entry.m_buffer), entry.m_from, std::move(entry.m_sampleTime));
+    } else if (nullptr != m_delegate) {
+        // Transform sender address to C-string.
+        constexpr uint16_t MAX_ADDR_SIZE{1024};
+        std::array<char, MAX_ADDR_SIZE> remoteAddress{};
+        ::inet_ntop(entry.m_from.ss_family,
+                    &((reinterpret_cast<const struct sockaddr_in *>(&entry.m_from))->sin_addr), // NOLINT
+                    remoteAddress.data(),
+                    remoteAddress.max_size());
+        const uint16_t RECVFROM_PORT{ntohs(reinterpret_cast<const struct sockaddr_in *>(&entry.m_from)->sin_port)}; // NOLINT
+        m_delegate(std::move(entry.m_data), std::string(remoteAddress.data()) + ':' + std::to_string(RECVFROM_PORT), std::move(entry.m_sampleTime));
+    }
+}
+
+void UDPReceiver::processDatagram(cluon::PooledBuffer &buffer,
+                                  const char *overflow,
+                                  std::size_t length,
+                                  const struct sockaddr_storage &remote,
+                                  std::chrono::system_clock::time_point &&timestamp) noexcept {
+    const unsigned long RECVFROM_IP{reinterpret_cast<const struct sockaddr_in *>(&remote)->sin_addr.s_addr}; // NOLINT
+    const uint16_t RECVFROM_PORT{ntohs(reinterpret_cast<const struct sockaddr_in *>(&remote)->sin_port)};    // NOLINT
+
+    // Check if the bytes actually came from us.
+    bool sentFromUs{false};
+    {
+        auto pos                   = m_listOfLocalIPAddresses.find(RECVFROM_IP);
+        const bool sentFromLocalIP = (pos != m_listOfLocalIPAddresses.end() && (*pos == RECVFROM_IP));
+        sentFromUs                 = sentFromLocalIP && (m_localSendFromPort == RECVFROM_PORT);
+    }
+
+    // Create a pipeline entry to be processed concurrently.
+    if (!sentFromUs) {
+        const std::size_t LENGTH_IN_BUFFER{std::min(length, buffer.capacity())};
+        const std::size_t LENGTH_IN_OVERFLOW{length - LENGTH_IN_BUFFER};
+
+        PipelineEntry pe;
+        if ((nullptr != m_pooledBufferDelegate) && (0 == LENGTH_IN_OVERFLOW)) {
+            // Hand over the buffer without copying; a new one is taken from the pool for the next datagram.
+            buffer.resize(length);
+            pe.m_buffer = std::move(buffer);
+        } else if (nullptr != m_pooledBufferDelegate) {
+            // Large datagrams are assembled in a buffer of maximum size.
+            if (m_largeBufferPool) {
+                pe.m_buffer = m_largeBufferPool->acquire();
+            }
+            if (pe.m_buffer.capacity() < length) {
+                return; // LCOV_EXCL_LINE
+            }
+            std::memcpy(pe.m_buffer.data(), buffer.data(), LENGTH_IN_BUFFER);                              /* Flawfinder: ignore */ // NOLINT
+            std::memcpy(pe.m_buffer.data() + LENGTH_IN_BUFFER, overflow, LENGTH_IN_OVERFLOW);             /* Flawfinder: ignore */ // NOLINT
+            pe.m_buffer.resize(length);
+        } else {
+            // The delegate expects an std::string; copying right away keeps the buffer in use for receiving.
+            try {
+                pe.m_data.reserve(length);
+                pe.m_data.assign(buffer.data(), LENGTH_IN_BUFFER);
+                pe.m_data.append(overflow, LENGTH_IN_OVERFLOW);
+            } catch (...) { return; } // LCOV_EXCL_LINE
+        }
+        pe.m_from       = remote;
+        pe.m_sampleTime = timestamp;
+
+        // Store entry in queue.
+        if (m_pipeline) {
+            m_pipeline->add(std::move(pe));
+        } else {
+            try {
+                m_dispatchEntries.emplace_back(std::move(pe));
+            } catch (...) {} // LCOV_EXCL_LINE
+        }
+    }
 }
 
 void UDPReceiver::readFromSocket() noexcept {
-    // Create buffer to store data from socket.
     constexpr uint16_t MAX_LENGTH = static_cast<uint16_t>(UDPPacketSizeConstraints::MAX_SIZE_UDP_PACKET)
                                     - static_cast<uint16_t>(UDPPacketSizeConstraints::SIZE_IPv4_HEADER)
                                     - static_cast<uint16_t>(UDPPacketSizeConstraints::SIZE_UDP_HEADER);
-    std::array<char, MAX_LENGTH> buffer{};
-
-    struct timeval timeout {};
-
-    // Define file descriptor set to watch for read operations.
-    fd_set setOfFiledescriptorsToReadFrom{};
-
-    // Sender address and port.
-    constexpr uint16_t MAX_ADDR_SIZE{1024};
-    std::array<char, MAX_ADDR_SIZE> remoteAddress{};
-
-    struct sockaddr_storage remote {};
-    socklen_t addrLength{sizeof(remote)};
-
-    // Indicate to main thread that we are ready.
-    m_readFromSocketThreadRunning.store(true);
-
-    while (m_readFromSocketThreadRunning.load()) {
-        // Define timeout for select system call. The timeval struct must be
-        // reinitialized for every select call as it might be modified containing
-        // the actual time slept.
-        timeout.tv_sec  = 0;
-        timeout.tv_usec = 20 * 1000; // Check for new data with 50Hz.
-
-        FD_ZERO(&setOfFiledescriptorsToReadFrom);          // NOLINT
-        FD_SET(m_socket, &setOfFiledescriptorsToReadFrom); // NOLINT
-        ::select(m_socket + 1, &setOfFiledescriptorsToReadFrom, nullptr, nullptr, &timeout);
-
-        ssize_t totalBytesRead{0};
-        if (FD_ISSET(m_socket, &setOfFiledescriptorsToReadFrom)) { // NOLINT
-            ssize_t bytesRead{0};
-            do {
-                bytesRead = ::recvfrom(m_socket,
-                                       buffer.data(),
-                                       buffer.max_size(),
-                                       0,
-                                       reinterpret_cast<struct sockaddr *>(&remote), // NOLINT
-                                       reinterpret_cast<socklen_t *>(&addrLength));  // NOLINT
-
-                if ((0 < bytesRead) && (nullptr != m_delegate)) {
 #ifdef __linux__
-                    std::chrono::system_clock::time_point timestamp;
-                    struct timeval receivedTimeStamp {};
-                    if (0 == ::ioctl(m_socket, SIOCGSTAMP, &receivedTimeStamp)) { // NOLINT
-                        // Transform struct timeval to C++ chrono.
-                        std::chrono::time_point<std::chrono::system_clock, std::chrono::microseconds> transformedTimePoint(
-                            std::chrono::microseconds(receivedTimeStamp.tv_sec * 1000000L + receivedTimeStamp.tv_usec));
-                        timestamp = std::chrono::time_point_cast<std::chrono::system_clock::duration>(transformedTimePoint);
-                    } else { // LCOV_EXCL_LINE
-                        // In case the ioctl failed, fall back to chrono. // LCOV_EXCL_LINE
-                        timestamp = std::chrono::system_clock::now(); // LCOV_EXCL_LINE
-                    }
+    // Buffers to receive up to BATCH_SIZE datagrams with one call to recvmmsg;
+    // the receive time stamps are delivered as SCM_TIMESTAMPNS control messages.
+    constexpr uint8_t BATCH_SIZE{16};
+    struct alignas(struct cmsghdr) ControlBuffer {
+        char data[CMSG_SPACE(sizeof(struct timespec))];
+    };
+    std::array<struct mmsghdr, BATCH_SIZE> messages{};
+    std::array<std::array<struct iovec, 2>, BATCH_SIZE> iovecs{};
+    std::array<struct sockaddr_storage, BATCH_SIZE> remotes{};
+    std::array<ControlBuffer, BATCH_SIZE> controls{};
+    constexpr std::size_t NOTIFY_THRESHOLD{256};
 #else
-                    std::chrono::system_clock::time_point timestamp = std::chrono::system_clock::now();
+    constexpr uint8_t BATCH_SIZE{1};
 #endif
 
-                    // Transform sender address to C-string.
-                    ::inet_ntop(remote.ss_family,
-                                &((reinterpret_cast<struct sockaddr_in *>(&remote))->sin_addr), // NOLINT
-                                remoteAddress.data(),
-                                remoteAddress.max_size());
-                    const unsigned long RECVFROM_IP{reinterpret_cast<struct sockaddr_in *>(&remote)->sin_addr.s_addr}; // NOLINT
-                    const uint16_t RECVFROM_PORT{ntohs(reinterpret_cast<struct sockaddr_in *>(&remote)->sin_port)};    // NOLINT
-
-                    // Check if the bytes actually came from us.
-                    bool sentFromUs{false};
-                    {
-                        auto pos                   = m_listOfLocalIPAddresses.find(RECVFROM_IP);
-                        const bool sentFromLocalIP = (pos != m_listOfLocalIPAddresses.end() && (*pos == RECVFROM_IP));
-                        sentFromUs                 = sentFromLocalIP && (m_localSendFromPort == RECVFROM_PORT);
+    // Datagrams are received into buffers of POOLED_BUFFER_SIZE taken from a
+    // pool, which covers datagrams fitting into an Ethernet frame; the bytes
+    // of larger datagrams continue in a separate overflow region per datagram.
+    // Thus, waiting datagrams do not occupy buffers of maximum size.
+    constexpr uint16_t POOLED_BUFFER_SIZE{2048};
+    constexpr uint16_t OVERFLOW_LENGTH{MAX_LENGTH - POOLED_BUFFER_SIZE};
+
+    // Create buffers to store data from socket; buffers that were handed over
+    // to the delegate in the previous pass are replaced by buffers from the pool.
+    if (!m_bufferPool) {
+        m_bufferPool = BufferPool::create(POOLED_BUFFER_SIZE, BATCH_SIZE);
+        // Buffers for large datagrams are only allocated when needed.
+        m_largeBufferPool = BufferPool::create(MAX_LENGTH);
+        if (!m_bufferPool || !m_largeBufferPool) {
+            return; // LCOV_EXCL_LINE
+        }
+        try {
+            m_receiveBuffers.resize(BATCH_SIZE);
+            m_overflowBuffer.resize(static_cast<std::size_t>(BATCH_SIZE) * OVERFLOW_LENGTH + POOLED_BUFFER_SIZE);
+        } catch (...) {
+            m_bufferPool.reset(); // LCOV_EXCL_LINE
+            return;               // LCOV_EXCL_LINE
+        }
+    }
+
+    ssize_t totalBytesRead{0};
+#ifdef __linux__
+    if (m_useBatchedReceive) {
+        int32_t datagramsRead{0};
+        do {
+            // recvmmsg modifies the lengths for sender and control data; thus, reset them for every call.
+            for (uint8_t i{0}; i < BATCH_SIZE; i++) {
+                if (nullptr == m_receiveBuffers[i].data()) {
+                    m_receiveBuffers[i] = m_bufferPool->acquire();
+                    if (nullptr == m_receiveBuffers[i].data()) {
+                        return; // LCOV_EXCL_LINE
                     }
+                }
+                iovecs[i][0].iov_base              = m_receiveBuffers[i].data();
+                iovecs[i][0].iov_len               = POOLED_BUFFER_SIZE;
+                iovecs[i][1].iov_base              = &m_overflowBuffer[static_cast<std::size_t>(i) * OVERFLOW_LENGTH];
+                iovecs[i][1].iov_len               = OVERFLOW_LENGTH;
+                messages[i].msg_hdr.msg_name       = &remotes[i];
+                messages[i].msg_hdr.msg_namelen    = sizeof(remotes[i]);
+                messages[i].msg_hdr.msg_iov        = iovecs[i].data();
+                messages[i].msg_hdr.msg_iovlen     = iovecs[i].size();
+                messages[i].msg_hdr.msg_control    = controls[i].data;
+                messages[i].msg_hdr.msg_controllen = sizeof(controls[i].data);
+                messages[i].msg_hdr.msg_flags      = 0;
+                messages[i].msg_len                = 0;
+            }
 
-                    // Create a pipeline entry to be processed concurrently.
-                    if (!sentFromUs) {
-                        PipelineEntry pe;
-                        pe.m_data       = std::string(buffer.data(), static_cast<size_t>(bytesRead));
-                        pe.m_from       = std::string(remoteAddress.data()) + ':' + std::to_string(RECVFROM_PORT);
-                        pe.m_sampleTime = timestamp;
+            datagramsRead = ::recvmmsg(m_socket, messages.data(), BATCH_SIZE, MSG_DONTWAIT, nullptr);
+            if ((0 > datagramsRead) && (ENOSYS == errno)) {
+                // Kernel without recvmmsg; fall back to reading datagram by datagram.
+                m_useBatchedReceive = false; // LCOV_EXCL_LINE
+            }
 
-                        // Store entry in queue.
-                        if (m_pipeline) {
-                            m_pipeline->add(std::move(pe));
+            for (int32_t i{0}; i < datagramsRead; i++) {
+                if ((0 < messages[i].msg_len) && hasDelegate()) {
+                    std::chrono::system_clock::time_point timestamp;
+                    bool hasTimeStamp{false};
+                    for (struct cmsghdr *cmsg = CMSG_FIRSTHDR(&messages[i].msg_hdr); nullptr != cmsg; cmsg = CMSG_NXTHDR(&messages[i].msg_hdr, cmsg)) {
+                        if ((SOL_SOCKET == cmsg->cmsg_level) && (SCM_TIMESTAMPNS == cmsg->cmsg_type)) {
+                            struct timespec receivedTimeStamp {};
+                            std::memcpy(&receivedTimeStamp, CMSG_DATA(cmsg), sizeof(receivedTimeStamp)); /* Flawfinder: ignore */ // NOLINT
+                            // Transform struct timespec to C++ chrono.
+                            std::chrono::time_point<std::chrono::system_clock, std::chrono::microseconds> transformedTimePoint(
+                                std::chrono::microseconds(receivedTimeStamp.tv_sec * 1000000L + receivedTimeStamp.tv_nsec / 1000L));
+                            timestamp    = std::chrono::time_point_cast<std::chrono::system_clock::duration>(transformedTimePoint);
+                            hasTimeStamp = true;
                         }
                     }
-                    totalBytesRead += bytesRead;
-                }
-            } while (!m_isBlockingSocket && (bytesRead > 0));
-        }
+                    if (!hasTimeStamp) {
+                        // In case no time stamp was attached, fall back to chrono. // LCOV_EXCL_LINE
+                        timestamp = std::chrono::system_clock::now(); // LCOV_EXCL_LINE
+                    }
 
-        if (static_cast<int32_t>(totalBytesRead) > 0) {
-            if (m_pipeline) {
+                    processDatagram(m_receiveBuffers[static_cast<std::size_t>(i)],
+                                    static_cast<const char *>(iovecs[static_cast<std::size_t>(i)][1].iov_base),
+                                    messages[i].msg_len,
+                                    remotes[static_cast<std::size_t>(i)],
+                                    std::move(timestamp));
+                    totalBytesRead += messages[i].msg_len;
+                }
+            }
+            // Wake the pipeline's thread during long passes so that a bounded ring
+            // buffer does not overflow while the socket is drained; waking it for
+            // every batch would cost a context switch per batch.
+            if ((0 < datagramsRead) && m_pipeline && (m_pipeline->size() >= NOTIFY_THRESHOLD)) {
                 m_pipeline->notifyAll();
             }
+            // A partially filled batch indicates that the socket has been drained.
+        } while (BATCH_SIZE == datagramsRead);
+    }
+    if (!m_useBatchedReceive)
+#endif
+    {
+        // Sender address and port.
+        struct sockaddr_storage remote {};
+        socklen_t addrLength{sizeof(remote)};
+
+        ssize_t bytesRead{0};
+        do {
+            if (nullptr == m_receiveBuffers[0].data()) {
+                m_receiveBuffers[0] = m_bufferPool->acquire();
+                if (nullptr == m_receiveBuffers[0].data()) {
+                    break; // LCOV_EXCL_LINE
+                }
+            }
+            // Without scatter/gather support, datagrams are received into the
+            // overflow region first and their beginning is copied to the pooled buffer.
+            bytesRead = ::recvfrom(m_socket,
+                                   m_overflowBuffer.data(),
+                                   MAX_LENGTH,
+                                   0,
+                                   reinterpret_cast<struct sockaddr *>(&remote), // NOLINT
+                                   reinterpret_cast<socklen_t *>(&addrLength));  // NOLINT
+
+            if ((0 < bytesRead) && hasDelegate()) {
+#ifdef __linux__
+                std::chrono::system_clock::time_point timestamp;
+                struct timeval receivedTimeStamp {};
+                if (0 == ::ioctl(m_socket, SIOCGSTAMP, &receivedTimeStamp)) { // NOLINT
+                    // Transform struct timeval to C++ chrono.
+                    std::chrono::time_point<std::chrono::system_clock, std::chrono::microseconds> transformedTimePoint(
+                        std::chrono::microseconds(receivedTimeStamp.tv_sec * 1000000L + receivedTimeStamp.tv_usec));
+                    timestamp = std::chrono::time_point_cast<std::chrono::system_clock::duration>(transformedTimePoint);
+                } else { // LCOV_EXCL_LINE
+                    // In case the ioctl failed, fall back to chrono. // LCOV_EXCL_LINE
+                    timestamp = std::chrono::system_clock::now(); // LCOV_EXCL_LINE
+                }
+#else
+                std::chrono::system_clock::time_point timestamp = std::chrono::system_clock::now();
+#endif
+
+                const std::size_t LENGTH_IN_BUFFER{std::min(static_cast<std::size_t>(bytesRead), static_cast<std::size_t>(POOLED_BUFFER_SIZE))};
+                std::memcpy(m_receiveBuffers[0].data(), m_overflowBuffer.data(), LENGTH_IN_BUFFER); /* Flawfinder: ignore */ // NOLINT
+                processDatagram(m_receiveBuffers[0],
+                                m_overflowBuffer.data() + LENGTH_IN_BUFFER,
+                                static_cast<std::size_t>(bytesRead),
+                                remote,
+                                std::move(timestamp));
+                totalBytesRead += bytesRead;
+            }
+        } while (!m_isBlockingSocket && (bytesRead > 0));
+    }
+
+    if (static_cast<int32_t>(totalBytesRead) > 0) {
+        if (m_pipeline) {
+            m_pipeline->notifyAll();
         }
     }
+
+    if (!m_dispatchEntries.empty() && m_reactor) {
+        // Hand over all datagrams of this pass at once to keep their order.
+        try {
+            auto entries = std::make_shared<std::vector<PipelineEntry>>(std::move(m_dispatchEntries));
+            m_dispatchEntries.clear();
+            m_reactor->dispatch(m_dispatchQueue, [this, entries]() {
+                for (auto &entry : *entries) { this->callDelegate(entry); }
+            });
+        } catch (...) { m_dispatchEntries.clear(); } // LCOV_EXCL_LINE
+    }
 }
 } // namespace cluon
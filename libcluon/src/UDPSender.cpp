@@ -16,6 +16,7 @@
     #include <arpa/inet.h>
     #include <sys/socket.h>
     #include <sys/types.h>
+    #include <sys/uio.h>
     #include <unistd.h>
 #endif
 // clang-format on
@@ -23,6 +24,7 @@
 #include <cerrno>
 #include <cstring>
 #include <algorithm>
+#include <array>
 #include <iterator>
 #include <sstream>
 #include <vector>
@@ -101,29 +103,172 @@ uint16_t UDPSender::getSendFromPort() const noexcept {
 }
 
 std::pair<ssize_t, int32_t> UDPSender::send(std::string &&data) const noexcept {
+    return send(data.data(), data.size());
+}
+
+std::pair<ssize_t, int32_t> UDPSender::send(const char *data, std::size_t size) const noexcept {
     if (-1 == m_socket) {
         return {-1, EBADF};
     }
 
-    if (data.empty()) {
+    if ((nullptr == data) || (0 == size)) {
         return {0, 0};
     }
 
     constexpr uint16_t MAX_LENGTH = static_cast<uint16_t>(UDPPacketSizeConstraints::MAX_SIZE_UDP_PACKET)
                                     - static_cast<uint16_t>(UDPPacketSizeConstraints::SIZE_IPv4_HEADER)
                                     - static_cast<uint16_t>(UDPPacketSizeConstraints::SIZE_UDP_HEADER);
-    if (MAX_LENGTH < data.size()) {
+    if (MAX_LENGTH < size) {
         return {-1, E2BIG};
     }
 
     std::lock_guard<std::mutex> lck(m_socketMutex);
     ssize_t bytesSent = ::sendto(m_socket,
-                                 data.c_str(),
-                                 data.length(),
+                                 data,
+                                 size,
                                  0,
                                  reinterpret_cast<const struct sockaddr *>(&m_sendToAddress), // NOLINT
                                  sizeof(m_sendToAddress));
 
     return {bytesSent, (0 > bytesSent ? errno : 0)};
 }
+
+std::pair<ssize_t, int32_t> UDPSender::send(const std::pair<const char *, std::size_t> *parts, std::size_t numberOfParts) const noexcept {
+    if (-1 == m_socket) {
+        return {-1, EBADF};
+    }
+
+    if ((nullptr == parts) || (MAX_NUMBER_OF_PARTS < numberOfParts)) {
+        return {-1, EINVAL};
+    }
+
+    // Skip empty parts.
+#ifdef WIN32
+    WSABUF buffers[MAX_NUMBER_OF_PARTS];
+#else
+    struct iovec buffers[MAX_NUMBER_OF_PARTS];
+#endif
+    std::size_t numberOfBuffers{0};
+    std::size_t size{0};
+    for (std::size_t i{0}; i < numberOfParts; i++) {
+        if ((nullptr != parts[i].first) && (0 < parts[i].second)) {
+#ifdef WIN32
+            buffers[numberOfBuffers].buf = const_cast<char *>(parts[i].first); // NOLINT
+            buffers[numberOfBuffers].len = static_cast<ULONG>(parts[i].second);
+#else
+            buffers[numberOfBuffers].iov_base = const_cast<char *>(parts[i].first); // NOLINT
+            buffers[numberOfBuffers].iov_len  = parts[i].second;
+#endif
+            numberOfBuffers++;
+            size += parts[i].second;
+        }
+    }
+
+    if (0 == size) {
+        return {0, 0};
+    }
+
+    constexpr uint16_t MAX_LENGTH = static_cast<uint16_t>(UDPPacketSizeConstraints::MAX_SIZE_UDP_PACKET)
+                                    - static_cast<uint16_t>(UDPPacketSizeConstraints::SIZE_IPv4_HEADER)
+                                    - static_cast<uint16_t>(UDPPacketSizeConstraints::SIZE_UDP_HEADER);
+    if (MAX_LENGTH < size) {
+        return {-1, E2BIG};
+    }
+
+    std::lock_guard<std::mutex> lck(m_socketMutex);
+#ifdef WIN32
+    DWORD sent{0};
+    ssize_t bytesSent = (0 == ::WSASendTo(m_socket,
+                                          buffers,
+                                          static_cast<DWORD>(numberOfBuffers),
+                                          &sent,
+                                          0,
+                                          reinterpret_cast<const struct sockaddr *>(&m_sendToAddress), // NOLINT
+                                          sizeof(m_sendToAddress),
+                                          nullptr,
+                                          nullptr))
+                            ? static_cast<ssize_t>(sent)
+                            : -1;
+#else
+    struct msghdr message;
+    std::memset(&message, 0, sizeof(message));
+    message.msg_name    = const_cast<struct sockaddr_in *>(&m_sendToAddress); // NOLINT
+    message.msg_namelen = sizeof(m_sendToAddress);
+    message.msg_iov     = buffers;
+    message.msg_iovlen  = numberOfBuffers;
+    ssize_t bytesSent   = ::sendmsg(m_socket, &message, 0);
+#endif
+
+    return {bytesSent, (0 > bytesSent ? errno : 0)};
+}
+
+std::pair<ssize_t, int32_t> UDPSender::send(const std::vector<std::pair<const char *, std::size_t>> &packets) const noexcept {
+    if (-1 == m_socket) {
+        return {-1, EBADF};
+    }
+
+    constexpr uint16_t MAX_LENGTH = static_cast<uint16_t>(UDPPacketSizeConstraints::MAX_SIZE_UDP_PACKET)
+                                    - static_cast<uint16_t>(UDPPacketSizeConstraints::SIZE_IPv4_HEADER)
+                                    - static_cast<uint16_t>(UDPPacketSizeConstraints::SIZE_UDP_HEADER);
+    for (const auto &packet : packets) {
+        if (MAX_LENGTH < packet.second) {
+            return {-1, E2BIG};
+        }
+    }
+
+    ssize_t packetsSent{0};
+    int32_t error{0};
+    std::lock_guard<std::mutex> lck(m_socketMutex);
+#ifdef __linux__
+    // Send up to MAX_NUMBER_OF_PACKETS_PER_SYSCALL packets with one call to sendmmsg.
+    std::array<struct mmsghdr, MAX_NUMBER_OF_PACKETS_PER_SYSCALL> messages;
+    std::array<struct iovec, MAX_NUMBER_OF_PACKETS_PER_SYSCALL> iovecs;
+    std::size_t next{0};
+    while ((0 == error) && (next < packets.size())) {
+        uint32_t numberOfMessages{0};
+        for (; (next < packets.size()) && (numberOfMessages < MAX_NUMBER_OF_PACKETS_PER_SYSCALL); next++) {
+            if ((nullptr != packets[next].first) && (0 < packets[next].second)) {
+                iovecs[numberOfMessages].iov_base = const_cast<char *>(packets[next].first); // NOLINT
+                iovecs[numberOfMessages].iov_len  = packets[next].second;
+                std::memset(&messages[numberOfMessages], 0, sizeof(struct mmsghdr));
+                messages[numberOfMessages].msg_hdr.msg_name    = const_cast<struct sockaddr_in *>(&m_sendToAddress); // NOLINT
+                messages[numberOfMessages].msg_hdr.msg_namelen = sizeof(m_sendToAddress);
+                messages[numberOfMessages].msg_hdr.msg_iov     = &iovecs[numberOfMessages];
+                messages[numberOfMessages].msg_hdr.msg_iovlen  = 1;
+                numberOfMessages++;
+            }
+        }
+
+        // sendmmsg might send less packets than given; continue with the remaining ones.
+        uint32_t offset{0};
+        while (offset < numberOfMessages) {
+            const int32_t SENT{::sendmmsg(m_socket, &messages[offset], numberOfMessages - offset, 0)};
+            if (0 > SENT) {
+                error = errno;
+                break;
+            }
+            offset += static_cast<uint32_t>(SENT);
+            packetsSent += SENT;
+        }
+    }
+#else
+    for (const auto &packet : packets) {
+        if ((nullptr != packet.first) && (0 < packet.second)) {
+            const ssize_t BYTES_SENT{::sendto(m_socket,
+                                              packet.first,
+                                              packet.second,
+                                              0,
+                                              reinterpret_cast<const struct sockaddr *>(&m_sendToAddress), // NOLINT
+                                              sizeof(m_sendToAddress))};
+            if (0 > BYTES_SENT) {
+                error = errno;
+                break;
+            }
+            packetsSent++;
+        }
+    }
+#endif
+
+    return {((0 == packetsSent) && (0 != error)) ? -1 : packetsSent, error};
+}
 } // namespace cluon
@@ -0,0 +1,206 @@
+/*
+ * Copyright (C) 2017-2018  Christian Berger
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "catch.hpp"
+
+#include "cluon/Arena.hpp"
+#include "cluon/Envelope.hpp"
+#include "cluon/FromProtoVisitor.hpp"
+#include "cluon/ToProtoVisitor.hpp"
+#include "cluon/cluonDataStructures.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <string>
+#include <vector>
+
+// Count the heap allocations of this test suite.
+static std::atomic<uint64_t> numberOfHeapAllocations{0};
+
+void *operator new(std::size_t size) {
+    numberOfHeapAllocations++;
+    void *ptr{std::malloc((0 < size) ? size : 1)};
+    if (nullptr == ptr) {
+        throw std::bad_alloc();
+    }
+    return ptr;
+}
+
+void operator delete(void *ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void *ptr, std::size_t) noexcept {
+    std::free(ptr);
+}
+
+static std::string createSerializedEnvelope() {
+    cluon::data::TimeStamp ts;
+    ts.seconds(1).microseconds(2);
+    cluon::data::Envelope env;
+    env.dataType(3).serializedData(std::string(100, 'x')).sent(ts).received(ts).sampleTimeStamp(ts).senderStamp(4);
+
+    cluon::ToProtoVisitor protoEncoder;
+    env.accept(protoEncoder);
+    return protoEncoder.encodedData();
+}
+
+// Decodes an Envelope via decodeFrom and accept, i.e., every nested message is decoded by a new FromProtoVisitor.
+static cluon::data::Envelope decodeIndirectly(const std::string &data) {
+    cluon::FromProtoVisitor protoDecoder;
+    protoDecoder.decodeFrom(data.data(), data.size());
+    cluon::data::Envelope env;
+    env.accept(protoDecoder);
+    return env;
+}
+
+TEST_CASE("Allocate from an Arena.") {
+    cluon::Arena arena{256};
+    REQUIRE(0 == arena.numberOfBlocks());
+    REQUIRE(0 == arena.capacity());
+    REQUIRE(0 == arena.numberOfBytesInUse());
+
+    char *a{static_cast<char *>(arena.allocate(3, 1))};
+    REQUIRE(nullptr != a);
+    REQUIRE(1 == arena.numberOfBlocks());
+    REQUIRE(256 == arena.capacity());
+    uint64_t *b{static_cast<uint64_t *>(arena.allocate(sizeof(uint64_t), alignof(uint64_t)))};
+    REQUIRE(nullptr != b);
+    REQUIRE(0 == (reinterpret_cast<uintptr_t>(b) % alignof(uint64_t)));
+    REQUIRE(a + 3 <= reinterpret_cast<char *>(b));
+
+    // The blocks are reused after rewinding.
+    const cluon::Arena::Mark MARK{arena.mark()};
+    char *c{static_cast<char *>(arena.allocate(10, 1))};
+    arena.rewind(MARK);
+    REQUIRE(c == arena.allocate(10, 1));
+
+    // Larger allocations get a block of their own.
+    REQUIRE(nullptr != arena.allocate(1000, 1));
+    REQUIRE(2 == arena.numberOfBlocks());
+    REQUIRE(256 + 1001 == arena.capacity());
+
+    arena.reset();
+    REQUIRE(0 == arena.numberOfBytesInUse());
+    REQUIRE(a == arena.allocate(3, 1));
+    REQUIRE(nullptr != arena.allocate(200, 1));
+    REQUIRE(nullptr != arena.allocate(1000, 1));
+    REQUIRE(2 == arena.numberOfBlocks());
+}
+
+TEST_CASE("Activate Arenas with nested ArenaScopes.") {
+    cluon::Arena outer;
+    cluon::Arena inner;
+    REQUIRE(nullptr == cluon::Arena::current());
+    {
+        cluon::ArenaScope outerScope{outer};
+        REQUIRE(&outer == cluon::Arena::current());
+        outer.allocate(10, 1);
+        const std::size_t IN_USE{outer.numberOfBytesInUse()};
+        {
+            cluon::ArenaScope innerScope{inner};
+            REQUIRE(&inner == cluon::Arena::current());
+            {
+                // The same Arena can be activated again.
+                cluon::ArenaScope outerScopeAgain{outer};
+                REQUIRE(&outer == cluon::Arena::current());
+                outer.allocate(100, 1);
+                REQUIRE(IN_USE < outer.numberOfBytesInUse());
+            }
+            REQUIRE(&inner == cluon::Arena::current());
+            REQUIRE(IN_USE == outer.numberOfBytesInUse());
+        }
+        REQUIRE(&outer == cluon::Arena::current());
+    }
+    REQUIRE(nullptr == cluon::Arena::current());
+    REQUIRE(0 == outer.numberOfBytesInUse());
+
+    // Every thread has its own Arena.
+    REQUIRE(&cluon::Arena::ofThisThread() == &cluon::Arena::ofThisThread());
+}
+
+TEST_CASE("Use ArenaAllocator in standard containers.") {
+    // Without an active Arena, the memory is taken from the heap.
+    std::vector<uint32_t, cluon::ArenaAllocator<uint32_t>> onHeap;
+    REQUIRE(nullptr == onHeap.get_allocator().arena());
+    onHeap.resize(100, 1);
+
+    cluon::Arena arena;
+    arena.allocate(1, 1);
+    arena.reset();
+    {
+        cluon::ArenaScope scope{arena};
+        std::vector<uint32_t, cluon::ArenaAllocator<uint32_t>> inArena;
+        REQUIRE(&arena == inArena.get_allocator().arena());
+        const uint64_t HEAP_ALLOCATIONS{numberOfHeapAllocations};
+        for (uint32_t i{0}; i < 1000; i++) { inArena.push_back(i); }
+        std::basic_string<char, std::char_traits<char>, cluon::ArenaAllocator<char>> str(1000, 'x');
+        REQUIRE(HEAP_ALLOCATIONS == numberOfHeapAllocations);
+        REQUIRE(999 == inArena.back());
+        REQUIRE(1000 == str.size());
+        REQUIRE(4000 + 1000 < arena.numberOfBytesInUse());
+
+        // Containers with different Arenas are not equal.
+        REQUIRE(onHeap.get_allocator() != inArena.get_allocator());
+        REQUIRE(cluon::ArenaAllocator<char>(&arena) == cluon::ArenaAllocator<uint32_t>(&arena));
+    }
+    REQUIRE(0 == arena.numberOfBytesInUse());
+    REQUIRE(100 == onHeap.size());
+}
+
+TEST_CASE("Decode nested messages with scratch memory from an Arena.") {
+    const std::string DATA{createSerializedEnvelope()};
+    const cluon::data::Envelope EXPECTED{decodeIndirectly(DATA)};
+    REQUIRE(1 == EXPECTED.sent().seconds());
+    REQUIRE(2 == EXPECTED.sampleTimeStamp().microseconds());
+
+    cluon::Arena &arena{cluon::Arena::ofThisThread()};
+    for (uint32_t i{0}; i < 3; i++) {
+        cluon::ArenaScope scope{arena};
+        cluon::data::Envelope env{decodeIndirectly(DATA)};
+        REQUIRE(EXPECTED.dataType() == env.dataType());
+        REQUIRE(EXPECTED.serializedData() == env.serializedData());
+        REQUIRE(EXPECTED.sent().seconds() == env.sent().seconds());
+        REQUIRE(EXPECTED.received().microseconds() == env.received().microseconds());
+        REQUIRE(EXPECTED.sampleTimeStamp().seconds() == env.sampleTimeStamp().seconds());
+        REQUIRE(EXPECTED.senderStamp() == env.senderStamp());
+        REQUIRE(0 < arena.numberOfBytesInUse());
+    }
+    REQUIRE(1 == arena.numberOfBlocks());
+    REQUIRE(0 == arena.numberOfBytesInUse());
+}
+
+TEST_CASE("Benchmark decoding nested messages with and without an Arena.") {
+    const std::string DATA{createSerializedEnvelope()};
+    constexpr uint32_t ITERATIONS{100000};
+
+    int64_t sum{0};
+    uint64_t heapAllocations{numberOfHeapAllocations};
+    auto before = std::chrono::steady_clock::now();
+    for (uint32_t i{0}; i < ITERATIONS; i++) { sum += decodeIndirectly(DATA).sent().seconds(); }
+    auto onHeap = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - before).count();
+    const uint64_t ON_HEAP_ALLOCATIONS{numberOfHeapAllocations - heapAllocations};
+
+    heapAllocations = numberOfHeapAllocations;
+    before          = std::chrono::steady_clock::now();
+    for (uint32_t i{0}; i < ITERATIONS; i++) {
+        cluon::ArenaScope scope{cluon::Arena::ofThisThread()};
+        sum -= decodeIndirectly(DATA).sent().seconds();
+    }
+    auto inArena = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - before).count();
+    const uint64_t IN_ARENA_ALLOCATIONS{numberOfHeapAllocations - heapAllocations};
+
+    std::clog << "[TestArena] Decoding an Envelope via accept: heap " << onHeap / ITERATIONS << " ns and " << ON_HEAP_ALLOCATIONS / ITERATIONS
+              << " allocations, Arena " << inArena / ITERATIONS << " ns and " << IN_ARENA_ALLOCATIONS / ITERATIONS << " allocations per Envelope." << std::endl;
+    REQUIRE(0 == sum);
+    REQUIRE(IN_ARENA_ALLOCATIONS < ON_HEAP_ALLOCATIONS);
+}
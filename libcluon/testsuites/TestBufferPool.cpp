@@ -0,0 +1,103 @@
+/*
+ * Copyright (C) 2017-2018  Christian Berger
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "catch.hpp"
+
+#include "cluon/BufferPool.hpp"
+
+#include <cstring>
+#include <string>
+#include <utility>
+#include <vector>
+
+TEST_CASE("Creating BufferPool with preallocated buffers.") {
+    auto pool = cluon::BufferPool::create(100, 4);
+    REQUIRE(pool);
+    REQUIRE(100 == pool->bufferSize());
+    REQUIRE(4 == pool->numberOfBuffers());
+    REQUIRE(4 == pool->numberOfAvailableBuffers());
+}
+
+TEST_CASE("Acquiring and releasing buffers reuses them.") {
+    auto pool = cluon::BufferPool::create(100);
+    REQUIRE(0 == pool->numberOfBuffers());
+
+    const char *firstBuffer{nullptr};
+    {
+        cluon::PooledBuffer b{pool->acquire()};
+        REQUIRE(nullptr != b.data());
+        REQUIRE(b.empty());
+        REQUIRE(100 == b.capacity());
+        firstBuffer = b.data();
+
+        std::memcpy(b.data(), "Hello", 5);
+        b.resize(5);
+        REQUIRE(5 == b.size());
+        REQUIRE("Hello" == b.toString());
+
+        // The size is limited to the capacity.
+        b.resize(1000);
+        REQUIRE(100 == b.size());
+
+        REQUIRE(1 == pool->numberOfBuffers());
+        REQUIRE(0 == pool->numberOfAvailableBuffers());
+    }
+    REQUIRE(1 == pool->numberOfAvailableBuffers());
+
+    // The released buffer is reused and its size is reset.
+    cluon::PooledBuffer b{pool->acquire()};
+    REQUIRE(firstBuffer == b.data());
+    REQUIRE(b.empty());
+    REQUIRE(1 == pool->numberOfBuffers());
+}
+
+TEST_CASE("Copies of PooledBuffer share the buffer.") {
+    auto pool = cluon::BufferPool::create(10);
+    cluon::PooledBuffer b1{pool->acquire()};
+    std::memcpy(b1.data(), "abc", 3);
+    b1.resize(3);
+
+    cluon::PooledBuffer b2{b1};
+    REQUIRE(b1.data() == b2.data());
+    REQUIRE("abc" == b2.toString());
+
+    cluon::PooledBuffer b3;
+    REQUIRE(nullptr == b3.data());
+    REQUIRE(0 == b3.capacity());
+    b3 = std::move(b1);
+    REQUIRE(nullptr == b1.data());
+    REQUIRE(b2.data() == b3.data());
+
+    b2 = cluon::PooledBuffer();
+    REQUIRE(0 == pool->numberOfAvailableBuffers());
+    b3 = cluon::PooledBuffer();
+    REQUIRE(1 == pool->numberOfAvailableBuffers());
+}
+
+TEST_CASE("BufferPool grows when all buffers are in use.") {
+    auto pool = cluon::BufferPool::create(10, 2);
+    std::vector<cluon::PooledBuffer> buffers;
+    for (uint32_t i{0}; i < 5; i++) { buffers.emplace_back(pool->acquire()); }
+    REQUIRE(5 == pool->numberOfBuffers());
+    REQUIRE(0 == pool->numberOfAvailableBuffers());
+
+    buffers.clear();
+    REQUIRE(5 == pool->numberOfAvailableBuffers());
+}
+
+TEST_CASE("PooledBuffer outlives its BufferPool's owner.") {
+    cluon::PooledBuffer b;
+    {
+        auto pool = cluon::BufferPool::create(10);
+        b         = pool->acquire();
+    }
+    REQUIRE(nullptr != b.data());
+    std::memcpy(b.data(), "x", 1);
+    b.resize(1);
+    REQUIRE("x" == b.toString());
+}
@@ -7,6 +7,7 @@
  */
 
 #include "catch.hpp"
+#include <chrono>
 #include <iomanip>
 #include <iostream>
 #include <sstream>
@@ -14,6 +15,7 @@
 
 #include "cluon/Envelope.hpp"
 #include "cluon/EnvelopeConverter.hpp"
+#include "cluon/EnvelopeView.hpp"
 #include "cluon/FromJSONVisitor.hpp"
 #include "cluon/FromProtoVisitor.hpp"
 #include "cluon/ToJSONVisitor.hpp"
@@ -1388,3 +1390,156 @@ message MyTestMessage5 [id = 30009] {
     REQUIRE(tmp2.attribute10() == Approx(tmp.attribute10()));
     REQUIRE(tmp2.attribute11() == tmp.attribute11());
 }
+
+TEST_CASE("Extract Envelope directly from memory.") {
+    cluon::data::Envelope env;
+    env.dataType(1234).senderStamp(5).serializedData("Hello World");
+    const std::string serialized{cluon::serializeEnvelope(std::move(env))};
+
+    auto retVal = cluon::extractEnvelope(serialized.data(), serialized.size());
+    REQUIRE(retVal.first);
+    REQUIRE(1234 == retVal.second.dataType());
+    REQUIRE(5 == retVal.second.senderStamp());
+    REQUIRE("Hello World" == retVal.second.serializedData());
+
+    // Truncated payload.
+    REQUIRE(!cluon::extractEnvelope(serialized.data(), serialized.size() - 1).first);
+    // Truncated header.
+    REQUIRE(!cluon::extractEnvelope(serialized.data(), 4).first);
+    REQUIRE(!cluon::extractEnvelope(nullptr, 0).first);
+    // Invalid header.
+    std::string invalid{serialized};
+    invalid[1] = 0x00;
+    REQUIRE(!cluon::extractEnvelope(invalid.data(), invalid.size()).first);
+}
+
+TEST_CASE("Peek message identifier and sender stamp of Envelope in memory.") {
+    cluon::data::TimeStamp ts;
+    ts.seconds(123).microseconds(456);
+
+    cluon::data::Envelope env;
+    env.dataType(-1234).senderStamp(300000).serializedData(std::string(1000, 'x')).sent(ts).received(ts).sampleTimeStamp(ts);
+    const std::string serialized{cluon::serializeEnvelope(std::move(env))};
+
+    int32_t dataType{0};
+    uint32_t senderStamp{0};
+    REQUIRE(cluon::peekEnvelope(serialized.data(), serialized.size(), dataType, senderStamp));
+    REQUIRE(-1234 == dataType);
+    REQUIRE(300000 == senderStamp);
+
+    // Missing fields are reported as 0.
+    cluon::data::Envelope empty;
+    const std::string serializedEmpty{cluon::serializeEnvelope(std::move(empty))};
+    REQUIRE(cluon::peekEnvelope(serializedEmpty.data(), serializedEmpty.size(), dataType, senderStamp));
+    REQUIRE(0 == dataType);
+    REQUIRE(0 == senderStamp);
+
+    // Truncated payload and header.
+    REQUIRE(!cluon::peekEnvelope(serialized.data(), serialized.size() - 1, dataType, senderStamp));
+    REQUIRE(!cluon::peekEnvelope(serialized.data(), 4, dataType, senderStamp));
+    REQUIRE(!cluon::peekEnvelope(nullptr, 0, dataType, senderStamp));
+
+    // Length of serializedData exceeding the Envelope.
+    std::string invalid{serialized};
+    invalid[1] = 0x00;
+    REQUIRE(!cluon::peekEnvelope(invalid.data(), invalid.size(), dataType, senderStamp));
+    std::string truncated{serialized.substr(0, 20)};
+    truncated[2] = 15;
+    truncated[3] = 0;
+    truncated[4] = 0;
+    REQUIRE(!cluon::peekEnvelope(truncated.data(), truncated.size(), dataType, senderStamp));
+}
+
+TEST_CASE("Benchmark peeking Envelope against decoding it.") {
+    cluon::data::Envelope env;
+    env.dataType(1234).senderStamp(5).serializedData(std::string(1000, 'x'));
+    const std::string serialized{cluon::serializeEnvelope(std::move(env))};
+
+    constexpr uint32_t ITERATIONS{20000};
+    int64_t sum{0};
+    auto before = std::chrono::steady_clock::now();
+    for (uint32_t i{0}; i < ITERATIONS; i++) {
+        int32_t dataType{0};
+        uint32_t senderStamp{0};
+        cluon::peekEnvelope(serialized.data(), serialized.size(), dataType, senderStamp);
+        sum += dataType;
+    }
+    auto peeking = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - before).count();
+
+    before = std::chrono::steady_clock::now();
+    for (uint32_t i{0}; i < ITERATIONS; i++) { sum -= cluon::extractEnvelope(serialized.data(), serialized.size()).second.dataType(); }
+    auto decoding = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - before).count();
+
+    std::clog << "[TestEnvelopeConverter] 1 KB Envelope: peeking " << peeking / ITERATIONS << " ns, decoding " << decoding / ITERATIONS << " ns per Envelope."
+              << std::endl;
+    REQUIRE(0 == sum);
+}
+
+TEST_CASE("Serialize Envelope as scatter/gather list and into caller memory.") {
+    cluon::data::TimeStamp ts;
+    ts.seconds(1537000000).microseconds(999999);
+
+    for (std::size_t payloadSize : {0, 11, 127, 128, 70000}) {
+        cluon::data::Envelope env;
+        env.dataType(-1234).senderStamp(300000).serializedData(std::string(payloadSize, 'x')).sent(ts).received(ts).sampleTimeStamp(ts);
+        const std::string expected{cluon::serializeEnvelope(cluon::data::Envelope{env})};
+
+        std::string buffer;
+        const cluon::EnvelopeParts PARTS{cluon::serializeEnvelopeParts(buffer, env)};
+        std::string joined;
+        for (const auto &part : PARTS) { joined.append(part.first, part.second); }
+        REQUIRE(expected == joined);
+        // The payload is not copied.
+        REQUIRE(payloadSize == PARTS[1].second);
+        REQUIRE(expected.size() - payloadSize == buffer.size());
+
+        std::string out(expected.size() + 1, '\0');
+        REQUIRE(expected.size() == cluon::serializeEnvelope(&out[0], out.size(), env));
+        REQUIRE(expected == out.substr(0, expected.size()));
+        REQUIRE(0 == cluon::serializeEnvelope(&out[0], expected.size() - 1, env));
+        REQUIRE(0 == cluon::serializeEnvelope(nullptr, expected.size(), env));
+    }
+
+    // Payload given separately from the Envelope.
+    cluon::data::Envelope env;
+    env.dataType(5).serializedData("Hello World");
+    const std::string expected{cluon::serializeEnvelope(cluon::data::Envelope{env})};
+    const std::string payload{"Hello World"};
+    env.serializedData("");
+    std::string buffer;
+    const cluon::EnvelopeParts PARTS{cluon::serializeEnvelopeParts(buffer, env, payload.data(), payload.size())};
+    REQUIRE(payload.data() == PARTS[1].first);
+    std::string joined;
+    for (const auto &part : PARTS) { joined.append(part.first, part.second); }
+    REQUIRE(expected == joined);
+    auto retVal = cluon::extractEnvelope(joined.data(), joined.size());
+    REQUIRE(retVal.first);
+    REQUIRE(payload == retVal.second.serializedData());
+}
+
+TEST_CASE("Benchmark serializing Envelope as scatter/gather list against into one buffer.") {
+    for (std::size_t payloadSize : {1000, 60000}) {
+        cluon::data::Envelope env;
+        env.dataType(1234).senderStamp(5).serializedData(std::string(payloadSize, 'x'));
+
+        constexpr uint32_t ITERATIONS{2000};
+        std::string buffer;
+        std::size_t sum{0};
+        auto before = std::chrono::steady_clock::now();
+        for (uint32_t i{0}; i < ITERATIONS; i++) {
+            cluon::serializeEnvelope(buffer, env);
+            sum += buffer.size();
+        }
+        auto contiguous = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - before).count();
+
+        before = std::chrono::steady_clock::now();
+        for (uint32_t i{0}; i < ITERATIONS; i++) {
+            for (const auto &part : cluon::serializeEnvelopeParts(buffer, env)) { sum -= part.second; }
+        }
+        auto parts = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - before).count();
+
+        std::clog << "[TestEnvelopeConverter] Envelope with " << payloadSize << " bytes: one buffer " << contiguous / ITERATIONS << " ns, scatter/gather list "
+                  << parts / ITERATIONS << " ns per Envelope." << std::endl;
+        REQUIRE(0 == sum);
+    }
+}
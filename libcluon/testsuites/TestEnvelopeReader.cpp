@@ -0,0 +1,230 @@
+/*
+ * Copyright (C) 2017-2018  Christian Berger
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "catch.hpp"
+
+#include "cluon/Envelope.hpp"
+#include "cluon/EnvelopeReader.hpp"
+#include "cluon/EnvelopeView.hpp"
+#include "cluon/ToProtoVisitor.hpp"
+#include "cluon/cluonDataStructures.hpp"
+
+#ifndef WIN32
+    #include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Serializes an Envelope with a PlayerStatus and a payload of the given size.
+static std::string createEnvelope(uint32_t senderStamp, std::size_t payloadSize) {
+    cluon::data::PlayerStatus ps;
+    ps.numberOfEntries(static_cast<uint32_t>(payloadSize));
+    cluon::ToProtoVisitor protoEncoder;
+    ps.accept(protoEncoder);
+
+    cluon::data::TimeStamp sampleTimeStamp;
+    sampleTimeStamp.seconds(static_cast<int32_t>(senderStamp)).microseconds(1);
+    cluon::data::Envelope env;
+    env.dataType(cluon::data::PlayerStatus::ID())
+        .serializedData(protoEncoder.encodedData() + std::string(payloadSize, 'x'))
+        .sampleTimeStamp(sampleTimeStamp)
+        .senderStamp(senderStamp);
+    return cluon::serializeEnvelope(std::move(env));
+}
+
+// Reads all Envelopes and returns their sender stamps.
+static std::vector<uint32_t> readAll(cluon::EnvelopeReader &reader, std::vector<uint64_t> &positions) {
+    std::vector<uint32_t> senderStamps;
+    cluon::EnvelopeFrame frame;
+    while (reader.next(frame)) {
+        int32_t dataType{0};
+        uint32_t senderStamp{0};
+        REQUIRE(cluon::peekEnvelope(frame.m_data, frame.m_size, dataType, senderStamp));
+        REQUIRE(cluon::data::PlayerStatus::ID() == dataType);
+        senderStamps.push_back(senderStamp);
+        positions.push_back(frame.m_position);
+    }
+    return senderStamps;
+}
+
+TEST_CASE("Read Envelopes from an istream.") {
+    std::string data;
+    std::vector<uint32_t> expected;
+    std::vector<uint64_t> expectedPositions;
+    for (uint32_t i{0}; i < 100; i++) {
+        expectedPositions.push_back(data.size());
+        data += createEnvelope(i, i * 10);
+        expected.push_back(i);
+    }
+
+    // A small buffer needs to be refilled and grown for the larger Envelopes.
+    for (std::size_t bufferSize : {static_cast<std::size_t>(16), cluon::EnvelopeReader::DEFAULT_BUFFER_SIZE}) {
+        std::stringstream sstr{data};
+        cluon::EnvelopeReader reader{sstr, bufferSize};
+        std::vector<uint64_t> positions;
+        REQUIRE(expected == readAll(reader, positions));
+        REQUIRE(expectedPositions == positions);
+        REQUIRE(0 == reader.numberOfSkippedBytes());
+
+        cluon::EnvelopeFrame frame;
+        REQUIRE(!reader.next(frame));
+    }
+}
+
+TEST_CASE("Read Envelopes with corrupt bytes in between.") {
+    const std::string A{createEnvelope(1, 10)};
+    const std::string B{createEnvelope(2, 20)};
+    const std::string C{createEnvelope(3, 30)};
+    const std::string D{createEnvelope(4, 40)};
+
+    // OD4 header with a length beyond the following Envelopes.
+    const std::string HUGE_LENGTH{"\x0D\xA4\xff\xff\x00", 5};
+    // OD4 header with malformed Proto-encoded bytes.
+    const std::string MALFORMED{"\x0D\xA4\x03\x00\x00\xff\xff\xff", 8};
+    const std::string GARBAGE{"\x0D\x0D\x01\x02garbage\x0D", 12};
+    const std::string TRUNCATED{D.substr(0, D.size() - 1)};
+
+    const std::string data{GARBAGE + A + HUGE_LENGTH + B + MALFORMED + GARBAGE + C + TRUNCATED};
+    std::stringstream sstr{data};
+    cluon::EnvelopeReader reader{sstr, 32};
+    std::vector<uint64_t> positions;
+    REQUIRE(std::vector<uint32_t>{1, 2, 3} == readAll(reader, positions));
+    REQUIRE(std::vector<uint64_t>{GARBAGE.size(),
+                                  GARBAGE.size() + A.size() + HUGE_LENGTH.size(),
+                                  GARBAGE.size() + A.size() + HUGE_LENGTH.size() + B.size() + MALFORMED.size() + GARBAGE.size()}
+            == positions);
+    REQUIRE((GARBAGE.size() * 2 + HUGE_LENGTH.size() + MALFORMED.size() + TRUNCATED.size()) == reader.numberOfSkippedBytes());
+}
+
+TEST_CASE("Read Envelopes from memory.") {
+    const std::string A{createEnvelope(1, 10)};
+    const std::string B{createEnvelope(2, 20)};
+    const std::string GARBAGE{"\x0D\x0D\x01\x02garbage\x0D", 12};
+    const std::string TRUNCATED{A.substr(0, A.size() - 1)};
+
+    const std::string data{A + GARBAGE + B + TRUNCATED};
+    cluon::EnvelopeReader reader{data.data(), data.size()};
+    std::vector<uint64_t> positions;
+    REQUIRE(std::vector<uint32_t>{1, 2} == readAll(reader, positions));
+    REQUIRE(std::vector<uint64_t>{0, A.size() + GARBAGE.size()} == positions);
+    REQUIRE((GARBAGE.size() + TRUNCATED.size()) == reader.numberOfSkippedBytes());
+
+    // The frames point into the given memory.
+    cluon::EnvelopeReader reader2{data.data(), data.size()};
+    cluon::EnvelopeFrame frame;
+    REQUIRE(reader2.next(frame));
+    REQUIRE(data.data() == frame.m_data);
+
+    cluon::EnvelopeReader reader3{nullptr, 10};
+    REQUIRE(!reader3.next(frame));
+}
+
+TEST_CASE("Read Envelopes from an empty or failed istream.") {
+    std::stringstream empty;
+    cluon::EnvelopeReader reader{empty};
+    cluon::EnvelopeFrame frame;
+    REQUIRE(!reader.next(frame));
+    REQUIRE(0 == reader.numberOfSkippedBytes());
+
+    std::stringstream failed{createEnvelope(1, 1)};
+    failed.setstate(std::ios::failbit);
+    cluon::EnvelopeReader reader2{failed};
+    REQUIRE(!reader2.next(frame));
+}
+
+#ifndef WIN32
+TEST_CASE("Read Envelopes from a pipe as they arrive.") {
+    int fds[2];
+    REQUIRE(0 == ::pipe(fds));
+
+    const std::string A{createEnvelope(1, 10)};
+    const std::string B{createEnvelope(2, 20000)};
+    REQUIRE(static_cast<ssize_t>(A.size()) == ::write(fds[1], A.data(), A.size()));
+
+    cluon::EnvelopeReader reader{fds[0], 1024};
+    cluon::EnvelopeFrame frame;
+    // The first Envelope is available before any further bytes were written.
+    REQUIRE(reader.next(frame));
+    REQUIRE(A == std::string(frame.m_data, frame.m_size));
+
+    // The second Envelope arrives in pieces.
+    bool written{true};
+    std::thread writer([&fds, &B, &written]() {
+        for (std::size_t offset{0}; offset < B.size(); offset += 1000) {
+            const std::size_t SIZE{std::min<std::size_t>(1000, B.size() - offset)};
+            written &= (static_cast<ssize_t>(SIZE) == ::write(fds[1], B.data() + offset, SIZE));
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        ::close(fds[1]);
+    });
+    REQUIRE(reader.next(frame));
+    REQUIRE(A.size() == frame.m_position);
+    REQUIRE(B == std::string(frame.m_data, frame.m_size));
+    REQUIRE(!reader.next(frame));
+    writer.join();
+    REQUIRE(written);
+    ::close(fds[0]);
+
+    cluon::EnvelopeReader invalid{-1};
+    REQUIRE(!invalid.next(frame));
+}
+#endif
+
+TEST_CASE("Extract several Envelopes from an istream.") {
+    std::stringstream sstr{createEnvelope(1, 10) + createEnvelope(2, 100000) + createEnvelope(3, 0)};
+    for (uint32_t i{1}; i <= 3; i++) {
+        auto retVal = cluon::extractEnvelope(sstr);
+        REQUIRE(retVal.first);
+        REQUIRE(i == retVal.second.senderStamp());
+        REQUIRE(static_cast<int32_t>(i) == retVal.second.sampleTimeStamp().seconds());
+    }
+    REQUIRE(!cluon::extractEnvelope(sstr).first);
+}
+
+TEST_CASE("Benchmark scanning a recording with EnvelopeReader against extractEnvelope.") {
+    constexpr uint32_t NUMBER_OF_ENVELOPES{50000};
+    std::string data;
+    for (uint32_t i{0}; i < NUMBER_OF_ENVELOPES; i++) { data += createEnvelope(i, 200 + (i % 7) * 100); }
+
+    // Scanning as done to index a .rec file: Only the sample time stamp is needed.
+    int64_t sum{0};
+    std::stringstream sstr1{data};
+    auto before = std::chrono::steady_clock::now();
+    for (uint32_t i{0}; i < NUMBER_OF_ENVELOPES; i++) {
+        auto retVal = cluon::extractEnvelope(sstr1);
+        sum += retVal.second.sampleTimeStamp().seconds();
+    }
+    auto extracting = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - before).count();
+
+    std::stringstream sstr2{data};
+    before = std::chrono::steady_clock::now();
+    {
+        cluon::EnvelopeReader reader{sstr2};
+        cluon::EnvelopeFrame frame;
+        cluon::EnvelopeMeta meta;
+        const char *serializedData{nullptr};
+        std::size_t serializedDataSize{0};
+        while (reader.next(frame)) {
+            cluon::peekEnvelope(frame.m_data, frame.m_size, meta, serializedData, serializedDataSize);
+            sum -= meta.m_sampleTimeStamp.seconds();
+        }
+    }
+    auto reading = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - before).count();
+
+    std::clog << "[TestEnvelopeReader] Scanning " << NUMBER_OF_ENVELOPES << " Envelopes (" << data.size() / (1024 * 1024) << " MB): extractEnvelope "
+              << extracting / NUMBER_OF_ENVELOPES << " ns, EnvelopeReader with peekEnvelope " << reading / NUMBER_OF_ENVELOPES << " ns per Envelope."
+              << std::endl;
+    REQUIRE(0 == sum);
+}
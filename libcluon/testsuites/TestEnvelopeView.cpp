@@ -0,0 +1,159 @@
+/*
+ * Copyright (C) 2017-2018  Christian Berger
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "catch.hpp"
+
+#include "cluon/Envelope.hpp"
+#include "cluon/EnvelopeView.hpp"
+#include "cluon/Time.hpp"
+#include "cluon/ToProtoVisitor.hpp"
+#include "cluon/cluonDataStructures.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <string>
+
+static cluon::data::TimeStamp createTimeStamp(int32_t seconds, int32_t microseconds) {
+    cluon::data::TimeStamp ts;
+    ts.seconds(seconds).microseconds(microseconds);
+    return ts;
+}
+
+static std::string createEnvelope() {
+    cluon::data::PlayerStatus ps;
+    ps.state(2).numberOfEntries(100).currentEntryForPlayback(42);
+    cluon::ToProtoVisitor protoEncoder;
+    ps.accept(protoEncoder);
+
+    cluon::data::Envelope env;
+    env.dataType(cluon::data::PlayerStatus::ID())
+        .serializedData(protoEncoder.encodedData())
+        .sent(createTimeStamp(1, 2))
+        .received(createTimeStamp(-3, 4))
+        .sampleTimeStamp(createTimeStamp(5, 6))
+        .senderStamp(7);
+    return cluon::serializeEnvelope(std::move(env));
+}
+
+TEST_CASE("View an Envelope.") {
+    const std::string DATA{createEnvelope()};
+    const cluon::EnvelopeView VIEW{cluon::viewEnvelope(DATA.data(), DATA.size())};
+    REQUIRE(VIEW.valid());
+    REQUIRE(cluon::data::PlayerStatus::ID() == VIEW.dataType());
+    REQUIRE(7 == VIEW.senderStamp());
+    REQUIRE(1 == VIEW.sent().seconds());
+    REQUIRE(2 == VIEW.sent().microseconds());
+    REQUIRE(-3 == VIEW.received().seconds());
+    REQUIRE(4 == VIEW.received().microseconds());
+    REQUIRE(5 == VIEW.sampleTimeStamp().seconds());
+    REQUIRE(6 == VIEW.sampleTimeStamp().microseconds());
+
+    // The serializedData points into the given memory.
+    const auto SERIALIZED_DATA = VIEW.serializedData();
+    REQUIRE(DATA.data() < SERIALIZED_DATA.first);
+    REQUIRE(SERIALIZED_DATA.first + SERIALIZED_DATA.second < DATA.data() + DATA.size());
+
+    auto ps = cluon::extractMessage<cluon::data::PlayerStatus>(VIEW);
+    REQUIRE(2 == ps.state());
+    REQUIRE(100 == ps.numberOfEntries());
+    REQUIRE(42 == ps.currentEntryForPlayback());
+
+    auto meta = VIEW.meta();
+    REQUIRE(cluon::data::PlayerStatus::ID() == meta.m_dataType);
+    REQUIRE(7 == meta.m_senderStamp);
+    REQUIRE(-3 == meta.m_received.seconds());
+    REQUIRE(6 == meta.m_sampleTimeStamp.microseconds());
+
+    // Converting to an Envelope gives the same result as extractEnvelope.
+    auto env      = VIEW.toEnvelope();
+    auto expected = cluon::extractEnvelope(DATA.data(), DATA.size());
+    REQUIRE(expected.first);
+    REQUIRE(cluon::serializeEnvelope(std::move(expected.second)) == cluon::serializeEnvelope(std::move(env)));
+}
+
+TEST_CASE("View an Envelope without fields.") {
+    const std::string DATA{"\x0D\xA4\x00\x00\x00", 5};
+    const cluon::EnvelopeView VIEW{cluon::viewEnvelope(DATA.data(), DATA.size())};
+    REQUIRE(VIEW.valid());
+    REQUIRE(0 == VIEW.dataType());
+    REQUIRE(0 == VIEW.senderStamp());
+    REQUIRE(nullptr == VIEW.serializedData().first);
+    REQUIRE(0 == VIEW.sampleTimeStamp().seconds());
+    REQUIRE(0 == VIEW.toEnvelope().dataType());
+}
+
+TEST_CASE("View invalid Envelopes.") {
+    const cluon::EnvelopeView EMPTY;
+    REQUIRE(!EMPTY.valid());
+    REQUIRE(0 == EMPTY.dataType());
+    REQUIRE(0 == EMPTY.sent().seconds());
+    REQUIRE(0 == EMPTY.toEnvelope().dataType());
+
+    const std::string DATA{createEnvelope()};
+    REQUIRE(!cluon::viewEnvelope(DATA.data(), DATA.size() - 1).valid());
+    REQUIRE(!cluon::viewEnvelope(DATA.data() + 1, DATA.size() - 1).valid());
+    REQUIRE(!cluon::viewEnvelope(nullptr, 0).valid());
+
+    // Truncated Proto-encoded bytes.
+    const cluon::EnvelopeView TRUNCATED{DATA.data() + 5, DATA.size() - 6};
+    REQUIRE(!TRUNCATED.valid());
+}
+
+TEST_CASE("View an Envelope with duplicated fields like FromProtoVisitor.") {
+    // dataType 1 and 2, serializedData "a" and "bc", senderStamp as LENGTH_DELIMITED
+    // and VARINT, and a sampleTimeStamp with seconds 1 and 2.
+    const std::string PROTO{"\x08\x02\x08\x04\x12\x01\x61\x12\x02\x62\x63\x32\x00\x30\x05\x2a\x04\x08\x02\x08\x04", 21};
+    const cluon::EnvelopeView VIEW{PROTO.data(), PROTO.size()};
+    REQUIRE(VIEW.valid());
+    REQUIRE(1 == VIEW.dataType());
+    REQUIRE(1 == VIEW.serializedData().second);
+    REQUIRE(0 == VIEW.senderStamp());
+    REQUIRE(1 == VIEW.sampleTimeStamp().seconds());
+
+    cluon::FromProtoVisitor protoDecoder;
+    REQUIRE(protoDecoder.decodeFrom(PROTO.data(), PROTO.size()));
+    cluon::data::Envelope expected;
+    expected.accept(protoDecoder);
+    REQUIRE(1 == expected.dataType());
+    REQUIRE("a" == expected.serializedData());
+    REQUIRE(0 == expected.senderStamp());
+    REQUIRE(1 == expected.sampleTimeStamp().seconds());
+    REQUIRE(cluon::serializeEnvelope(std::move(expected)) == cluon::serializeEnvelope(VIEW.toEnvelope()));
+}
+
+TEST_CASE("Benchmark routing Envelopes by dataType with EnvelopeView against extractEnvelope.") {
+    const std::string DATA{createEnvelope()};
+    constexpr uint32_t ITERATIONS{100000};
+
+    int64_t sum{0};
+    auto before = std::chrono::steady_clock::now();
+    for (uint32_t i{0}; i < ITERATIONS; i++) {
+        auto retVal = cluon::extractEnvelope(DATA.data(), DATA.size());
+        sum += retVal.second.dataType();
+    }
+    auto extracting = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - before).count();
+
+    before = std::chrono::steady_clock::now();
+    for (uint32_t i{0}; i < ITERATIONS; i++) {
+        const cluon::EnvelopeView VIEW{cluon::viewEnvelope(DATA.data(), DATA.size())};
+        sum -= VIEW.dataType();
+    }
+    auto viewing = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - before).count();
+
+    before = std::chrono::steady_clock::now();
+    for (uint32_t i{0}; i < ITERATIONS; i++) {
+        const cluon::EnvelopeView VIEW{cluon::viewEnvelope(DATA.data(), DATA.size())};
+        sum += cluon::time::toMicroseconds(VIEW.sampleTimeStamp()) - 5000006;
+    }
+    auto viewingTimeStamp = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - before).count();
+
+    std::clog << "[TestEnvelopeView] Reading dataType: extractEnvelope " << extracting / ITERATIONS << " ns, EnvelopeView " << viewing / ITERATIONS
+              << " ns; sampleTimeStamp with EnvelopeView " << viewingTimeStamp / ITERATIONS << " ns per Envelope." << std::endl;
+    REQUIRE(0 == sum);
+}
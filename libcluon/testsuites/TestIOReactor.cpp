@@ -0,0 +1,208 @@
+/*
+ * Copyright (C) 2017-2018  Christian Berger
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "catch.hpp"
+
+#include "cluon/IOReactor.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#ifndef WIN32
+    #include <unistd.h>
+#endif
+
+TEST_CASE("Creating IOReactor and stop immediately.") {
+    const auto before = std::chrono::steady_clock::now();
+    {
+        cluon::IOReactor reactor;
+        REQUIRE(reactor.isRunning());
+    }
+    const auto after = std::chrono::steady_clock::now();
+
+    // Shutting down must not wait for any timeout.
+    REQUIRE(std::chrono::duration_cast<std::chrono::milliseconds>(after - before).count() < 1000);
+}
+
+TEST_CASE("Trying to add invalid sockets to IOReactor.") {
+    cluon::IOReactor reactor;
+    REQUIRE(reactor.isRunning());
+    REQUIRE(!reactor.addSocket(-1, []() {}));
+    REQUIRE(!reactor.addSocket(0, nullptr));
+}
+
+#ifndef WIN32
+TEST_CASE("Calling delegate for readable file descriptor.") {
+    int fds[2];
+    REQUIRE(0 == ::pipe(fds));
+
+    std::atomic<uint32_t> calls{0};
+    cluon::IOReactor reactor;
+    REQUIRE(reactor.isRunning());
+    REQUIRE(reactor.addSocket(fds[0], [&fds, &calls]() {
+        char c{0};
+        if (1 == ::read(fds[0], &c, 1)) {
+            calls++;
+        }
+    }));
+
+    // Adding the same file descriptor twice is not allowed.
+    REQUIRE(!reactor.addSocket(fds[0], []() {}));
+
+    const char DATA[]{"abc"};
+    REQUIRE(3 == ::write(fds[1], DATA, 3));
+
+    using namespace std::literals::chrono_literals; // NOLINT
+    do { std::this_thread::sleep_for(1ms); } while (calls.load() < 3);
+    REQUIRE(3 == calls.load());
+
+    reactor.removeSocket(fds[0]);
+    REQUIRE(1 == ::write(fds[1], DATA, 1));
+    std::this_thread::sleep_for(100ms);
+    REQUIRE(3 == calls.load());
+
+    ::close(fds[0]);
+    ::close(fds[1]);
+}
+
+TEST_CASE("Removing socket from within its own delegate.") {
+    int fds[2];
+    REQUIRE(0 == ::pipe(fds));
+
+    std::atomic<uint32_t> calls{0};
+    cluon::IOReactor reactor;
+    REQUIRE(reactor.addSocket(fds[0], [&reactor, &fds, &calls]() {
+        calls++;
+        // The data is not consumed; without removing the socket, the delegate would be called again.
+        reactor.removeSocket(fds[0]);
+    }));
+
+    const char DATA[]{"a"};
+    REQUIRE(1 == ::write(fds[1], DATA, 1));
+
+    using namespace std::literals::chrono_literals; // NOLINT
+    do { std::this_thread::sleep_for(1ms); } while (0 == calls.load());
+    std::this_thread::sleep_for(100ms);
+    REQUIRE(1 == calls.load());
+
+    ::close(fds[0]);
+    ::close(fds[1]);
+}
+#endif
+
+TEST_CASE("Dispatching tasks executes them in order per dispatch queue.") {
+    cluon::IOReactor reactor(1, 3);
+    REQUIRE(reactor.isRunning());
+    REQUIRE(3 == reactor.numberOfDispatchThreads());
+
+    constexpr uint32_t NUMBER_OF_QUEUES{4};
+    constexpr uint32_t NUMBER_OF_TASKS{1000};
+    std::atomic<uint32_t> executedInOrder[NUMBER_OF_QUEUES];
+    uint32_t queues[NUMBER_OF_QUEUES];
+    for (uint32_t i{0}; i < NUMBER_OF_QUEUES; i++) {
+        executedInOrder[i] = 0;
+        queues[i]          = reactor.createDispatchQueue();
+    }
+
+    for (uint32_t j{0}; j < NUMBER_OF_TASKS; j++) {
+        for (uint32_t i{0}; i < NUMBER_OF_QUEUES; i++) {
+            auto &counter = executedInOrder[i];
+            reactor.dispatch(queues[i], [&counter, j]() {
+                if (j == counter.load()) {
+                    counter++;
+                }
+            });
+        }
+    }
+
+    using namespace std::literals::chrono_literals; // NOLINT
+    bool allExecuted{false};
+    do {
+        std::this_thread::sleep_for(1ms);
+        allExecuted = true;
+        for (uint32_t i{0}; i < NUMBER_OF_QUEUES; i++) { allExecuted &= (NUMBER_OF_TASKS == executedInOrder[i].load()); }
+    } while (!allExecuted);
+    REQUIRE(allExecuted);
+}
+
+TEST_CASE("Dispatching tasks without dispatch threads executes them directly.") {
+    cluon::IOReactor reactor;
+    REQUIRE(0 == reactor.numberOfDispatchThreads());
+
+    uint32_t executed{0};
+    reactor.dispatch(reactor.createDispatchQueue(), [&executed]() { executed++; });
+    REQUIRE(1 == executed);
+}
+
+TEST_CASE("Removing dispatch queue drops pending tasks.") {
+    cluon::IOReactor reactor(1, 1);
+    const uint32_t queue{reactor.createDispatchQueue()};
+
+    std::atomic<bool> started{false};
+    std::atomic<bool> blocking{true};
+    std::atomic<uint32_t> executed{0};
+    reactor.dispatch(queue, [&started, &blocking, &executed]() {
+        started.store(true);
+        using namespace std::literals::chrono_literals; // NOLINT
+        do { std::this_thread::sleep_for(1ms); } while (blocking.load());
+        executed++;
+    });
+    for (uint32_t i{0}; i < 10; i++) {
+        reactor.dispatch(queue, [&executed]() { executed++; });
+    }
+
+    using namespace std::literals::chrono_literals; // NOLINT
+    do { std::this_thread::sleep_for(1ms); } while (!started.load());
+
+    std::thread unblock([&blocking]() {
+        std::this_thread::sleep_for(100ms);
+        blocking.store(false);
+    });
+
+    // Waits for the running task but drops the pending ones.
+    reactor.removeDispatchQueue(queue);
+    REQUIRE(1 == executed.load());
+    unblock.join();
+}
+
+TEST_CASE("Creating IOReactor without I/O threads for dispatching only.") {
+    cluon::IOReactor dispatcher(0, 2);
+    REQUIRE(dispatcher.isRunning());
+    REQUIRE(2 == dispatcher.numberOfDispatchThreads());
+    REQUIRE(!dispatcher.addSocket(0, []() {}));
+
+    std::atomic<uint32_t> executed{0};
+    dispatcher.dispatch(dispatcher.createDispatchQueue(), [&executed]() { executed++; });
+
+    using namespace std::literals::chrono_literals; // NOLINT
+    do { std::this_thread::sleep_for(1ms); } while (0 == executed.load());
+    REQUIRE(1 == executed.load());
+}
+
+TEST_CASE("Blocked dispatch queue does not delay other dispatch queues.") {
+    cluon::IOReactor reactor(1, 2);
+    std::atomic<bool> blocking{true};
+    std::atomic<uint32_t> executed{0};
+
+    // Regardless of their identifiers, all queues are served by any idle thread.
+    const uint32_t blockedQueue{reactor.createDispatchQueue()};
+    reactor.dispatch(blockedQueue, [&blocking]() {
+        using namespace std::literals::chrono_literals; // NOLINT
+        do { std::this_thread::sleep_for(1ms); } while (blocking.load());
+    });
+    for (uint32_t i{0}; i < 4; i++) {
+        reactor.dispatch(reactor.createDispatchQueue(), [&executed]() { executed++; });
+    }
+
+    using namespace std::literals::chrono_literals; // NOLINT
+    int32_t maxWaitingIn1Millisecond{5000};
+    do { std::this_thread::sleep_for(1ms); } while ((4 != executed.load()) && maxWaitingIn1Millisecond-- > 0);
+    CHECK(4 == executed.load());
+    blocking.store(false);
+}
@@ -0,0 +1,160 @@
+/*
+ * Copyright (C) 2017-2018  Christian Berger
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "catch.hpp"
+
+#include "cluon/Envelope.hpp"
+#include "cluon/MemoryMappedFile.hpp"
+#include "cluon/Player.hpp"
+#include "cluon/ToProtoVisitor.hpp"
+#include "cluon/cluonDataStructures.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// clang-format off
+#ifdef WIN32
+    #define UNLINK _unlink
+#else
+    #include <unistd.h>
+    #define UNLINK unlink
+#endif
+// clang-format on
+
+static void createFile(const std::string &file, const std::string &data) {
+    std::fstream out(file, std::ios::out | std::ios::binary | std::ios::trunc);
+    out.write(data.data(), static_cast<std::streamsize>(data.size()));
+}
+
+// Writes a .rec file with the given number of Envelopes.
+static void createRecFile(const std::string &recFile, uint32_t numberOfEnvelopes) {
+    std::string data;
+    for (uint32_t i{0}; i < numberOfEnvelopes; i++) {
+        cluon::data::PlayerStatus ps;
+        ps.numberOfEntries(i);
+        cluon::ToProtoVisitor protoEncoder;
+        ps.accept(protoEncoder);
+
+        cluon::data::TimeStamp ts;
+        ts.seconds(static_cast<int32_t>(i / 1000)).microseconds(static_cast<int32_t>(i % 1000) * 1000);
+        cluon::data::Envelope env;
+        env.dataType(cluon::data::PlayerStatus::ID()).serializedData(protoEncoder.encodedData()).sampleTimeStamp(ts).senderStamp(i);
+        data += cluon::serializeEnvelope(std::move(env));
+    }
+    createFile(recFile, data);
+}
+
+// Replays the complete .rec file and returns the sender stamps.
+static std::vector<uint32_t> replay(const std::string &recFile, bool memoryMapped) {
+    constexpr bool AUTO_REWIND{false};
+    constexpr bool THREADING{false};
+    cluon::Player player(recFile, AUTO_REWIND, THREADING, memoryMapped);
+    std::vector<uint32_t> senderStamps;
+    while (player.hasMoreData()) {
+        auto next = player.getNextEnvelopeToBeReplayed();
+        if (next.first) {
+            senderStamps.push_back(next.second.senderStamp());
+        }
+    }
+    return senderStamps;
+}
+
+TEST_CASE("Map a file into memory.") {
+    UNLINK("mmap1.bin");
+    const std::string DATA{"Hello World!\n"};
+    createFile("mmap1.bin", DATA);
+
+    cluon::MemoryMappedFile file{"mmap1.bin"};
+    REQUIRE(file.isMapped());
+    REQUIRE(DATA.size() == file.size());
+    REQUIRE(0 == std::memcmp(DATA.data(), file.data(), DATA.size()));
+
+    file.advise(cluon::MemoryMappedFileAccess::SEQUENTIAL);
+    file.advise(cluon::MemoryMappedFileAccess::RANDOM);
+    file.advise(cluon::MemoryMappedFileAccess::NORMAL);
+    file.prefetch(0, 1024 * 1024);
+    file.prefetch(5, 1);
+    file.prefetch(DATA.size(), 1);
+    REQUIRE(0 == std::memcmp(DATA.data(), file.data(), DATA.size()));
+
+    UNLINK("mmap1.bin");
+}
+
+TEST_CASE("Empty and missing files are not mapped.") {
+    UNLINK("mmap2.bin");
+    {
+        cluon::MemoryMappedFile file{"mmap2.bin"};
+        REQUIRE(!file.isMapped());
+        REQUIRE(nullptr == file.data());
+        REQUIRE(0 == file.size());
+        file.advise(cluon::MemoryMappedFileAccess::SEQUENTIAL);
+        file.prefetch(0, 1);
+    }
+
+    createFile("mmap2.bin", "");
+    {
+        cluon::MemoryMappedFile file{"mmap2.bin"};
+        REQUIRE(!file.isMapped());
+        REQUIRE(0 == file.size());
+    }
+
+    UNLINK("mmap2.bin");
+}
+
+TEST_CASE("Player replays the same Envelopes from a mapped .rec file as from an fstream.") {
+    UNLINK("mmap3.rec");
+    UNLINK("mmap3.rec.idx");
+
+    constexpr uint32_t NUMBER_OF_ENVELOPES{12000};
+    createRecFile("mmap3.rec", NUMBER_OF_ENVELOPES);
+
+    for (int run{0}; run < 2; run++) {
+        // The first run scans the .rec file, the second run loads the sidecar index.
+        const std::vector<uint32_t> MAPPED{replay("mmap3.rec", true)};
+        const std::vector<uint32_t> STREAMED{replay("mmap3.rec", false)};
+        REQUIRE(NUMBER_OF_ENVELOPES == MAPPED.size());
+        REQUIRE(MAPPED == STREAMED);
+        for (uint32_t i{0}; i < NUMBER_OF_ENVELOPES; i++) {
+            REQUIRE(i == MAPPED[i]);
+        }
+    }
+
+    UNLINK("mmap3.rec");
+    UNLINK("mmap3.rec.idx");
+}
+
+TEST_CASE("Benchmark replaying a mapped .rec file against an fstream.") {
+    UNLINK("mmap4.rec");
+    UNLINK("mmap4.rec.idx");
+
+    constexpr uint32_t NUMBER_OF_ENVELOPES{50000};
+    createRecFile("mmap4.rec", NUMBER_OF_ENVELOPES);
+
+    int64_t durations[2]{0, 0};
+    std::size_t replayed[2]{0, 0};
+    for (int mode{0}; mode < 2; mode++) {
+        // Remove the sidecar index to include scanning the .rec file.
+        UNLINK("mmap4.rec.idx");
+        auto before = std::chrono::steady_clock::now();
+        replayed[mode] = replay("mmap4.rec", 0 == mode).size();
+        durations[mode] = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - before).count();
+    }
+    REQUIRE(NUMBER_OF_ENVELOPES == replayed[0]);
+    REQUIRE(NUMBER_OF_ENVELOPES == replayed[1]);
+
+    std::clog << "[TestMemoryMappedFile] " << NUMBER_OF_ENVELOPES << " Envelopes: replaying from a mapped .rec file " << durations[0] / 1000
+              << " ms, from an fstream " << durations[1] / 1000 << " ms." << std::endl;
+
+    UNLINK("mmap4.rec");
+    UNLINK("mmap4.rec.idx");
+}
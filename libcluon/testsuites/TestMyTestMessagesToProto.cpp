@@ -372,3 +372,201 @@ TEST_CASE("Testing MyTestMessage7 with visitor to visit nested messages for seri
                   []() {});
     std::cout << buffer.str() << std::endl;
 }
+
+TEST_CASE("Testing ToProtoVisitor appending to a reused buffer.") {
+    std::string buffer{"HEADER"};
+    cluon::ToProtoVisitor protoEncoder{buffer};
+
+    testdata::MyTestMessage0 tmp;
+    tmp.attribute2('C');
+    tmp.accept(protoEncoder);
+    REQUIRE(4 == protoEncoder.encodedSize());
+    REQUIRE(10 == buffer.size());
+    REQUIRE("HEADER" == buffer.substr(0, 6));
+    REQUIRE(buffer.substr(6) == protoEncoder.encodedData());
+
+    // Resetting keeps the bytes in front of the encoded data and the memory.
+    const std::size_t CAPACITY{buffer.capacity()};
+    protoEncoder.reset();
+    REQUIRE(0 == protoEncoder.encodedSize());
+    REQUIRE("HEADER" == buffer);
+    tmp.accept(protoEncoder);
+    REQUIRE(10 == buffer.size());
+    REQUIRE(CAPACITY == buffer.capacity());
+
+    cluon::ToProtoVisitor protoEncoder2;
+    tmp.accept(protoEncoder2);
+    REQUIRE(protoEncoder2.encodedData() == protoEncoder.encodedData());
+}
+
+namespace {
+struct Inner {
+    std::string m_s{};
+    template <class Visitor>
+    void accept(Visitor &visitor) {
+        visitor.preVisit(1, "Inner", "Inner");
+        visitor.visit(1, "std::string", "s", m_s);
+        visitor.postVisit();
+    }
+};
+
+struct Outer {
+    Inner m_inner{};
+    uint32_t m_after{7};
+    template <class Visitor>
+    void accept(Visitor &visitor) {
+        visitor.preVisit(2, "Outer", "Outer");
+        uint32_t id{1};
+        visitor.visit(id, "Inner", "inner", m_inner);
+        visitor.visit(2, "uint32_t", "after", m_after);
+        visitor.postVisit();
+    }
+};
+} // namespace
+
+TEST_CASE("Testing ToProtoVisitor encoding nested messages with more than 127 bytes in place.") {
+    Outer outer;
+    outer.m_inner.m_s = std::string(300, 'x');
+
+    cluon::ToProtoVisitor protoEncoder;
+    outer.accept(protoEncoder);
+    const std::string s{protoEncoder.encodedData()};
+    REQUIRE(308 == s.size());
+
+    // Nested message: key, length (303 as VarInt), and its field s with length 300.
+    REQUIRE(0x0A == static_cast<uint8_t>(s.at(0)));
+    REQUIRE(0xAF == static_cast<uint8_t>(s.at(1)));
+    REQUIRE(0x02 == static_cast<uint8_t>(s.at(2)));
+    REQUIRE(0x0A == static_cast<uint8_t>(s.at(3)));
+    REQUIRE(0xAC == static_cast<uint8_t>(s.at(4)));
+    REQUIRE(0x02 == static_cast<uint8_t>(s.at(5)));
+    REQUIRE(std::string(300, 'x') == s.substr(6, 300));
+    REQUIRE(0x10 == static_cast<uint8_t>(s.at(306)));
+    REQUIRE(0x07 == static_cast<uint8_t>(s.at(307)));
+}
+
+TEST_CASE("Testing FromProtoVisitor decoding MyTestMessage1 directly from memory.") {
+    testdata::MyTestMessage1 tmp;
+    tmp.attribute7(-123456).attribute9(-1234567890123).attribute11(1.5f).attribute12(-2.25).attribute13(std::string(200, 'a')).attribute14("bytes");
+
+    cluon::ToProtoVisitor protoEncoder;
+    tmp.accept(protoEncoder);
+    const std::string s{protoEncoder.encodedData()};
+
+    testdata::MyTestMessage1 tmp2;
+    tmp2.attribute13("").attribute14("");
+    cluon::FromProtoVisitor protoDecoder;
+    REQUIRE(protoDecoder.decodeFrom(s.data(), s.size(), tmp2));
+    REQUIRE(-123456 == tmp2.attribute7());
+    REQUIRE(-1234567890123 == tmp2.attribute9());
+    REQUIRE(1.5f == Approx(tmp2.attribute11()));
+    REQUIRE(-2.25 == Approx(tmp2.attribute12()));
+    REQUIRE(std::string(200, 'a') == tmp2.attribute13());
+    REQUIRE("bytes" == tmp2.attribute14());
+
+    // Decoding into the map of key/values.
+    testdata::MyTestMessage1 tmp3;
+    REQUIRE(protoDecoder.decodeFrom(s.data(), s.size()));
+    tmp3.accept(protoDecoder);
+    REQUIRE(-123456 == tmp3.attribute7());
+    REQUIRE(std::string(200, 'a') == tmp3.attribute13());
+
+    // Empty input is well-formed.
+    REQUIRE(protoDecoder.decodeFrom(nullptr, 0, tmp3));
+}
+
+TEST_CASE("Testing FromProtoVisitor decoding nested messages directly from memory.") {
+    testdata::MyTestMessage7 tmp7;
+    testdata::MyTestMessage2 tmp2_1;
+    tmp7.attribute1(tmp2_1.attribute1(9)).attribute2(12);
+    testdata::MyTestMessage2 tmp2_3;
+    tmp7.attribute3(tmp2_3.attribute1(13));
+
+    cluon::ToProtoVisitor protoEncoder;
+    tmp7.accept(protoEncoder);
+    const std::string s{protoEncoder.encodedData()};
+
+    testdata::MyTestMessage7 tmp7_2;
+    cluon::FromProtoVisitor protoDecoder;
+    REQUIRE(protoDecoder.decodeFrom(s.data(), s.size(), tmp7_2));
+    REQUIRE(9 == tmp7_2.attribute1().attribute1());
+    REQUIRE(12 == tmp7_2.attribute2());
+    REQUIRE(13 == tmp7_2.attribute3().attribute1());
+
+    // A nested message claiming more bytes than available is malformed; as
+    // the outer length is still consistent, only the nested decoder notices.
+    std::string nestedMalformed{s};
+    nestedMalformed[2] = static_cast<char>(0x08 | 0x02); // Field 1 as length-delimited...
+    nestedMalformed[3] = 0x05;                           // ...with 5 bytes in a 2-byte message.
+    testdata::MyTestMessage7 tmp7_3;
+    REQUIRE(!protoDecoder.decodeFrom(nestedMalformed.data(), nestedMalformed.size(), tmp7_3));
+}
+
+TEST_CASE("Testing FromProtoVisitor reporting malformed input in memory.") {
+    testdata::MyTestMessage1 tmp;
+    cluon::ToProtoVisitor protoEncoder;
+    tmp.accept(protoEncoder);
+    const std::string s{protoEncoder.encodedData()};
+
+    cluon::FromProtoVisitor protoDecoder;
+    testdata::MyTestMessage1 tmp2;
+    // Truncated inside the last field.
+    REQUIRE(!protoDecoder.decodeFrom(s.data(), s.size() - 1, tmp2));
+    REQUIRE(!protoDecoder.decodeFrom(s.data(), s.size() - 1));
+
+    // Unknown Proto type 3.
+    const std::string unknownType{"\x0B\x01", 2};
+    REQUIRE(!protoDecoder.decodeFrom(unknownType.data(), unknownType.size(), tmp2));
+    REQUIRE(!protoDecoder.decodeFrom(unknownType.data(), unknownType.size()));
+
+    // VarInt longer than 10 bytes.
+    const std::string tooLong{"\x08\xFF\xFF\xFF\xFF\xFF\xFF\xFF\xFF\xFF\xFF\x01", 12};
+    REQUIRE(!protoDecoder.decodeFrom(tooLong.data(), tooLong.size(), tmp2));
+
+    // Length-delimited field exceeding the available bytes.
+    const std::string tooShort{"\x6A\x05" "abc", 5};
+    REQUIRE(!protoDecoder.decodeFrom(tooShort.data(), tooShort.size(), tmp2));
+}
+
+TEST_CASE("Testing FromProtoVisitor's field table when visiting after decoding.") {
+    // Field 1 twice (the first one is visited), field 2 as float instead of
+    // char (ignored), and field 2000 beyond the directly indexed fields.
+    const std::string s{"\x08\x00" "\x08\x01" "\x15\x00\x00\x80\x3F" "\x80\x7D\x07", 12};
+
+    cluon::FromProtoVisitor protoDecoder;
+    REQUIRE(protoDecoder.decodeFrom(s.data(), s.size()));
+
+    testdata::MyTestMessage0 tmp;
+    REQUIRE(tmp.attribute1());
+    REQUIRE('c' == tmp.attribute2());
+    tmp.accept(protoDecoder);
+    REQUIRE(!tmp.attribute1());
+    REQUIRE('c' == tmp.attribute2());
+
+    uint32_t v{0};
+    protoDecoder.visit(2000, "uint32_t", "v", v);
+    REQUIRE(7 == v);
+
+    // Reusing the decoder forgets the previous fields.
+    const std::string s2{"\x10\x41", 2};
+    REQUIRE(protoDecoder.decodeFrom(s2.data(), s2.size()));
+    testdata::MyTestMessage0 tmp2;
+    tmp2.accept(protoDecoder);
+    REQUIRE(tmp2.attribute1());
+    REQUIRE('A' == tmp2.attribute2());
+    v = 0;
+    protoDecoder.visit(2000, "uint32_t", "v", v);
+    REQUIRE(0 == v);
+
+    // Copies of the decoder do not depend on the decoded bytes.
+    cluon::FromProtoVisitor protoDecoder2;
+    {
+        std::stringstream sstr{std::string{"\x10\x42", 2}};
+        cluon::FromProtoVisitor protoDecoder3;
+        protoDecoder3.decodeFrom(sstr);
+        protoDecoder2 = protoDecoder3;
+    }
+    testdata::MyTestMessage0 tmp3;
+    tmp3.accept(protoDecoder2);
+    REQUIRE('B' == tmp3.attribute2());
+}
@@ -12,9 +12,13 @@
 
 #include <atomic>
 #include <chrono>
+#include <ctime>
+#include <iostream>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <thread>
+#include <vector>
 
 TEST_CASE("Creating a NotifyingPipeline and stop immediately.") {
     cluon::NotifyingPipeline<std::string> pipeline(nullptr);
@@ -47,3 +51,207 @@ TEST_CASE("Creating a NotifyingPipeline, add one entry, and get notified.") {
         REQUIRE("Hello World" == data);
     } catch (...) { REQUIRE(false); } // LCOV_EXCL_LINE
 }
+
+TEST_CASE("Creating a NotifyingPipeline with SPSC ring buffer and move-only entries.") {
+    using namespace std::literals::chrono_literals; // NOLINT
+    std::atomic<bool> blocked{true};
+    std::atomic<uint32_t> sum{0};
+    cluon::NotifyingPipeline<std::unique_ptr<uint32_t>> pipeline(
+        [&blocked, &sum](std::unique_ptr<uint32_t> &&entry) {
+            sum += *entry;
+            // Keep the pipeline's thread busy with the first entry.
+            while (blocked.load()) { std::this_thread::sleep_for(1ms); }
+        },
+        cluon::NotifyingPipelineType::SPSC_RING_BUFFER,
+        4);
+    REQUIRE(pipeline.isRunning());
+
+    REQUIRE(pipeline.add(std::unique_ptr<uint32_t>(new uint32_t(1))));
+    pipeline.notifyAll();
+    do { std::this_thread::sleep_for(1ms); } while (sum.load() < 1);
+
+    // The ring buffer is bounded: the sixth entry does not fit until the pipeline has processed entries.
+    for (uint32_t i{2}; i <= 5; i++) { REQUIRE(pipeline.add(std::unique_ptr<uint32_t>(new uint32_t(i)))); }
+    std::unique_ptr<uint32_t> sixth(new uint32_t(6));
+    REQUIRE(!pipeline.add(std::move(sixth)));
+    REQUIRE(nullptr != sixth);
+    REQUIRE(4 == pipeline.size());
+
+    blocked.store(false);
+    pipeline.notifyAll();
+    do { std::this_thread::sleep_for(1ms); } while (sum.load() < 15);
+
+    REQUIRE(pipeline.add(std::move(sixth)));
+    pipeline.notifyAll();
+    do { std::this_thread::sleep_for(1ms); } while (sum.load() < 21);
+    REQUIRE(21 == sum.load());
+    REQUIRE(1 == pipeline.numberOfDroppedEntries());
+}
+
+TEST_CASE("Overflow policies of NotifyingPipeline.") {
+    using namespace std::literals::chrono_literals; // NOLINT
+    for (auto type : {cluon::NotifyingPipelineType::DEQUE, cluon::NotifyingPipelineType::SPSC_RING_BUFFER}) {
+        for (auto policy : {cluon::NotifyingPipelineOverflowPolicy::DROP_OLDEST,
+                            cluon::NotifyingPipelineOverflowPolicy::DROP_NEWEST,
+                            cluon::NotifyingPipelineOverflowPolicy::BLOCK_PRODUCER}) {
+            std::atomic<bool> blocked{true};
+            std::mutex receivedMutex;
+            std::vector<uint32_t> received;
+            cluon::NotifyingPipeline<uint32_t> pipeline(
+                [&blocked, &receivedMutex, &received](uint32_t &&entry) {
+                    {
+                        std::lock_guard<std::mutex> lck(receivedMutex);
+                        received.push_back(entry);
+                    }
+                    // Keep the pipeline's thread busy with the first entry.
+                    while (blocked.load()) { std::this_thread::sleep_for(1ms); }
+                },
+                type);
+            pipeline.setCapacity(3, policy);
+
+            REQUIRE(pipeline.add(0));
+            pipeline.notifyAll();
+            bool started{false};
+            do {
+                std::this_thread::sleep_for(1ms);
+                std::lock_guard<std::mutex> lck(receivedMutex);
+                started = !received.empty();
+            } while (!started);
+
+            // For DEQUE, the entry being processed counts against the capacity.
+            const bool COUNTS_IN_FLIGHT{cluon::NotifyingPipelineType::DEQUE == type};
+            REQUIRE((COUNTS_IN_FLIGHT ? 1 : 0) == pipeline.size());
+            const uint32_t LAST{COUNTS_IN_FLIGHT ? 2u : 3u};
+            for (uint32_t i{1}; i <= LAST; i++) { REQUIRE(pipeline.add(std::move(i))); }
+            REQUIRE(3 == pipeline.size());
+
+            std::atomic<bool> added{false};
+            std::thread producer([&pipeline, &added, LAST]() noexcept { added.store(pipeline.add(LAST + 1)); });
+            if (cluon::NotifyingPipelineOverflowPolicy::BLOCK_PRODUCER == policy) {
+                // The producer waits until the pipeline's thread has made room without spinning.
+                const std::clock_t cpuTimeBefore{std::clock()};
+                std::this_thread::sleep_for(100ms);
+                const std::clock_t cpuTimeAfter{std::clock()};
+                REQUIRE(!added.load());
+                REQUIRE(static_cast<double>(cpuTimeAfter - cpuTimeBefore) / CLOCKS_PER_SEC < 0.05);
+                blocked.store(false);
+            }
+            producer.join();
+            blocked.store(false);
+            pipeline.notifyAll();
+
+            const bool DROPS_OLDEST{(cluon::NotifyingPipelineOverflowPolicy::DROP_OLDEST == policy) && (cluon::NotifyingPipelineType::DEQUE == type)};
+            const bool DROPS_NEWEST{(cluon::NotifyingPipelineOverflowPolicy::DROP_NEWEST == policy)
+                                    || ((cluon::NotifyingPipelineOverflowPolicy::DROP_OLDEST == policy) && (cluon::NotifyingPipelineType::DEQUE != type))};
+            REQUIRE(added.load() == !DROPS_NEWEST);
+            REQUIRE(((DROPS_OLDEST || DROPS_NEWEST) ? 1 : 0) == pipeline.numberOfDroppedEntries());
+
+            std::vector<uint32_t> EXPECTED;
+            for (uint32_t i{0}; i <= LAST + 1; i++) {
+                if (!((DROPS_OLDEST && (1 == i)) || (DROPS_NEWEST && ((LAST + 1) == i)))) { EXPECTED.push_back(i); }
+            }
+            bool done{false};
+            do {
+                std::this_thread::sleep_for(1ms);
+                std::lock_guard<std::mutex> lck(receivedMutex);
+                done = (received.size() >= EXPECTED.size());
+            } while (!done);
+            std::this_thread::sleep_for(10ms);
+            std::lock_guard<std::mutex> lck(receivedMutex);
+            REQUIRE(EXPECTED == received);
+            REQUIRE(0 == pipeline.size());
+        }
+    }
+}
+
+TEST_CASE("Bounded NotifyingPipeline does not exceed its capacity while processing entries.") {
+    constexpr uint32_t NUMBER_OF_ENTRIES{10 * 1000};
+    constexpr std::size_t CAPACITY{4};
+
+    for (auto type : {cluon::NotifyingPipelineType::DEQUE, cluon::NotifyingPipelineType::SPSC_RING_BUFFER}) {
+        std::atomic<uint32_t> received{0};
+        std::atomic<std::size_t> maxSize{0};
+        cluon::NotifyingPipeline<uint32_t> *pipelinePtr{nullptr};
+        cluon::NotifyingPipeline<uint32_t> pipeline(
+            [&received, &maxSize, &pipelinePtr](uint32_t &&) {
+                const std::size_t SIZE{pipelinePtr->size()};
+                if (SIZE > maxSize.load()) { maxSize.store(SIZE); }
+                received++;
+            },
+            type);
+        pipelinePtr = &pipeline;
+        pipeline.setCapacity(CAPACITY, cluon::NotifyingPipelineOverflowPolicy::BLOCK_PRODUCER);
+
+        for (uint32_t i{0}; i < NUMBER_OF_ENTRIES; i++) {
+            REQUIRE(pipeline.add(std::move(i)));
+            REQUIRE(pipeline.size() <= CAPACITY);
+            pipeline.notifyAll();
+        }
+        while (NUMBER_OF_ENTRIES != received.load()) { std::this_thread::sleep_for(std::chrono::milliseconds(1)); }
+
+        // An entry of a DEQUE counts against the capacity until it has been processed.
+        REQUIRE(((cluon::NotifyingPipelineType::DEQUE == type) ? 1 : 0) <= maxSize.load());
+        REQUIRE(CAPACITY >= maxSize.load());
+        REQUIRE(0 == pipeline.numberOfDroppedEntries());
+    }
+}
+
+TEST_CASE("Benchmark throughput and latency of NotifyingPipeline.") {
+    constexpr uint32_t NUMBER_OF_ENTRIES{1000 * 1000};
+    constexpr uint32_t BATCH_SIZE{16};
+    constexpr uint32_t NUMBER_OF_PINGS{10 * 1000};
+
+    for (auto type : {cluon::NotifyingPipelineType::DEQUE, cluon::NotifyingPipelineType::SPSC_RING_BUFFER}) {
+        const std::string NAME{(cluon::NotifyingPipelineType::DEQUE == type) ? "deque" : "SPSC ring buffer"};
+
+        // Throughput: add entries in batches of BATCH_SIZE like UDPReceiver does.
+        {
+            std::atomic<uint32_t> received{0};
+            cluon::NotifyingPipeline<std::string> pipeline([&received](std::string &&) { received++; }, type);
+            REQUIRE(pipeline.isRunning());
+
+            const auto before = std::chrono::steady_clock::now();
+            for (uint32_t i{0}; i < NUMBER_OF_ENTRIES; i++) {
+                std::string entry(64, 'x');
+                while (!pipeline.add(std::move(entry))) {
+                    // The ring buffer is full; let the pipeline catch up.
+                    pipeline.notifyAll();
+                    std::this_thread::yield();
+                }
+                if (0 == ((i + 1) % BATCH_SIZE)) {
+                    pipeline.notifyAll();
+                }
+            }
+            pipeline.notifyAll();
+            do { std::this_thread::yield(); } while (received.load() < NUMBER_OF_ENTRIES);
+            const auto after = std::chrono::steady_clock::now();
+
+            const double durationInSeconds{std::chrono::duration_cast<std::chrono::duration<double>>(after - before).count()};
+            std::clog << "[TestNotifyingPipeline] Throughput (" << NAME << "): " << (NUMBER_OF_ENTRIES / durationInSeconds) << " entries/s." << std::endl;
+            REQUIRE(NUMBER_OF_ENTRIES == received.load());
+        }
+
+        // Latency: time between adding and processing a single entry.
+        {
+            std::atomic<uint32_t> received{0};
+            std::atomic<int64_t> totalLatencyInNanoseconds{0};
+            cluon::NotifyingPipeline<std::chrono::steady_clock::time_point> pipeline(
+                [&received, &totalLatencyInNanoseconds](std::chrono::steady_clock::time_point &&sent) {
+                    totalLatencyInNanoseconds += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - sent).count();
+                    received++;
+                },
+                type);
+            REQUIRE(pipeline.isRunning());
+
+            for (uint32_t i{0}; i < NUMBER_OF_PINGS; i++) {
+                pipeline.add(std::chrono::steady_clock::now());
+                pipeline.notifyAll();
+                do { std::this_thread::yield(); } while (received.load() < (i + 1));
+            }
+
+            std::clog << "[TestNotifyingPipeline] Latency (" << NAME << "): " << (totalLatencyInNanoseconds.load() / NUMBER_OF_PINGS) << " ns on average."
+                      << std::endl;
+            REQUIRE(NUMBER_OF_PINGS == received.load());
+        }
+    }
+}
@@ -8,11 +8,14 @@
 
 #include "catch.hpp"
 
+#include "cluon/Arena.hpp"
 #include "cluon/Envelope.hpp"
+#include "cluon/EnvelopeView.hpp"
 #include "cluon/FromProtoVisitor.hpp"
 #include "cluon/OD4Session.hpp"
 #include "cluon/Time.hpp"
 #include "cluon/cluonDataStructures.hpp"
+#include "cluon/cluonTestDataStructures.hpp"
 
 #include <iostream>
 
@@ -499,3 +502,424 @@ TEST_CASE("Create OD4 session with dataTrigger and transmission storm from 5 thr
 #endif
 #endif
 }
+
+TEST_CASE("Create several OD4 sessions sharing one IOReactor.") {
+    constexpr uint16_t NUMBER_OF_SESSIONS{5};
+    constexpr uint16_t FIRST_CID{150};
+    auto reactor = std::make_shared<cluon::IOReactor>(2, 2);
+    REQUIRE(reactor->isRunning());
+
+    std::atomic<uint32_t> receivedInOrder[NUMBER_OF_SESSIONS];
+    std::vector<std::unique_ptr<cluon::OD4Session>> sessions;
+    for (uint16_t i{0}; i < NUMBER_OF_SESSIONS; i++) {
+        receivedInOrder[i] = 0;
+        auto &counter      = receivedInOrder[i];
+        sessions.emplace_back(new cluon::OD4Session(static_cast<uint16_t>(FIRST_CID + i),
+                                                    [&counter](cluon::data::Envelope &&envelope) {
+                                                        // Envelopes of one session must be delivered in order.
+                                                        auto ts = cluon::extractMessage<cluon::data::TimeStamp>(std::move(envelope));
+                                                        if (static_cast<uint32_t>(ts.microseconds()) == counter.load()) {
+                                                            counter++;
+                                                        }
+                                                    },
+                                                    reactor));
+        REQUIRE(sessions.back()->isRunning());
+    }
+
+    constexpr int32_t MAX_ENVELOPES{10};
+    for (uint16_t i{0}; i < NUMBER_OF_SESSIONS; i++) {
+        cluon::OD4Session od4ToSendFrom(static_cast<uint16_t>(FIRST_CID + i));
+        for (int32_t j{0}; j < MAX_ENVELOPES; j++) {
+            cluon::data::TimeStamp tsSampleTime;
+            tsSampleTime.seconds(0).microseconds(j);
+            od4ToSendFrom.send(tsSampleTime);
+        }
+    }
+
+    using namespace std::literals::chrono_literals; // NOLINT
+    int32_t maxWaitingIn10Milliseconds{500};
+    bool allReceived{false};
+    do {
+        std::this_thread::sleep_for(10ms);
+        allReceived = true;
+        for (uint16_t i{0}; i < NUMBER_OF_SESSIONS; i++) { allReceived &= (MAX_ENVELOPES == static_cast<int32_t>(receivedInOrder[i].load())); }
+    } while (!allReceived && maxWaitingIn10Milliseconds-- > 0);
+    REQUIRE(allReceived);
+
+    // Sessions can be destroyed while the shared IOReactor continues to run.
+    sessions.clear();
+    REQUIRE(reactor->isRunning());
+}
+
+TEST_CASE("Create OD4 session dispatching data-triggered delegates to worker threads.") {
+    cluon::OD4Session od4(160);
+    REQUIRE(od4.setDispatchMode(cluon::OD4SessionDispatchMode::PER_MESSAGE_IDENTIFIER_AND_SENDER_STAMP, 2));
+
+    // A slow delegate for TimeStamp must not delay the delegate for PlayerStatus.
+    std::atomic<bool> blocking{true};
+    std::atomic<uint32_t> timeStampsReceived{0};
+    REQUIRE(od4.dataTrigger(cluon::data::TimeStamp::ID(), [&blocking, &timeStampsReceived](cluon::data::Envelope &&) {
+        using namespace std::literals::chrono_literals; // NOLINT
+        do { std::this_thread::sleep_for(1ms); } while (blocking.load());
+        timeStampsReceived++;
+    }));
+
+    // PlayerStatus messages must be delivered in order per sender stamp.
+    constexpr uint32_t NUMBER_OF_SENDER_STAMPS{3};
+    std::atomic<uint32_t> receivedInOrder[NUMBER_OF_SENDER_STAMPS];
+    for (uint32_t i{0}; i < NUMBER_OF_SENDER_STAMPS; i++) { receivedInOrder[i] = 0; }
+    REQUIRE(od4.dataTrigger(cluon::data::PlayerStatus::ID(), [&receivedInOrder](cluon::data::Envelope &&envelope) {
+        const uint32_t SENDER_STAMP{envelope.senderStamp()};
+        auto ps = cluon::extractMessage<cluon::data::PlayerStatus>(std::move(envelope));
+        if ((SENDER_STAMP < NUMBER_OF_SENDER_STAMPS) && (ps.currentEntryForPlayback() == receivedInOrder[SENDER_STAMP].load())) {
+            receivedInOrder[SENDER_STAMP]++;
+        }
+    }));
+
+    using namespace std::literals::chrono_literals; // NOLINT
+    do { std::this_thread::sleep_for(1ms); } while (!od4.isRunning());
+
+    cluon::OD4Session od4ToSendFrom(160);
+    do { std::this_thread::sleep_for(1ms); } while (!od4ToSendFrom.isRunning());
+
+    cluon::data::TimeStamp ts;
+    od4ToSendFrom.send(ts);
+
+    constexpr uint32_t MAX_ENVELOPES{10};
+    for (uint32_t j{0}; j < MAX_ENVELOPES; j++) {
+        for (uint32_t i{0}; i < NUMBER_OF_SENDER_STAMPS; i++) {
+            cluon::data::PlayerStatus ps;
+            ps.currentEntryForPlayback(j);
+            od4ToSendFrom.send(ps, cluon::data::TimeStamp(), i);
+        }
+    }
+
+    int32_t maxWaitingIn10Milliseconds{500};
+    bool allReceived{false};
+    do {
+        std::this_thread::sleep_for(10ms);
+        allReceived = true;
+        for (uint32_t i{0}; i < NUMBER_OF_SENDER_STAMPS; i++) { allReceived &= (MAX_ENVELOPES == receivedInOrder[i].load()); }
+    } while (!allReceived && maxWaitingIn10Milliseconds-- > 0);
+
+    // The TimeStamp delegate is still blocked; CHECK to unblock it in any case.
+    CHECK(allReceived);
+    CHECK(0 == timeStampsReceived.load());
+    blocking.store(false);
+    do { std::this_thread::sleep_for(1ms); } while (0 == timeStampsReceived.load());
+
+    auto statistics = od4.dataTriggerStatistics();
+    REQUIRE(2 == statistics.size());
+    REQUIRE(1 == statistics[cluon::data::TimeStamp::ID()].m_numberOfCalls);
+    REQUIRE(statistics[cluon::data::TimeStamp::ID()].m_maximumExecutionTime >= std::chrono::milliseconds(1));
+    REQUIRE(statistics[cluon::data::TimeStamp::ID()].m_totalExecutionTime == statistics[cluon::data::TimeStamp::ID()].m_maximumExecutionTime);
+    REQUIRE(NUMBER_OF_SENDER_STAMPS * MAX_ENVELOPES == statistics[cluon::data::PlayerStatus::ID()].m_numberOfCalls);
+
+    // Switch back to calling the delegates from the receiving thread.
+    REQUIRE(od4.setDispatchMode(cluon::OD4SessionDispatchMode::PIPELINE_THREAD));
+}
+
+TEST_CASE("Create OD4 session changing data-triggered delegates while receiving.") {
+    std::atomic<uint32_t> numberOfTimeStamps{0};
+    std::atomic<uint32_t> numberOfPlayerStatus{0};
+
+    cluon::OD4Session od4(161);
+    REQUIRE(od4.dataTrigger(cluon::data::TimeStamp::ID(), [&od4, &numberOfTimeStamps, &numberOfPlayerStatus](cluon::data::Envelope &&) {
+        // Registering a delegate from within a delegate must not block.
+        if (0 == numberOfTimeStamps++) {
+            od4.dataTrigger(cluon::data::PlayerStatus::ID(), [&numberOfPlayerStatus](cluon::data::Envelope &&) { numberOfPlayerStatus++; });
+        }
+    }));
+
+    using namespace std::literals::chrono_literals; // NOLINT
+    do { std::this_thread::sleep_for(1ms); } while (!od4.isRunning());
+
+    cluon::OD4Session od4ToSendFrom(161);
+    do { std::this_thread::sleep_for(1ms); } while (!od4ToSendFrom.isRunning());
+
+    // Replace unrelated delegates and the dispatch mode while Envelopes are arriving.
+    std::atomic<bool> changing{true};
+    std::thread changer([&od4, &changing]() {
+        uint32_t i{0};
+        while (changing.load()) {
+            od4.dataTrigger(cluon::data::PlayerCommand::ID(), (0 == (i % 2)) ? [](cluon::data::Envelope &&) {} : std::function<void(cluon::data::Envelope &&)>{nullptr});
+            if (0 == (i % 50)) {
+                od4.setDispatchMode((0 == (i % 100)) ? cluon::OD4SessionDispatchMode::PER_MESSAGE_IDENTIFIER : cluon::OD4SessionDispatchMode::PIPELINE_THREAD, 1);
+            }
+            i++;
+            std::this_thread::sleep_for(1ms);
+        }
+    });
+
+    constexpr uint32_t MAX_ENVELOPES{200};
+    for (uint32_t i{0}; i < MAX_ENVELOPES; i++) {
+        cluon::data::TimeStamp ts;
+        ts.microseconds(static_cast<int32_t>(i));
+        od4ToSendFrom.send(ts);
+        cluon::data::PlayerStatus ps;
+        od4ToSendFrom.send(ps);
+        std::this_thread::sleep_for(1ms);
+    }
+
+    // Wait for processing the sent data.
+    int32_t timeout{100};
+    while ((numberOfTimeStamps.load() < MAX_ENVELOPES / 2) && (timeout-- > 0)) { std::this_thread::sleep_for(50ms); }
+    changing.store(false);
+    changer.join();
+
+    REQUIRE(0 < numberOfTimeStamps.load());
+    REQUIRE(0 < numberOfPlayerStatus.load());
+
+    auto statistics = od4.dataTriggerStatistics();
+    REQUIRE(2 <= statistics.size());
+    REQUIRE(0 < statistics[cluon::data::TimeStamp::ID()].m_numberOfCalls);
+}
+
+TEST_CASE("Create OD4 session changing the dispatch mode from within a delegate running on a worker thread.") {
+    std::atomic<uint32_t> numberOfPlayerStatus{0};
+    std::atomic<bool> changed{false};
+
+    cluon::OD4Session od4(211);
+    REQUIRE(od4.setDispatchMode(cluon::OD4SessionDispatchMode::PER_MESSAGE_IDENTIFIER, 2));
+    REQUIRE(od4.dataTrigger(cluon::data::PlayerStatus::ID(), [&od4, &numberOfPlayerStatus, &changed](cluon::data::Envelope &&) {
+        // The first call releases the worker threads including the calling one.
+        if (0 == numberOfPlayerStatus++) {
+            changed.store(od4.setDispatchMode(cluon::OD4SessionDispatchMode::PIPELINE_THREAD));
+        }
+    }));
+
+    using namespace std::literals::chrono_literals; // NOLINT
+    do { std::this_thread::sleep_for(1ms); } while (!od4.isRunning());
+
+    cluon::OD4Session od4ToSendFrom(211);
+    do { std::this_thread::sleep_for(1ms); } while (!od4ToSendFrom.isRunning());
+
+    // Envelopes are still delivered after switching back to the receiving thread.
+    int32_t timeout{100};
+    do {
+        cluon::data::PlayerStatus ps;
+        od4ToSendFrom.send(ps);
+        std::this_thread::sleep_for(10ms);
+    } while ((numberOfPlayerStatus.load() < 3) && (timeout-- > 0));
+    REQUIRE(changed.load());
+    REQUIRE(3 <= numberOfPlayerStatus.load());
+}
+
+TEST_CASE("Create OD4 session with typed dataTrigger decoding messages directly.") {
+    std::mutex receivingMutex;
+    std::vector<std::pair<cluon::data::PlayerStatus, cluon::EnvelopeMeta>> receiving;
+    std::atomic<uint32_t> callsInsideArenaScope{0};
+
+    cluon::OD4Session od4(162);
+    REQUIRE(od4.dataTrigger<cluon::data::PlayerStatus>(
+        [&receivingMutex, &receiving, &callsInsideArenaScope](cluon::data::PlayerStatus &&msg, const cluon::EnvelopeMeta &meta) {
+            // Objects created by the delegate must not be taken from an Arena.
+            if (nullptr != cluon::Arena::current()) {
+                callsInsideArenaScope++;
+            }
+            std::lock_guard<std::mutex> lck(receivingMutex);
+            receiving.emplace_back(std::move(msg), meta);
+        }));
+
+    using namespace std::literals::chrono_literals; // NOLINT
+    do { std::this_thread::sleep_for(1ms); } while (!od4.isRunning());
+
+    cluon::OD4Session od4ToSendFrom(162);
+    do { std::this_thread::sleep_for(1ms); } while (!od4ToSendFrom.isRunning());
+
+    cluon::data::TimeStamp sampleTimeStamp;
+    sampleTimeStamp.seconds(-12).microseconds(345);
+    cluon::data::PlayerStatus ps;
+    ps.state(2).numberOfEntries(100).currentEntryForPlayback(42);
+
+    // First, the delegate is called from the receiving thread; second, from a worker thread.
+    for (uint32_t round{0}; round < 2; round++) {
+        if (1 == round) {
+            REQUIRE(od4.setDispatchMode(cluon::OD4SessionDispatchMode::PER_MESSAGE_IDENTIFIER, 1));
+        }
+        od4ToSendFrom.send(ps, sampleTimeStamp, 7 + round);
+
+        int32_t timeout{100};
+        bool received{false};
+        do {
+            std::this_thread::sleep_for(10ms);
+            std::lock_guard<std::mutex> lck(receivingMutex);
+            received = (round < receiving.size());
+        } while (!received && (timeout-- > 0));
+        REQUIRE(received);
+
+        std::lock_guard<std::mutex> lck(receivingMutex);
+        REQUIRE(2 == receiving[round].first.state());
+        REQUIRE(100 == receiving[round].first.numberOfEntries());
+        REQUIRE(42 == receiving[round].first.currentEntryForPlayback());
+        REQUIRE(cluon::data::PlayerStatus::ID() == receiving[round].second.m_dataType);
+        REQUIRE(7 + round == receiving[round].second.m_senderStamp);
+        REQUIRE(-12 == receiving[round].second.m_sampleTimeStamp.seconds());
+        REQUIRE(345 == receiving[round].second.m_sampleTimeStamp.microseconds());
+        REQUIRE(0 < receiving[round].second.m_sent.seconds());
+        REQUIRE(0 < receiving[round].second.m_received.seconds());
+    }
+    REQUIRE(1 == od4.dataTriggerStatistics().size());
+    REQUIRE(2 == od4.dataTriggerStatistics()[cluon::data::PlayerStatus::ID()].m_numberOfCalls);
+    REQUIRE(0 == callsInsideArenaScope);
+
+    // Erase the typed delegate.
+    REQUIRE(od4.dataTrigger<cluon::data::PlayerStatus>(nullptr));
+    REQUIRE(od4.dataTriggerStatistics().empty());
+}
+
+TEST_CASE("Benchmark typed dataTrigger against Envelope with extractMessage.") {
+    testdata::MyTestMessage1 msg;
+    cluon::ToProtoVisitor protoEncoder;
+    msg.accept(protoEncoder);
+
+    cluon::data::Envelope env;
+    env.dataType(testdata::MyTestMessage1::ID()).serializedData(protoEncoder.encodedData()).sent(cluon::time::now()).sampleTimeStamp(cluon::time::now());
+    const std::string serialized{cluon::serializeEnvelope(std::move(env))};
+
+    // Both variants decode the received bytes as done by OD4Session for the respective delegate.
+    constexpr uint32_t ITERATIONS{20000};
+    uint64_t sum{0};
+    auto before = std::chrono::steady_clock::now();
+    for (uint32_t i{0}; i < ITERATIONS; i++) {
+        auto retVal = cluon::extractEnvelope(serialized.data(), serialized.size());
+        auto m      = cluon::extractMessage<testdata::MyTestMessage1>(std::move(retVal.second));
+        sum += m.attribute8();
+    }
+    auto twoSteps = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - before).count();
+
+    before = std::chrono::steady_clock::now();
+    for (uint32_t i{0}; i < ITERATIONS; i++) {
+        cluon::EnvelopeMeta meta;
+        const char *serializedData{nullptr};
+        std::size_t serializedDataSize{0};
+        cluon::peekEnvelope(serialized.data(), serialized.size(), meta, serializedData, serializedDataSize);
+        cluon::FromProtoVisitor protoDecoder;
+        testdata::MyTestMessage1 m;
+        protoDecoder.decodeFrom(serializedData, serializedDataSize, m);
+        sum -= m.attribute8();
+    }
+    auto typed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - before).count();
+
+    std::clog << "[TestOD4Session] Decoding MyTestMessage1: Envelope with extractMessage " << twoSteps / ITERATIONS << " ns, typed dataTrigger "
+              << typed / ITERATIONS << " ns per message." << std::endl;
+    REQUIRE(0 == sum);
+}
+
+TEST_CASE("Create OD4 session and transmit data as batch.") {
+    constexpr uint32_t NUMBER_OF_MESSAGES{150};
+    std::mutex receivingMutex;
+    std::vector<cluon::data::Envelope> receiving;
+
+    cluon::OD4Session od4(163, [&receivingMutex, &receiving](cluon::data::Envelope &&envelope) {
+        std::lock_guard<std::mutex> lck(receivingMutex);
+        receiving.emplace_back(std::move(envelope));
+    });
+    using namespace std::literals::chrono_literals; // NOLINT
+    do { std::this_thread::sleep_for(1ms); } while (!od4.isRunning());
+
+    cluon::OD4Session od4ToSendFrom(163);
+    do { std::this_thread::sleep_for(1ms); } while (!od4ToSendFrom.isRunning());
+
+    {
+        cluon::OD4Session::Batch batch{od4ToSendFrom};
+        REQUIRE(0 == batch.size());
+        cluon::data::PlayerStatus ps;
+        for (uint32_t i{0}; i < NUMBER_OF_MESSAGES; i++) {
+            ps.currentEntryForPlayback(i);
+            REQUIRE(batch.send(ps, cluon::data::TimeStamp(), i));
+
+            // An Envelope exceeding one UDP datagram is rejected and must not fail the other ones.
+            if (NUMBER_OF_MESSAGES / 2 == i) {
+                cluon::data::Envelope tooLarge;
+                tooLarge.dataType(cluon::data::PlayerStatus::ID()).serializedData(std::string(70000, 'x'));
+                REQUIRE(!batch.send(std::move(tooLarge)));
+            }
+        }
+        REQUIRE(NUMBER_OF_MESSAGES == batch.size());
+
+        auto retVal = batch.flush();
+        REQUIRE(NUMBER_OF_MESSAGES == retVal.first);
+        REQUIRE(0 == retVal.second);
+        REQUIRE(0 == batch.size());
+        REQUIRE(0 == batch.flush().first);
+
+        // The remaining Envelope is sent when the batch is destroyed.
+        cluon::data::TimeStamp ts;
+        ts.seconds(1).microseconds(2);
+        cluon::ToProtoVisitor protoEncoder;
+        ts.accept(protoEncoder);
+        cluon::data::Envelope env;
+        env.dataType(cluon::data::TimeStamp::ID()).serializedData(protoEncoder.encodedData()).senderStamp(NUMBER_OF_MESSAGES);
+        REQUIRE(batch.send(std::move(env)));
+        REQUIRE(1 == batch.size());
+    }
+
+    bool received{false};
+    for (int32_t timeout{100}; !received && (timeout > 0); timeout--) {
+        std::this_thread::sleep_for(10ms);
+        std::lock_guard<std::mutex> lck(receivingMutex);
+        received = (NUMBER_OF_MESSAGES + 1 == receiving.size());
+    }
+    REQUIRE(received);
+
+    std::lock_guard<std::mutex> lck(receivingMutex);
+    for (uint32_t i{0}; i < NUMBER_OF_MESSAGES; i++) {
+        REQUIRE(cluon::data::PlayerStatus::ID() == receiving[i].dataType());
+        REQUIRE(i == receiving[i].senderStamp());
+        REQUIRE(i == cluon::extractMessage<cluon::data::PlayerStatus>(std::move(receiving[i])).currentEntryForPlayback());
+    }
+    REQUIRE(cluon::data::TimeStamp::ID() == receiving.back().dataType());
+    REQUIRE(NUMBER_OF_MESSAGES == receiving.back().senderStamp());
+    REQUIRE(2 == cluon::extractMessage<cluon::data::TimeStamp>(std::move(receiving.back())).microseconds());
+}
+
+TEST_CASE("Benchmark sending 300 messages per cycle with and without Batch.") {
+    cluon::OD4Session od4(164);
+    using namespace std::literals::chrono_literals; // NOLINT
+    do { std::this_thread::sleep_for(1ms); } while (!od4.isRunning());
+
+    // Object detections of a perception component at 50 Hz.
+    constexpr uint32_t MESSAGES_PER_CYCLE{300};
+    constexpr uint32_t CYCLES{50};
+    cluon::data::PlayerStatus ps;
+    ps.state(2).numberOfEntries(1000);
+
+    auto messagesPerSecond = [](std::chrono::steady_clock::time_point before) {
+        const double SECONDS{std::chrono::duration<double>(std::chrono::steady_clock::now() - before).count()};
+        return static_cast<uint64_t>(MESSAGES_PER_CYCLE * CYCLES / SECONDS);
+    };
+
+    auto before = std::chrono::steady_clock::now();
+    for (uint32_t cycle{0}; cycle < CYCLES; cycle++) {
+        for (uint32_t i{0}; i < MESSAGES_PER_CYCLE; i++) {
+            ps.currentEntryForPlayback(i);
+            od4.send(ps);
+        }
+    }
+    const uint64_t single{messagesPerSecond(before)};
+
+    uint64_t sent{0};
+    cluon::OD4Session::Batch batch{od4};
+    before = std::chrono::steady_clock::now();
+    for (uint32_t cycle{0}; cycle < CYCLES; cycle++) {
+        for (uint32_t i{0}; i < MESSAGES_PER_CYCLE; i++) {
+            ps.currentEntryForPlayback(i);
+            batch.send(ps);
+        }
+        sent += static_cast<uint64_t>(batch.flush().first);
+    }
+    const uint64_t batched{messagesPerSecond(before)};
+    REQUIRE(MESSAGES_PER_CYCLE * CYCLES == sent);
+
+    // Every message needs one system call when sent on its own; a batch needs one per MAX_NUMBER_OF_PACKETS_PER_SYSCALL messages on Linux.
+#ifdef __linux__
+    const std::size_t SYSCALLS_PER_CYCLE{(MESSAGES_PER_CYCLE + cluon::UDPSender::MAX_NUMBER_OF_PACKETS_PER_SYSCALL - 1)
+                                         / cluon::UDPSender::MAX_NUMBER_OF_PACKETS_PER_SYSCALL};
+#else
+    const std::size_t SYSCALLS_PER_CYCLE{MESSAGES_PER_CYCLE};
+#endif
+    std::clog << "[TestOD4Session] Sending " << MESSAGES_PER_CYCLE << " PlayerStatus messages per cycle: send " << single
+              << " messages/s with 1 syscall per message, Batch " << batched << " messages/s with "
+              << static_cast<double>(SYSCALLS_PER_CYCLE) / MESSAGES_PER_CYCLE << " syscalls per message." << std::endl;
+}
@@ -10,14 +10,20 @@
 
 #include "cluon/Envelope.hpp"
 #include "cluon/Player.hpp"
+#include "cluon/RecIndex.hpp"
+#include "cluon/Time.hpp"
 #include "cluon/ToProtoVisitor.hpp"
 #include "cluon/cluonDataStructures.hpp"
 #include "cluon/cluonTestDataStructures.hpp"
 
+#include <chrono>
 #include <cstdio>
 #include <fstream>
+#include <iostream>
 #include <string>
+#include <thread>
 #include <utility>
+#include <vector>
 
 // clang-format off
 #ifdef WIN32
@@ -50,6 +56,7 @@ TEST_CASE("Create simple player for file with one entry.") {
     constexpr bool THREADING{false};
 
     UNLINK("rec1");
+    UNLINK("rec1.idx");
     constexpr int32_t MAX_ENTRIES{1};
     {
         std::fstream recordingFile("rec1", std::ios::out | std::ios::binary | std::ios::trunc);
@@ -108,6 +115,7 @@ TEST_CASE("Create simple player for file with one entry.") {
     }
     REQUIRE(MAX_ENTRIES == retrievedEntries);
     UNLINK("rec1");
+    UNLINK("rec1.idx");
 }
 
 TEST_CASE("Create simple player for file with two entries.") {
@@ -115,6 +123,7 @@ TEST_CASE("Create simple player for file with two entries.") {
     constexpr bool THREADING{false};
 
     UNLINK("rec2");
+    UNLINK("rec2.idx");
     constexpr int32_t MAX_ENTRIES{2};
     {
         std::fstream recordingFile("rec2", std::ios::out | std::ios::binary | std::ios::trunc);
@@ -177,6 +186,7 @@ TEST_CASE("Create simple player for file with two entries.") {
     }
     REQUIRE(MAX_ENTRIES == retrievedEntries);
     UNLINK("rec2");
+    UNLINK("rec2.idx");
 }
 
 TEST_CASE("Create simple player for file with three entries.") {
@@ -184,6 +194,7 @@ TEST_CASE("Create simple player for file with three entries.") {
     constexpr bool THREADING{false};
 
     UNLINK("rec3");
+    UNLINK("rec3.idx");
     constexpr int32_t MAX_ENTRIES{3};
     {
         std::fstream recordingFile("rec3", std::ios::out | std::ios::binary | std::ios::trunc);
@@ -247,6 +258,7 @@ TEST_CASE("Create simple player for file with three entries.") {
     }
     REQUIRE(MAX_ENTRIES == retrievedEntries);
     UNLINK("rec3");
+    UNLINK("rec3.idx");
 }
 
 TEST_CASE("Create simple player for file with three entries auto auto-rewind.") {
@@ -254,6 +266,7 @@ TEST_CASE("Create simple player for file with three entries auto auto-rewind.")
     constexpr bool THREADING{false};
 
     UNLINK("rec4");
+    UNLINK("rec4.idx");
     constexpr int32_t MAX_ENTRIES{3};
     {
         std::fstream recordingFile("rec4", std::ios::out | std::ios::binary | std::ios::trunc);
@@ -320,6 +333,7 @@ TEST_CASE("Create simple player for file with three entries auto auto-rewind.")
     }
     REQUIRE(11 == retrievedEntries);
     UNLINK("rec4");
+    UNLINK("rec4.idx");
 }
 
 TEST_CASE("Create simple player for file with three entries with manual rewind.") {
@@ -327,6 +341,7 @@ TEST_CASE("Create simple player for file with three entries with manual rewind."
     constexpr bool THREADING{false};
 
     UNLINK("rec5");
+    UNLINK("rec5.idx");
     constexpr int32_t MAX_ENTRIES{3};
     {
         std::fstream recordingFile("rec5", std::ios::out | std::ios::binary | std::ios::trunc);
@@ -395,6 +410,7 @@ TEST_CASE("Create simple player for file with three entries with manual rewind."
     }
     REQUIRE(6 == retrievedEntries);
     UNLINK("rec5");
+    UNLINK("rec5.idx");
 }
 
 TEST_CASE("Create simple player for file with 6,000 entries to test look-ahead with threading and player listener.") {
@@ -402,6 +418,7 @@ TEST_CASE("Create simple player for file with 6,000 entries to test look-ahead w
     constexpr bool THREADING{true};
 
     UNLINK("rec6");
+    UNLINK("rec6.idx");
     constexpr int32_t MAX_ENTRIES{6000};
     {
         std::fstream recordingFile("rec6", std::ios::out | std::ios::binary | std::ios::trunc);
@@ -477,6 +494,7 @@ TEST_CASE("Create simple player for file with 6,000 entries to test look-ahead w
     REQUIRE(MAX_ENTRIES == playerStatus.numberOfEntries());
     REQUIRE(MAX_ENTRIES == retrievedEntries);
     UNLINK("rec6");
+    UNLINK("rec6.idx");
 }
 
 TEST_CASE("Create simple player for file with three entries with seeking.") {
@@ -484,6 +502,7 @@ TEST_CASE("Create simple player for file with three entries with seeking.") {
     constexpr bool THREADING{false};
 
     UNLINK("rec7");
+    UNLINK("rec7.idx");
     constexpr int32_t MAX_ENTRIES{3};
     {
         std::fstream recordingFile("rec7", std::ios::out | std::ios::binary | std::ios::trunc);
@@ -591,6 +610,7 @@ TEST_CASE("Create simple player for file with three entries with seeking.") {
     }
 
     UNLINK("rec7");
+    UNLINK("rec7.idx");
 }
 
 TEST_CASE("Create simple player for file with three entries with seeking with threading.") {
@@ -598,6 +618,7 @@ TEST_CASE("Create simple player for file with three entries with seeking with th
     constexpr bool THREADING{true};
 
     UNLINK("rec8");
+    UNLINK("rec8.idx");
     constexpr int32_t MAX_ENTRIES{3};
     {
         std::fstream recordingFile("rec8", std::ios::out | std::ios::binary | std::ios::trunc);
@@ -705,6 +726,7 @@ TEST_CASE("Create simple player for file with three entries with seeking with th
     }
 
     UNLINK("rec8");
+    UNLINK("rec8.idx");
 }
 
 TEST_CASE("Create simple player for file with three entries with manual rewind and threading.") {
@@ -712,6 +734,7 @@ TEST_CASE("Create simple player for file with three entries with manual rewind a
     constexpr bool THREADING{true};
 
     UNLINK("rec9");
+    UNLINK("rec9.idx");
     constexpr int32_t MAX_ENTRIES{3};
     {
         std::fstream recordingFile("rec9", std::ios::out | std::ios::binary | std::ios::trunc);
@@ -780,4 +803,205 @@ TEST_CASE("Create simple player for file with three entries with manual rewind a
     }
     REQUIRE(6 == retrievedEntries);
     UNLINK("rec9");
+    UNLINK("rec9.idx");
+}
+
+TEST_CASE("Create simple player for file with 25,000 entries to test reusing the cache with and without threading and seeking.") {
+    constexpr bool AUTO_REWIND{false};
+
+    UNLINK("rec7");
+    UNLINK("rec7.idx");
+    constexpr int32_t MAX_ENTRIES{25000};
+    {
+        std::fstream recordingFile("rec7", std::ios::out | std::ios::binary | std::ios::trunc);
+        REQUIRE(recordingFile.good());
+
+        // Entries in reverse order to test the sorting of the index.
+        for (int32_t entryCounter{MAX_ENTRIES - 1}; entryCounter >= 0; entryCounter--) {
+            testdata::MyTestMessage5 msg;
+            msg.attribute6(entryCounter + 1);
+
+            cluon::ToProtoVisitor proto;
+            msg.accept(proto);
+
+            cluon::data::Envelope env;
+            cluon::data::TimeStamp sampleTimeStamp;
+            sampleTimeStamp.seconds(entryCounter);
+
+            env.serializedData(proto.encodedData());
+            env.dataType(testdata::MyTestMessage5::ID()).sampleTimeStamp(sampleTimeStamp);
+
+            const std::string tmp{cluon::serializeEnvelope(std::move(env))};
+            recordingFile.write(tmp.c_str(), static_cast<std::streamsize>(tmp.size()));
+        }
+        recordingFile.close();
+    }
+
+    // The cache holds fewer entries than the file; thus, its entries are reused.
+    for (bool threading : {false, true}) {
+        cluon::Player player("rec7", AUTO_REWIND, threading);
+        REQUIRE(MAX_ENTRIES == player.totalNumberOfEnvelopesInRecFile());
+
+        int32_t retrievedEntries{0};
+        while (player.hasMoreData()) {
+            auto entry = player.getNextEnvelopeToBeReplayed();
+            REQUIRE(entry.first);
+            REQUIRE(retrievedEntries == entry.second.sampleTimeStamp().seconds());
+            retrievedEntries++;
+            if (1 < retrievedEntries) {
+                REQUIRE(static_cast<uint32_t>(1000 * 1000) == player.delay());
+            }
+            testdata::MyTestMessage5 msg = cluon::extractMessage<testdata::MyTestMessage5>(std::move(entry.second));
+            REQUIRE(retrievedEntries == msg.attribute6());
+        }
+        REQUIRE(MAX_ENTRIES == retrievedEntries);
+
+        player.seekTo(0.8f);
+        REQUIRE(player.hasMoreData());
+        auto entry = player.getNextEnvelopeToBeReplayed();
+        REQUIRE(entry.first);
+        REQUIRE(MAX_ENTRIES * 8 / 10 == entry.second.sampleTimeStamp().seconds());
+
+        retrievedEntries = entry.second.sampleTimeStamp().seconds() + 1;
+        while (player.hasMoreData()) {
+            entry = player.getNextEnvelopeToBeReplayed();
+            REQUIRE(entry.first);
+            REQUIRE(retrievedEntries == entry.second.sampleTimeStamp().seconds());
+            retrievedEntries++;
+        }
+        REQUIRE(MAX_ENTRIES == retrievedEntries);
+    }
+
+    UNLINK("rec7");
+    UNLINK("rec7.idx");
+}
+
+TEST_CASE("Create simple player for file with 200,000 entries to test adapting the read-ahead to the consumption.") {
+    constexpr bool AUTO_REWIND{false};
+
+    UNLINK("rec8");
+    UNLINK("rec8.idx");
+    constexpr int32_t MAX_ENTRIES{200000};
+    {
+        std::fstream recordingFile("rec8", std::ios::out | std::ios::binary | std::ios::trunc);
+        REQUIRE(recordingFile.good());
+
+        std::string data;
+        for (int32_t entryCounter{0}; entryCounter < MAX_ENTRIES; entryCounter++) {
+            testdata::MyTestMessage5 msg;
+            msg.attribute6(entryCounter + 1);
+
+            cluon::ToProtoVisitor proto;
+            msg.accept(proto);
+
+            // One entry per hour: Replaying in realtime requires to read ahead only few bytes.
+            cluon::data::Envelope env;
+            cluon::data::TimeStamp sampleTimeStamp;
+            sampleTimeStamp.seconds(entryCounter * 3600);
+
+            env.serializedData(proto.encodedData());
+            env.dataType(testdata::MyTestMessage5::ID()).sampleTimeStamp(sampleTimeStamp);
+            data += cluon::serializeEnvelope(std::move(env));
+        }
+        recordingFile.write(data.c_str(), static_cast<std::streamsize>(data.size()));
+        recordingFile.close();
+    }
+
+    for (bool threading : {false, true}) {
+        cluon::Player player("rec8", AUTO_REWIND, threading);
+        REQUIRE(MAX_ENTRIES == player.totalNumberOfEnvelopesInRecFile());
+
+        cluon::Player::CacheStatistics statistics{player.cacheStatistics()};
+        REQUIRE(1024 * 1024 == statistics.m_readAheadInBytes);
+        REQUIRE(0 < statistics.m_bytesInCache);
+        REQUIRE(0 == statistics.m_numberOfHits);
+        REQUIRE(0 == statistics.m_numberOfMisses);
+
+        // Replay faster than realtime for more than one second.
+        int32_t retrievedEntries{0};
+        while (player.hasMoreData()) {
+            auto entry = player.getNextEnvelopeToBeReplayed();
+            REQUIRE(entry.first);
+            REQUIRE(retrievedEntries * 3600 == entry.second.sampleTimeStamp().seconds());
+            retrievedEntries++;
+            if (0 == (retrievedEntries % 1000)) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            }
+        }
+        REQUIRE(MAX_ENTRIES == retrievedEntries);
+
+        statistics = player.cacheStatistics();
+        REQUIRE(MAX_ENTRIES == statistics.m_numberOfHits + statistics.m_numberOfMisses);
+        REQUIRE(0 == statistics.m_bytesInCache);
+        if (threading) {
+            // The consumption was measured and more bytes are read ahead.
+            REQUIRE(1024 * 1024 < statistics.m_readAheadInBytes);
+            REQUIRE(0 < statistics.m_consumedBytesPerSecond);
+        } else {
+            // The entries are read one after another.
+            REQUIRE(0 == statistics.m_numberOfMisses);
+            REQUIRE(0 == statistics.m_stallTime.count());
+        }
+        std::clog << "[TestPlayer] Threading " << threading << ": " << statistics.m_numberOfHits << " hits, " << statistics.m_numberOfMisses
+                  << " misses, stalled " << statistics.m_stallTime.count() << " us, read-ahead " << statistics.m_readAheadInBytes << " bytes." << std::endl;
+    }
+
+    UNLINK("rec8");
+    UNLINK("rec8.idx");
+}
+
+TEST_CASE("Create simple player for file with a stale index to test skipping entries that cannot be read.") {
+    constexpr bool AUTO_REWIND{false};
+    UNLINK("rec9");
+    UNLINK("rec9.idx");
+    constexpr int32_t MAX_ENTRIES{10};
+    std::vector<cluon::RecIndexEntry> entries;
+    {
+        std::fstream recordingFile("rec9", std::ios::out | std::ios::binary | std::ios::trunc);
+        REQUIRE(recordingFile.good());
+
+        std::string data;
+        for (int32_t entryCounter{0}; entryCounter < MAX_ENTRIES; entryCounter++) {
+            cluon::data::TimeStamp sampleTimeStamp;
+            sampleTimeStamp.seconds(entryCounter);
+
+            cluon::data::Envelope env;
+            env.dataType(cluon::data::PlayerStatus::ID()).sampleTimeStamp(sampleTimeStamp);
+
+            cluon::RecIndexEntry entry;
+            entry.m_sampleTimeStamp = cluon::time::toMicroseconds(sampleTimeStamp);
+            entry.m_filePosition    = data.size();
+            entries.push_back(entry);
+            data += cluon::serializeEnvelope(std::move(env));
+        }
+        recordingFile.write(data.c_str(), static_cast<std::streamsize>(data.size()));
+        recordingFile.close();
+
+        // The index matches the .rec file's fingerprint but three entries do not match its Envelopes.
+        entries[3].m_filePosition++;
+        entries[7].m_sampleTimeStamp++;
+        entries[9].m_filePosition = data.size();
+        REQUIRE(cluon::RecIndex::write("rec9", data.size(), entries));
+    }
+
+    for (bool threading : {false, true}) {
+        for (bool memoryMapped : {false, true}) {
+            cluon::Player player("rec9", AUTO_REWIND, threading, memoryMapped);
+            REQUIRE(MAX_ENTRIES == player.totalNumberOfEnvelopesInRecFile());
+
+            std::vector<int32_t> seconds;
+            while (player.hasMoreData()) {
+                auto entry = player.getNextEnvelopeToBeReplayed();
+                if (entry.first) {
+                    seconds.push_back(entry.second.sampleTimeStamp().seconds());
+                }
+            }
+            REQUIRE((std::vector<int32_t>{0, 1, 2, 4, 5, 6, 8}) == seconds);
+            REQUIRE(!player.getNextEnvelopeToBeReplayed().first);
+            REQUIRE(3 == player.cacheStatistics().m_numberOfSkippedEntries);
+        }
+    }
+
+    UNLINK("rec9");
+    UNLINK("rec9.idx");
 }
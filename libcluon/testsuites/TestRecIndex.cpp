@@ -0,0 +1,313 @@
+/*
+ * Copyright (C) 2017-2018  Christian Berger
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "catch.hpp"
+
+#include "cluon/Envelope.hpp"
+#include "cluon/Player.hpp"
+#include "cluon/RecIndex.hpp"
+#include "cluon/ToProtoVisitor.hpp"
+#include "cluon/cluonDataStructures.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+// clang-format off
+#ifdef WIN32
+    #define UNLINK _unlink
+#else
+    #include <fcntl.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+    #define UNLINK unlink
+#endif
+// clang-format on
+
+static std::string createEnvelope(int32_t sampleTimeStamp, uint32_t senderStamp) {
+    cluon::data::PlayerStatus ps;
+    ps.numberOfEntries(senderStamp);
+    cluon::ToProtoVisitor protoEncoder;
+    ps.accept(protoEncoder);
+
+    cluon::data::TimeStamp ts;
+    ts.seconds(sampleTimeStamp).microseconds(senderStamp % 1000);
+    cluon::data::Envelope env;
+    env.dataType(cluon::data::PlayerStatus::ID()).serializedData(protoEncoder.encodedData()).sampleTimeStamp(ts).senderStamp(senderStamp);
+    return cluon::serializeEnvelope(std::move(env));
+}
+
+// Writes a .rec file with sample time stamps in reverse order and returns the positions of the Envelopes.
+static std::vector<uint64_t> createRecFile(const std::string &recFile, uint32_t numberOfEnvelopes) {
+    std::vector<uint64_t> positions;
+    std::string data;
+    for (uint32_t i{0}; i < numberOfEnvelopes; i++) {
+        positions.push_back(data.size());
+        data += createEnvelope(static_cast<int32_t>(numberOfEnvelopes - i), i);
+    }
+    std::fstream recordingFile(recFile, std::ios::out | std::ios::binary | std::ios::trunc);
+    recordingFile.write(data.data(), static_cast<std::streamsize>(data.size()));
+    return positions;
+}
+
+// Scans the given bytes sequentially and returns the entries sorted by sample time stamp.
+static std::vector<cluon::RecIndexEntry> scanSequentially(const std::string &data, uint64_t &numberOfSkippedBytes) {
+    std::vector<cluon::RecIndexEntry> entries;
+    std::stringstream sstr{data};
+    uint64_t lastPosition{0};
+    REQUIRE(cluon::RecIndex::scan(sstr, entries, numberOfSkippedBytes, [&lastPosition](uint64_t position) {
+        REQUIRE(lastPosition < position);
+        lastPosition = position;
+    }));
+    return entries;
+}
+
+static bool isEqual(const std::vector<cluon::RecIndexEntry> &a, const std::vector<cluon::RecIndexEntry> &b) {
+    return std::equal(a.begin(), a.end(), b.begin(), b.end(), [](const cluon::RecIndexEntry &x, const cluon::RecIndexEntry &y) {
+        return (x.m_sampleTimeStamp == y.m_sampleTimeStamp) && (x.m_filePosition == y.m_filePosition) && (x.m_dataType == y.m_dataType)
+               && (x.m_senderStamp == y.m_senderStamp);
+    });
+}
+
+TEST_CASE("Create and load a sidecar index for a .rec file.") {
+    UNLINK("recindex1.rec");
+    UNLINK("recindex1.rec.idx");
+    REQUIRE("recindex1.rec.idx" == cluon::RecIndex::filename("recindex1.rec"));
+
+    cluon::RecIndex recIndex;
+    REQUIRE(!recIndex.load("recindex1.rec"));
+    REQUIRE(!cluon::RecIndex::create("recindex1.rec"));
+
+    constexpr uint32_t NUMBER_OF_ENVELOPES{100};
+    const std::vector<uint64_t> POSITIONS{createRecFile("recindex1.rec", NUMBER_OF_ENVELOPES)};
+    REQUIRE(!recIndex.load("recindex1.rec"));
+    REQUIRE(0 == recIndex.size());
+    REQUIRE(nullptr == recIndex.entries());
+
+    REQUIRE(cluon::RecIndex::create("recindex1.rec"));
+    REQUIRE(recIndex.load("recindex1.rec"));
+    REQUIRE(NUMBER_OF_ENVELOPES == recIndex.size());
+
+    // The entries are sorted by sample time stamp.
+    for (uint32_t i{0}; i < NUMBER_OF_ENVELOPES; i++) {
+        const cluon::RecIndexEntry &entry{recIndex.entries()[i]};
+        const uint32_t SENDER_STAMP{NUMBER_OF_ENVELOPES - 1 - i};
+        REQUIRE(SENDER_STAMP == entry.m_senderStamp);
+        REQUIRE(cluon::data::PlayerStatus::ID() == entry.m_dataType);
+        REQUIRE(POSITIONS[SENDER_STAMP] == entry.m_filePosition);
+        REQUIRE(static_cast<int64_t>(i + 1) * 1000 * 1000 + SENDER_STAMP % 1000 == entry.m_sampleTimeStamp);
+    }
+
+    // The index can be loaded again.
+    REQUIRE(recIndex.load("recindex1.rec"));
+    REQUIRE(NUMBER_OF_ENVELOPES == recIndex.size());
+
+    UNLINK("recindex1.rec");
+    UNLINK("recindex1.rec.idx");
+}
+
+TEST_CASE("Reject a sidecar index that does not match the .rec file.") {
+    UNLINK("recindex2.rec");
+    UNLINK("recindex2.rec.idx");
+
+    createRecFile("recindex2.rec", 10);
+    REQUIRE(cluon::RecIndex::create("recindex2.rec"));
+    cluon::RecIndex recIndex;
+    REQUIRE(recIndex.load("recindex2.rec"));
+
+    // Different size.
+    {
+        std::fstream recordingFile("recindex2.rec", std::ios::out | std::ios::binary | std::ios::app);
+        const std::string ENVELOPE{createEnvelope(1, 1)};
+        recordingFile.write(ENVELOPE.data(), static_cast<std::streamsize>(ENVELOPE.size()));
+    }
+    REQUIRE(!recIndex.load("recindex2.rec"));
+    REQUIRE(0 == recIndex.size());
+
+    // Same size but different content.
+    REQUIRE(cluon::RecIndex::create("recindex2.rec"));
+    REQUIRE(recIndex.load("recindex2.rec"));
+    {
+        std::fstream recordingFile("recindex2.rec", std::ios::in | std::ios::out | std::ios::binary);
+        recordingFile.seekp(10);
+        recordingFile.put('x');
+    }
+    REQUIRE(!recIndex.load("recindex2.rec"));
+
+#if !defined(WIN32) && !defined(__APPLE__)
+    // Same size and content but modified within the same second.
+    REQUIRE(cluon::RecIndex::create("recindex2.rec"));
+    REQUIRE(recIndex.load("recindex2.rec"));
+    {
+        struct stat fileStatus;
+        REQUIRE(0 == ::stat("recindex2.rec", &fileStatus));
+        struct timespec times[2];
+        times[0].tv_sec = times[1].tv_sec = fileStatus.st_mtime;
+        times[0].tv_nsec = times[1].tv_nsec = (500 * 1000 * 1000 < fileStatus.st_mtim.tv_nsec) ? 1 : 999 * 1000 * 1000;
+        REQUIRE(0 == ::utimensat(AT_FDCWD, "recindex2.rec", times, 0));
+    }
+    REQUIRE(!recIndex.load("recindex2.rec"));
+#endif
+
+    // Truncated index.
+    REQUIRE(cluon::RecIndex::create("recindex2.rec"));
+    std::string index;
+    {
+        std::fstream indexFile("recindex2.rec.idx", std::ios::in | std::ios::binary);
+        index.assign(std::istreambuf_iterator<char>(indexFile), std::istreambuf_iterator<char>());
+    }
+    {
+        std::fstream indexFile("recindex2.rec.idx", std::ios::out | std::ios::binary | std::ios::trunc);
+        indexFile.write(index.data(), static_cast<std::streamsize>(index.size() - 1));
+    }
+    REQUIRE(!recIndex.load("recindex2.rec"));
+
+    // Index of a different file format.
+    {
+        std::fstream indexFile("recindex2.rec.idx", std::ios::out | std::ios::binary | std::ios::trunc);
+        indexFile.write("x", 1);
+    }
+    REQUIRE(!recIndex.load("recindex2.rec"));
+
+    // The .rec file has changed after it was scanned.
+    std::vector<cluon::RecIndexEntry> entries(1);
+    REQUIRE(!cluon::RecIndex::write("recindex2.rec", 1, entries));
+    REQUIRE(!recIndex.load("recindex2.rec"));
+
+    UNLINK("recindex2.rec");
+    UNLINK("recindex2.rec.idx");
+}
+
+TEST_CASE("Player writes and uses the sidecar index.") {
+    UNLINK("recindex3.rec");
+    UNLINK("recindex3.rec.idx");
+
+    constexpr uint32_t NUMBER_OF_ENVELOPES{20};
+    createRecFile("recindex3.rec", NUMBER_OF_ENVELOPES);
+
+    constexpr bool AUTO_REWIND{false};
+    constexpr bool THREADING{false};
+    std::vector<uint32_t> senderStamps[2];
+    for (auto &s : senderStamps) {
+        cluon::Player player("recindex3.rec", AUTO_REWIND, THREADING);
+        REQUIRE(NUMBER_OF_ENVELOPES == player.totalNumberOfEnvelopesInRecFile());
+        while (player.hasMoreData()) {
+            auto next = player.getNextEnvelopeToBeReplayed();
+            REQUIRE(next.first);
+            s.push_back(next.second.senderStamp());
+        }
+
+        // The first Player has written the index.
+        cluon::RecIndex recIndex;
+        REQUIRE(recIndex.load("recindex3.rec"));
+    }
+    REQUIRE(NUMBER_OF_ENVELOPES == senderStamps[0].size());
+    REQUIRE(senderStamps[0] == senderStamps[1]);
+    REQUIRE(NUMBER_OF_ENVELOPES - 1 == senderStamps[0].front());
+    REQUIRE(0 == senderStamps[0].back());
+
+    UNLINK("recindex3.rec");
+    UNLINK("recindex3.rec.idx");
+}
+
+TEST_CASE("Scan chunks of a .rec file concurrently.") {
+    std::vector<cluon::RecIndexEntry> entries;
+    uint64_t numberOfSkippedBytes{0};
+    REQUIRE(cluon::RecIndex::scan(nullptr, 0, 4, entries, numberOfSkippedBytes));
+    REQUIRE(entries.empty());
+    REQUIRE(!cluon::RecIndex::scan(nullptr, 10, 4, entries, numberOfSkippedBytes));
+
+    // Envelopes with equal sample time stamps, corrupt bytes, and Envelopes
+    // carrying further Envelopes in their payload: A chunk starting inside
+    // such a payload synchronizes on an inner Envelope and must be scanned again.
+    std::string data{"garbage"};
+    uint32_t senderStamp{0};
+    while (data.size() < 20 * 1024 * 1024) {
+        std::string inner;
+        for (uint32_t i{0}; i < 5000; i++) {
+            inner += createEnvelope(static_cast<int32_t>(i % 7), 1000000 + i);
+        }
+        cluon::data::TimeStamp ts;
+        ts.seconds(static_cast<int32_t>(senderStamp % 5));
+        cluon::data::Envelope env;
+        env.dataType(cluon::data::PlayerStatus::ID()).serializedData(inner).sampleTimeStamp(ts).senderStamp(senderStamp++);
+        data += cluon::serializeEnvelope(std::move(env));
+        for (uint32_t i{0}; i < 1000; i++) {
+            data += createEnvelope(static_cast<int32_t>(i % 3), senderStamp++);
+        }
+        data += std::string("\x0D\xA4\x01\x00\x00xyz", 8);
+    }
+
+    uint64_t expectedNumberOfSkippedBytes{0};
+    const std::vector<cluon::RecIndexEntry> EXPECTED{scanSequentially(data, expectedNumberOfSkippedBytes)};
+    REQUIRE(senderStamp == EXPECTED.size());
+    REQUIRE(0 < expectedNumberOfSkippedBytes);
+    for (uint32_t numberOfThreads : {1u, 2u, 3u, 5u, 16u}) {
+        REQUIRE(cluon::RecIndex::scan(data.data(), data.size(), numberOfThreads, entries, numberOfSkippedBytes));
+        REQUIRE(isEqual(EXPECTED, entries));
+        REQUIRE(expectedNumberOfSkippedBytes == numberOfSkippedBytes);
+    }
+}
+
+TEST_CASE("Benchmark scanning a .rec file with one thread against several threads.") {
+    std::string data;
+    uint32_t senderStamp{0};
+    while (data.size() < 64 * 1024 * 1024) {
+        data += createEnvelope(static_cast<int32_t>(senderStamp), senderStamp);
+        senderStamp++;
+    }
+
+    const uint32_t NUMBER_OF_THREADS{std::max<uint32_t>(std::thread::hardware_concurrency(), 4)};
+    int64_t durations[2]{0, 0};
+    std::size_t numberOfEntries[2]{0, 0};
+    for (int i{0}; i < 2; i++) {
+        std::vector<cluon::RecIndexEntry> entries;
+        uint64_t numberOfSkippedBytes{0};
+        auto before = std::chrono::steady_clock::now();
+        cluon::RecIndex::scan(data.data(), data.size(), (0 == i) ? 1 : NUMBER_OF_THREADS, entries, numberOfSkippedBytes);
+        durations[i]       = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - before).count();
+        numberOfEntries[i] = entries.size();
+    }
+    REQUIRE(senderStamp == numberOfEntries[0]);
+    REQUIRE(senderStamp == numberOfEntries[1]);
+
+    std::clog << "[TestRecIndex] " << senderStamp << " Envelopes (" << data.size() / (1024 * 1024) << " MB): scanning with 1 thread " << durations[0] / 1000
+              << " ms, with " << NUMBER_OF_THREADS << " threads " << durations[1] / 1000 << " ms (" << std::thread::hardware_concurrency()
+              << " cores)." << std::endl;
+}
+
+TEST_CASE("Benchmark loading a sidecar index against scanning the .rec file.") {
+    UNLINK("recindex4.rec");
+    UNLINK("recindex4.rec.idx");
+
+    constexpr uint32_t NUMBER_OF_ENVELOPES{200000};
+    createRecFile("recindex4.rec", NUMBER_OF_ENVELOPES);
+
+    auto before = std::chrono::steady_clock::now();
+    REQUIRE(cluon::RecIndex::create("recindex4.rec"));
+    auto scanning = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - before).count();
+
+    cluon::RecIndex recIndex;
+    before = std::chrono::steady_clock::now();
+    REQUIRE(recIndex.load("recindex4.rec"));
+    auto loading = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - before).count();
+    REQUIRE(NUMBER_OF_ENVELOPES == recIndex.size());
+
+    std::clog << "[TestRecIndex] " << NUMBER_OF_ENVELOPES << " Envelopes: scanning and writing the index " << scanning / 1000 << " ms, loading the index "
+              << loading << " us." << std::endl;
+
+    UNLINK("recindex4.rec");
+    UNLINK("recindex4.rec.idx");
+}
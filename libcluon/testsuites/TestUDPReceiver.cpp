@@ -13,12 +13,24 @@
 
 #include <atomic>
 #include <chrono>
+#include <cstring>
 #include <ctime>
 #include <iomanip>
 #include <iostream>
+#include <memory>
 #include <string>
 #include <thread>
 #include <utility>
+#include <vector>
+
+#ifndef WIN32
+    #include <arpa/inet.h>
+    #include <netinet/in.h>
+    #include <sys/socket.h>
+    #include <sys/types.h>
+    #include <sys/wait.h>
+    #include <unistd.h>
+#endif
 
 TEST_CASE("Creating UDPReceiver and stop immediately.") {
     cluon::UDPReceiver ur1{"127.0.0.1", 1234, nullptr};
@@ -97,6 +109,107 @@ TEST_CASE("Creating UDPReceiver and receive data.") {
     }
 }
 
+TEST_CASE("Creating UDPReceiver with SPSC ring buffer pipeline and receive data.") {
+    std::atomic<uint32_t> packetsReceived{0};
+    std::string data;
+
+    cluon::UDPReceiver ur7(
+        "127.0.0.1",
+        1241,
+        [&packetsReceived, &data](std::string &&d, std::string &&, std::chrono::system_clock::time_point &&) noexcept {
+            data = std::move(d);
+            packetsReceived++;
+        },
+        0,
+        nullptr,
+        cluon::NotifyingPipelineType::SPSC_RING_BUFFER);
+    REQUIRE(ur7.isRunning());
+
+    cluon::UDPSender us7{"127.0.0.1", 1241};
+    for (uint32_t i{0}; i < 10; i++) {
+        std::string TEST_DATA{"Hello World " + std::to_string(i)};
+        us7.send(std::move(TEST_DATA));
+    }
+
+    using namespace std::literals::chrono_literals; // NOLINT
+    do { std::this_thread::sleep_for(1ms); } while (packetsReceived.load() < 10);
+    REQUIRE("Hello World 9" == data);
+}
+
+TEST_CASE("Creating UDPReceiver with delegate for pooled buffers and receive data.") {
+    std::atomic<uint32_t> packetsReceived{0};
+    std::string data;
+    uint16_t senderFamily{0};
+    std::vector<cluon::PooledBuffer> keptBuffers;
+
+    cluon::UDPReceiver ur9(
+        "127.0.0.1",
+        1243,
+        [&packetsReceived, &data, &senderFamily, &keptBuffers](
+            cluon::PooledBuffer &&d, const struct sockaddr_storage &from, std::chrono::system_clock::time_point &&) noexcept {
+            data         = std::string(d.data(), d.size());
+            senderFamily = from.ss_family;
+            // Keeping a buffer must not be overwritten by subsequent datagrams.
+            keptBuffers.emplace_back(std::move(d));
+            packetsReceived++;
+        },
+        0,
+        nullptr,
+        cluon::NotifyingPipelineType::SPSC_RING_BUFFER);
+    REQUIRE(ur9.isRunning());
+
+    cluon::UDPSender us9{"127.0.0.1", 1243};
+    for (uint32_t i{0}; i < 20; i++) {
+        std::string TEST_DATA{"Hello World " + std::to_string(i)};
+        us9.send(std::move(TEST_DATA));
+    }
+
+    using namespace std::literals::chrono_literals; // NOLINT
+    do { std::this_thread::sleep_for(1ms); } while (packetsReceived.load() < 20);
+    REQUIRE("Hello World 19" == data);
+    REQUIRE(AF_INET == senderFamily);
+    REQUIRE(20 == keptBuffers.size());
+    for (uint32_t i{0}; i < 20; i++) { REQUIRE(("Hello World " + std::to_string(i)) == keptBuffers[i].toString()); }
+
+    // A datagram larger than the pooled buffers is assembled in a buffer of the maximum UDP payload size.
+    const std::string LARGE_DATA(60000, 'L');
+    us9.send(std::string(LARGE_DATA));
+    do { std::this_thread::sleep_for(1ms); } while (packetsReceived.load() < 21);
+    REQUIRE(21 == keptBuffers.size());
+    REQUIRE(LARGE_DATA == keptBuffers[20].toString());
+    REQUIRE(65507 == keptBuffers[20].capacity());
+}
+
+TEST_CASE("Creating UDPReceiver with limited pipeline capacity drops datagrams.") {
+    using namespace std::literals::chrono_literals; // NOLINT
+    std::atomic<bool> blocked{true};
+    std::atomic<uint32_t> packetsReceived{0};
+
+    cluon::UDPReceiver ur8("127.0.0.1", 1242, [&blocked, &packetsReceived](std::string &&, std::string &&, std::chrono::system_clock::time_point &&) noexcept {
+        packetsReceived++;
+        // Simulate a slow delegate.
+        while (blocked.load()) { std::this_thread::sleep_for(1ms); }
+    });
+    REQUIRE(ur8.isRunning());
+    ur8.setPipelineCapacity(2, cluon::NotifyingPipelineOverflowPolicy::DROP_NEWEST);
+
+    cluon::UDPSender us8{"127.0.0.1", 1242};
+    for (uint32_t i{0}; i < 10; i++) {
+        std::string TEST_DATA{"Hello World"};
+        us8.send(std::move(TEST_DATA));
+        std::this_thread::sleep_for(5ms);
+    }
+    // The datagram being processed by the delegate counts against the capacity.
+    do { std::this_thread::sleep_for(1ms); } while ((ur8.pipelineSize() + ur8.numberOfDroppedDatagrams()) < 10);
+    REQUIRE(2 == ur8.pipelineSize());
+    REQUIRE(1 == packetsReceived.load());
+    REQUIRE(8 == ur8.numberOfDroppedDatagrams());
+
+    blocked.store(false);
+    do { std::this_thread::sleep_for(1ms); } while (packetsReceived.load() < 2);
+    REQUIRE(0 == ur8.pipelineSize());
+}
+
 TEST_CASE("Testing multicast with 226.x.y.z address.") {
     // Setup data structures to receive data from UDPReceiver.
     std::atomic<bool> hasDataReceived{false};
@@ -138,3 +251,85 @@ TEST_CASE("Testing multicast with faulty 224.0.0.1 address.") {
     REQUIRE(!ur5.isRunning());
     REQUIRE(!hasDataReceived);
 }
+
+#ifndef WIN32
+TEST_CASE("Benchmark receiving many small UDP packets on loopback.") {
+    constexpr uint32_t NUMBER_OF_PACKETS{50000};
+
+    for (bool usePooledBuffers : {false, true}) {
+        std::atomic<uint32_t> packetsReceived{0};
+
+        std::unique_ptr<cluon::UDPReceiver> ur6;
+        if (usePooledBuffers) {
+            ur6 = std::make_unique<cluon::UDPReceiver>(
+                "127.0.0.1",
+                1240,
+                [&packetsReceived](cluon::PooledBuffer &&, const struct sockaddr_storage &, std::chrono::system_clock::time_point &&) noexcept {
+                    packetsReceived++;
+                },
+                0,
+                nullptr,
+                cluon::NotifyingPipelineType::SPSC_RING_BUFFER);
+        } else {
+            ur6 = std::make_unique<cluon::UDPReceiver>(
+                "127.0.0.1", 1240, [&packetsReceived](std::string &&, std::string &&, std::chrono::system_clock::time_point &&) noexcept {
+                    packetsReceived++;
+                });
+        }
+        REQUIRE(ur6->isRunning());
+
+        // The second round shows the steady state after buffers were allocated.
+        for (uint32_t round{1}; round <= 2; round++) {
+            packetsReceived.store(0);
+
+            // Send from a separate process so that the CPU time of this process is
+            // only spent on receiving. The socket and payload are prepared before
+            // fork() as the child of a multi-threaded process must restrict itself
+            // to async-signal-safe calls.
+            const int senderSocket{::socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP)};
+            REQUIRE(0 <= senderSocket);
+            struct sockaddr_in sendToAddress;
+            std::memset(&sendToAddress, 0, sizeof(sendToAddress));
+            sendToAddress.sin_family      = AF_INET;
+            sendToAddress.sin_port        = htons(1240);
+            sendToAddress.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+            const std::string payload(64, 'x');
+
+            const std::clock_t cpuTimeBefore{std::clock()};
+            const pid_t sender{::fork()};
+            REQUIRE(0 <= sender);
+            if (0 == sender) {
+                for (uint32_t i{0}; i < NUMBER_OF_PACKETS; i++) {
+                    ::sendto(senderSocket,
+                             payload.data(),
+                             payload.size(),
+                             0,
+                             reinterpret_cast<const struct sockaddr *>(&sendToAddress), // NOLINT
+                             sizeof(sendToAddress));
+                }
+                ::_exit(0);
+            }
+            ::waitpid(sender, nullptr, 0);
+            ::close(senderSocket);
+
+            // Wait until no more packets arrive but give up after a deadline so that
+            // the test fails instead of hanging when nothing was received.
+            using namespace std::literals::chrono_literals; // NOLINT
+            const auto DEADLINE{std::chrono::steady_clock::now() + 10s};
+            uint32_t oldPacketsReceived{0};
+            do {
+                oldPacketsReceived = packetsReceived.load();
+                std::this_thread::sleep_for(100ms);
+            } while (((oldPacketsReceived != packetsReceived.load()) || (0 == oldPacketsReceived)) && (std::chrono::steady_clock::now() < DEADLINE));
+            const std::clock_t cpuTimeAfter{std::clock()};
+
+            const double cpuTimeInSeconds{static_cast<double>(cpuTimeAfter - cpuTimeBefore) / CLOCKS_PER_SEC};
+            std::clog << "[TestUDPReceiver] " << (usePooledBuffers ? "Pooled buffers/ring buffer" : "std::string/deque") << ", round " << round << ": Received "
+                      << packetsReceived.load() << "/" << NUMBER_OF_PACKETS << " packets using " << cpuTimeInSeconds << "s CPU time ("
+                      << (static_cast<double>(packetsReceived.load()) / (cpuTimeInSeconds > 0 ? cpuTimeInSeconds : 1.0)) << " packets/s, "
+                      << ur6->numberOfDroppedDatagrams() << " dropped from the pipeline)." << std::endl;
+            REQUIRE(0 < packetsReceived.load());
+        }
+    }
+}
+#endif
@@ -8,11 +8,19 @@
 
 #include "catch.hpp"
 
+#include "cluon/Envelope.hpp"
+#include "cluon/UDPReceiver.hpp"
 #include "cluon/UDPSender.hpp"
 
+#include <atomic>
 #include <cerrno>
+#include <chrono>
+#include <iostream>
+#include <mutex>
 #include <string>
+#include <thread>
 #include <utility>
+#include <vector>
 
 // Defining a test fixture to be reused among the test cases.
 class TestFixture_UDPSender {
@@ -99,3 +107,141 @@ TEST_CASE("Trying to send data with incomplete sendToAddress.") {
 #endif
     REQUIRE(EXPECTED_VALUE == retVal6.second);
 }
+
+TEST_CASE("Send test data as parts.") {
+    std::atomic<bool> hasDataReceived{false};
+    std::string data;
+    cluon::UDPReceiver ur{"127.0.0.1", 5679, [&hasDataReceived, &data](std::string &&d, std::string &&, std::chrono::system_clock::time_point &&) noexcept {
+                              data = std::move(d);
+                              hasDataReceived.store(true);
+                          }};
+    REQUIRE(ur.isRunning());
+
+    cluon::UDPSender us{"127.0.0.1", 5679};
+    const std::string HELLO{"Hello"};
+    const std::string WORLD{" World"};
+    const std::pair<const char *, std::size_t> PARTS[]{{HELLO.data(), HELLO.size()}, {nullptr, 0}, {WORLD.data(), WORLD.size()}};
+    auto retVal = us.send(PARTS, 3);
+    REQUIRE(11 == retVal.first);
+    REQUIRE(0 == retVal.second);
+
+    using namespace std::literals::chrono_literals; // NOLINT
+    do { std::this_thread::sleep_for(1ms); } while (!hasDataReceived.load());
+    REQUIRE("Hello World" == data);
+}
+
+TEST_CASE_METHOD(TestFixture_UDPSender, "Trying to send invalid parts.") {
+    const std::string TEST_DATA{"Hello World"};
+    std::vector<std::pair<const char *, std::size_t>> parts(cluon::UDPSender::MAX_NUMBER_OF_PARTS + 1, {TEST_DATA.data(), TEST_DATA.size()});
+
+    auto retVal = m_us.send(parts.data(), parts.size());
+    REQUIRE(-1 == retVal.first);
+    REQUIRE(EINVAL == retVal.second);
+
+    const std::pair<const char *, std::size_t> *NO_PARTS{nullptr};
+    retVal = m_us.send(NO_PARTS, 0);
+    REQUIRE(-1 == retVal.first);
+    REQUIRE(EINVAL == retVal.second);
+
+    // Empty parts only.
+    const std::pair<const char *, std::size_t> EMPTY[]{{nullptr, 0}, {TEST_DATA.data(), 0}};
+    retVal = m_us.send(EMPTY, 2);
+    REQUIRE(0 == retVal.first);
+    REQUIRE(0 == retVal.second);
+
+    // Too big in total.
+    const std::string HALF(0x8000, 'A');
+    const std::pair<const char *, std::size_t> TOO_BIG[]{{HALF.data(), HALF.size()}, {HALF.data(), HALF.size()}};
+    retVal = m_us.send(TOO_BIG, 2);
+    REQUIRE(-1 == retVal.first);
+    REQUIRE(E2BIG == retVal.second);
+
+    cluon::UDPSender faulty{"127.0.0.256", 5677};
+    retVal = faulty.send(parts.data(), 1);
+    REQUIRE(-1 == retVal.first);
+}
+
+TEST_CASE("Send test data as batch.") {
+    constexpr uint32_t NUMBER_OF_PACKETS{200};
+    std::mutex dataMutex;
+    std::vector<std::string> data;
+    cluon::UDPReceiver ur{"127.0.0.1", 5680, [&dataMutex, &data](std::string &&d, std::string &&, std::chrono::system_clock::time_point &&) noexcept {
+                              std::lock_guard<std::mutex> lck(dataMutex);
+                              data.emplace_back(std::move(d));
+                          }};
+    REQUIRE(ur.isRunning());
+
+    // More packets than can be sent with one system call and an empty one.
+    std::vector<std::string> expected;
+    for (uint32_t i{0}; i < NUMBER_OF_PACKETS; i++) { expected.emplace_back("Packet " + std::to_string(i)); }
+    std::vector<std::pair<const char *, std::size_t>> packets;
+    for (const auto &e : expected) { packets.emplace_back(e.data(), e.size()); }
+    packets.emplace(packets.begin() + 10, nullptr, 0);
+
+    cluon::UDPSender us{"127.0.0.1", 5680};
+    auto retVal = us.send(packets);
+    REQUIRE(NUMBER_OF_PACKETS == retVal.first);
+    REQUIRE(0 == retVal.second);
+
+    using namespace std::literals::chrono_literals; // NOLINT
+    for (uint32_t timeout{0}; timeout < 1000; timeout++) {
+        std::this_thread::sleep_for(1ms);
+        std::lock_guard<std::mutex> lck(dataMutex);
+        if (NUMBER_OF_PACKETS == data.size()) {
+            break;
+        }
+    }
+    std::lock_guard<std::mutex> lck(dataMutex);
+    REQUIRE(expected == data);
+}
+
+TEST_CASE_METHOD(TestFixture_UDPSender, "Trying to send invalid batches.") {
+    auto retVal = m_us.send(std::vector<std::pair<const char *, std::size_t>>{});
+    REQUIRE(0 == retVal.first);
+    REQUIRE(0 == retVal.second);
+
+    // No packet is sent if one of them is too big.
+    const std::string SMALL{"Hello"};
+    const std::string TOO_BIG(0xFFFF, 'A');
+    retVal = m_us.send({{SMALL.data(), SMALL.size()}, {TOO_BIG.data(), TOO_BIG.size()}});
+    REQUIRE(-1 == retVal.first);
+    REQUIRE(E2BIG == retVal.second);
+
+    cluon::UDPSender faulty{"127.0.0.256", 5677};
+    retVal = faulty.send({{SMALL.data(), SMALL.size()}});
+    REQUIRE(-1 == retVal.first);
+    REQUIRE(EBADF == retVal.second);
+}
+
+TEST_CASE_METHOD(TestFixture_UDPSender, "Benchmark sending Envelopes as parts against copying the payload.") {
+    for (std::size_t payloadSize : {1024, 16 * 1024, 60 * 1024}) {
+        const std::string PAYLOAD(payloadSize, 'x');
+        cluon::data::Envelope envelope;
+        envelope.dataType(1234).senderStamp(5);
+        std::string buffer;
+
+        constexpr uint32_t ITERATIONS{2000};
+        uint32_t failures{0};
+        auto before = std::chrono::steady_clock::now();
+        for (uint32_t i{0}; i < ITERATIONS; i++) {
+            // Payload copied into the Envelope and into the OD4 frame.
+            envelope.serializedData(PAYLOAD);
+            cluon::serializeEnvelope(buffer, envelope);
+            failures += (0 < m_us.send(buffer.data(), buffer.size()).first) ? 0 : 1;
+        }
+        auto copying = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - before).count();
+
+        envelope.serializedData("");
+        before = std::chrono::steady_clock::now();
+        for (uint32_t i{0}; i < ITERATIONS; i++) {
+            const cluon::EnvelopeParts PARTS{cluon::serializeEnvelopeParts(buffer, envelope, PAYLOAD.data(), PAYLOAD.size())};
+            failures += (0 < m_us.send(PARTS.data(), PARTS.size()).first) ? 0 : 1;
+        }
+        auto gathering = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - before).count();
+
+        auto megabytesPerSecond = [&](int64_t ns) { return (ITERATIONS * payloadSize * 1000) / static_cast<std::size_t>(ns); };
+        std::clog << "[TestUDPSender] " << payloadSize << " bytes per Envelope: copying " << megabytesPerSecond(copying) << " MB/s, scatter/gather "
+                  << megabytesPerSecond(gathering) << " MB/s." << std::endl;
+        REQUIRE(0 == failures);
+    }
+}
@@ -0,0 +1,174 @@
+/*
+ * Copyright (C) 2017-2018  Christian Berger
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "catch.hpp"
+
+#include "cluon/VarInt.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+// Byte-wise VarInt encoding as originally used by ToProtoVisitor.
+static std::size_t referenceEncode(char *out, uint64_t v) {
+    std::size_t size{1};
+    while (0x7f < v) {
+        *out++ = static_cast<char>((static_cast<uint8_t>(v & 0x7f)) | 0x80);
+        v >>= 7;
+        size++;
+    }
+    *out = static_cast<char>((static_cast<uint8_t>(v)) & 0x7f);
+    return size;
+}
+
+// Byte-wise VarInt decoding as originally used by FromProtoVisitor.
+static bool referenceDecode(const char *&pos, const char *end, uint64_t &value) {
+    value = 0;
+    for (uint64_t size{0}; (pos < end) && (size < cluon::MAX_VARINT_SIZE); size++) {
+        const uint64_t C{static_cast<uint8_t>(*pos++)};
+        value |= (C & 0x7f) << (7 * size);
+        if (!(C & 0x80)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Checks encoding and decoding of v against the reference implementation, with
+// and without further bytes behind the VarInt.
+static bool roundTrip(uint64_t v) {
+    char expected[cluon::MAX_VARINT_SIZE];
+    const std::size_t EXPECTED_SIZE{referenceEncode(expected, v)};
+
+    char buffer[cluon::MAX_VARINT_SIZE + 8];
+    const std::size_t SIZE{cluon::encodeVarInt(buffer, v)};
+    if ((EXPECTED_SIZE != SIZE) || (0 != std::memcmp(expected, buffer, SIZE))) {
+        return false;
+    }
+
+    const std::string exact(buffer, SIZE);
+    const std::string padded{exact + std::string(8, '\x7f')};
+    for (const std::string &s : {exact, padded}) {
+        const char *pos{s.data()};
+        uint64_t value{0};
+        if (!cluon::decodeVarInt(pos, s.data() + s.size(), value) || (v != value) || (s.data() + SIZE != pos)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// VarInts of the fields of Envelopes as they appear in an OD4 stream.
+static std::vector<uint64_t> envelopeVarInts(uint32_t numberOfEnvelopes) {
+    std::mt19937_64 rng{42};
+    std::uniform_int_distribution<uint64_t> dataType(1000, 1200), micros(0, 999999), sender(0, 5), length(8, 1400);
+    auto zigzag = [](int64_t v) { return static_cast<uint64_t>((v << 1) ^ (v >> 63)); };
+
+    std::vector<uint64_t> values;
+    uint64_t seconds{1537000000};
+    for (uint32_t i{0}; i < numberOfEnvelopes; i++) {
+        values.insert(values.end(), {0x08, zigzag(static_cast<int64_t>(dataType(rng))), 0x12, length(rng)});
+        for (uint64_t key : {0x1a, 0x22, 0x2a}) {
+            values.insert(values.end(), {key, 0x0c, 0x08, zigzag(static_cast<int64_t>(seconds)), 0x10, zigzag(static_cast<int64_t>(micros(rng)))});
+        }
+        values.insert(values.end(), {0x30, sender(rng)});
+        seconds += i % 2;
+    }
+    return values;
+}
+
+static std::string encodeAll(const std::vector<uint64_t> &values) {
+    std::string s;
+    char buffer[cluon::MAX_VARINT_SIZE];
+    for (uint64_t v : values) { s.append(buffer, referenceEncode(buffer, v)); }
+    return s;
+}
+
+TEST_CASE("Encoding and decoding all values up to 2^21 as VarInt.") {
+    uint32_t failures{0};
+    for (uint64_t v{0}; v < (1 << 21); v++) { failures += (roundTrip(v) ? 0 : 1); }
+    REQUIRE(0 == failures);
+}
+
+TEST_CASE("Encoding and decoding values of all bit lengths as VarInt.") {
+    std::mt19937_64 rng{1234};
+    uint32_t failures{0};
+    for (uint32_t bits{1}; bits <= 64; bits++) {
+        const uint64_t MAX{(64 == bits) ? ~static_cast<uint64_t>(0) : ((static_cast<uint64_t>(1) << bits) - 1)};
+        const uint64_t MIN{static_cast<uint64_t>(1) << (bits - 1)};
+        for (uint64_t v : {MIN - 1, MIN, MIN + 1, MAX - 1, MAX, MAX + 1}) { failures += (roundTrip(v) ? 0 : 1); }
+        for (uint32_t i{0}; i < 10000; i++) { failures += (roundTrip((rng() & MAX) | MIN) ? 0 : 1); }
+    }
+    REQUIRE(0 == failures);
+}
+
+TEST_CASE("Decoding malformed VarInts.") {
+    uint64_t value{0};
+
+    // Eleven bytes with MSB set.
+    const std::string tooLong(11, '\xff');
+    const char *pos{tooLong.data()};
+    REQUIRE(!cluon::decodeVarInt(pos, tooLong.data() + tooLong.size(), value));
+
+    // Truncated VarInts with and without eight readable bytes.
+    const std::string truncated{"\xff\xff\xff"};
+    pos = truncated.data();
+    REQUIRE(!cluon::decodeVarInt(pos, truncated.data() + truncated.size(), value));
+    const std::string truncatedNine(9, '\x81');
+    pos = truncatedNine.data();
+    REQUIRE(!cluon::decodeVarInt(pos, truncatedNine.data() + truncatedNine.size(), value));
+
+    pos = tooLong.data();
+    REQUIRE(!cluon::decodeVarInt(pos, pos, value));
+}
+
+// Measures decoding the given VarInts byte-wise and with decodeVarInt.
+static void benchmark(const std::string &name, const std::vector<uint64_t> &expected) {
+    const std::string data{encodeAll(expected)};
+    const char *end{data.data() + data.size()};
+    std::vector<uint64_t> values(expected.size(), 0);
+    constexpr uint32_t ITERATIONS{20};
+
+    auto nsPerVarInt = [&](std::chrono::steady_clock::time_point before) {
+        return static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - before).count())
+               / static_cast<double>(ITERATIONS * expected.size());
+    };
+
+    auto before = std::chrono::steady_clock::now();
+    for (uint32_t i{0}; i < ITERATIONS; i++) {
+        const char *pos{data.data()};
+        for (uint64_t &v : values) { referenceDecode(pos, end, v); }
+    }
+    const double referenceDecoding{nsPerVarInt(before)};
+    REQUIRE(expected == values);
+
+    before = std::chrono::steady_clock::now();
+    for (uint32_t i{0}; i < ITERATIONS; i++) {
+        const char *pos{data.data()};
+        for (uint64_t &v : values) { cluon::decodeVarInt(pos, end, v); }
+    }
+    const double decoding{nsPerVarInt(before)};
+    REQUIRE(expected == values);
+
+    std::clog << "[TestVarInt] Decoding " << name << ": byte-wise " << referenceDecoding << " ns, decodeVarInt " << decoding << " ns per VarInt."
+              << std::endl;
+}
+
+TEST_CASE("Benchmark decoding the VarInts of an Envelope stream.") {
+    benchmark("VarInts of 10000 Envelopes", envelopeVarInts(10000));
+}
+
+TEST_CASE("Benchmark decoding VarInts of random length.") {
+    std::mt19937_64 rng{7};
+    std::vector<uint64_t> values(200000);
+    for (uint64_t &v : values) { v = rng() >> (rng() % 64); }
+    benchmark("200000 VarInts of random length", values);
+}
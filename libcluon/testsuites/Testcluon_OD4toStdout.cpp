@@ -67,6 +67,7 @@ TEST_CASE("Test starting cluon-OD4toStdout in thread and send one message.") {
     cluon::TerminateHandler::instance().isTerminated.store(false);
 
     UNLINK("GHI.rec");
+    UNLINK("GHI.rec.idx");
 
     std::stringstream capturedCout;
     RedirectCOUT redirect(capturedCout.rdbuf());
@@ -148,5 +149,6 @@ TEST_CASE("Test starting cluon-OD4toStdout in thread and send one message.") {
 
     runOD4toStdout.join();
     UNLINK("GHI.rec");
+    UNLINK("GHI.rec.idx");
 #endif
 }
@@ -43,6 +43,7 @@ TEST_CASE("Test only --odvd parameter.") {
 
 TEST_CASE("Test only --rec parameter.") {
     UNLINK("DEF2.rec");
+    UNLINK("DEF2.rec.idx");
     constexpr int32_t argc = 2;
     const char *argv[]     = {static_cast<const char *>("cluon-rec2csv"), static_cast<const char *>("--rec=DEF2.rec")};
     REQUIRE(1 == cluon_rec2csv(argc, const_cast<char **>(argv)));
@@ -51,17 +52,20 @@ TEST_CASE("Test only --rec parameter.") {
 TEST_CASE("Test both parameters and non-existing ODVD file.") {
     UNLINK("ABC3.odvd");
     UNLINK("DEF3.rec");
+    UNLINK("DEF3.rec.idx");
     constexpr int32_t argc = 3;
     const char *argv[]
         = {static_cast<const char *>("cluon-rec2csv"), static_cast<const char *>("--odvd=ABC3.odvd"), static_cast<const char *>("--rec=DEF3.rec")};
     std::fstream rec("DEF3.rec", std::ios::out);
     REQUIRE(1 == cluon_rec2csv(argc, const_cast<char **>(argv)));
     UNLINK("DEF3.rec");
+    UNLINK("DEF3.rec.idx");
 }
 
 TEST_CASE("Test both parameters and non-existing rec file.") {
     UNLINK("ABC4.odvd");
     UNLINK("DEF4.rec");
+    UNLINK("DEF4.rec.idx");
     constexpr int32_t argc = 3;
     const char *argv[]
         = {static_cast<const char *>("cluon-rec2csv"), static_cast<const char *>("--odvd=ABC4.odvd"), static_cast<const char *>("--rec=DEF4.rec")};
@@ -84,6 +88,7 @@ message MyPackage.MyMessage1 [id = 1] {
 TEST_CASE("Test both parameters.") {
     UNLINK("ABC5.odvd");
     UNLINK("DEF5.rec");
+    UNLINK("DEF5.rec.idx");
     UNLINK("testdata.MyTestMessage5-0.csv");
 
     constexpr int32_t argc = 3;
@@ -162,12 +167,14 @@ message testdata.MyTestMessage5 [id = 30005] {
 
     UNLINK("ABC5.odvd");
     UNLINK("DEF5.rec");
+    UNLINK("DEF5.rec.idx");
     UNLINK("testdata.MyTestMessage5-0.csv");
 }
 
 TEST_CASE("Test both parameters but corrupt ODVD file.") {
     UNLINK("ABC6.odvd");
     UNLINK("DEF6.rec");
+    UNLINK("DEF6.rec.idx");
     UNLINK("testdata.MyTestMessage5-0.csv");
 
     constexpr int32_t argc = 3;
@@ -225,5 +232,6 @@ message testdata.MyTestMessage5 [id = 30005] {
 
     UNLINK("ABC6.odvd");
     UNLINK("DEF6.rec");
+    UNLINK("DEF6.rec.idx");
     UNLINK("testdata.MyTestMessage5-0.csv");
 }
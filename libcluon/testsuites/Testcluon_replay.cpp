@@ -54,6 +54,7 @@ TEST_CASE("Test non-existing rec-file.") {
     cluon::TerminateHandler::instance().isTerminated.store(false);
 
     UNLINK("abc.rec");
+    UNLINK("abc.rec.idx");
 
     std::stringstream capturedCout;
     RedirectCOUT redirect(capturedCout.rdbuf());
@@ -63,6 +64,7 @@ TEST_CASE("Test non-existing rec-file.") {
     REQUIRE(1 == cluon_replay(argc, const_cast<char **>(argv)));
 
     UNLINK("abc.rec");
+    UNLINK("abc.rec.idx");
 #endif
 }
 
@@ -73,6 +75,7 @@ TEST_CASE("Test playback rec-file to stdout.") {
     cluon::TerminateHandler::instance().isTerminated.store(false);
 
     UNLINK("abc1.rec");
+    UNLINK("abc1.rec.idx");
 
     constexpr int32_t MAX_ENTRIES{5};
     {
@@ -115,6 +118,7 @@ TEST_CASE("Test playback rec-file to stdout.") {
     REQUIRE(!tmp.empty());
 
     UNLINK("abc1.rec");
+    UNLINK("abc1.rec.idx");
 #endif
 }
 
@@ -125,6 +129,7 @@ TEST_CASE("Test playback rec-file to OD4Session.") {
     cluon::TerminateHandler::instance().isTerminated.store(false);
 
     UNLINK("abc2.rec");
+    UNLINK("abc2.rec.idx");
 
     constexpr int32_t MAX_ENTRIES{5};
     {
@@ -180,6 +185,7 @@ TEST_CASE("Test playback rec-file to OD4Session.") {
 
     REQUIRE(MAX_ENTRIES == envelopeCounter);
     UNLINK("abc2.rec");
+    UNLINK("abc2.rec.idx");
 #endif
 }
 
@@ -190,6 +196,7 @@ TEST_CASE("Test playback rec-file to OD4Session with wrong cid results in playba
     cluon::TerminateHandler::instance().isTerminated.store(false);
 
     UNLINK("abc3.rec");
+    UNLINK("abc3.rec.idx");
 
     constexpr int32_t MAX_ENTRIES{5};
     {
@@ -234,6 +241,7 @@ TEST_CASE("Test playback rec-file to OD4Session with wrong cid results in playba
     cluon::TerminateHandler::instance().isTerminated.store(true);
 
     UNLINK("abc3.rec");
+    UNLINK("abc3.rec.idx");
 #endif
 }
 
@@ -244,6 +252,7 @@ TEST_CASE("Test playback rec-file to OD4Session and to stdout.") {
     cluon::TerminateHandler::instance().isTerminated.store(false);
 
     UNLINK("abc4.rec");
+    UNLINK("abc4.rec.idx");
 
     constexpr int32_t MAX_ENTRIES{5};
     {
@@ -302,6 +311,7 @@ TEST_CASE("Test playback rec-file to OD4Session and to stdout.") {
 
     REQUIRE(MAX_ENTRIES == envelopeCounter);
     UNLINK("abc4.rec");
+    UNLINK("abc4.rec.idx");
 #endif
 }
 
@@ -312,6 +322,7 @@ TEST_CASE("Test playback rec-file to OD4Session and stdout with external player
     cluon::TerminateHandler::instance().isTerminated.store(false);
 
     UNLINK("abc5.rec");
+    UNLINK("abc5.rec.idx");
 
     constexpr int32_t MAX_ENTRIES{5};
     {
@@ -404,6 +415,7 @@ TEST_CASE("Test playback rec-file to OD4Session and stdout with external player
     // We have seeked to the beginning of the file after 3 entries and thus, we must replay more than 5 entries.
     REQUIRE(MAX_ENTRIES < envelopeCounter);
     UNLINK("abc5.rec");
+    UNLINK("abc5.rec.idx");
 #endif
 }
 
@@ -414,6 +426,7 @@ TEST_CASE("Test playback rec-file to OD4Session with external player control for
     cluon::TerminateHandler::instance().isTerminated.store(false);
 
     UNLINK("abc6.rec");
+    UNLINK("abc6.rec.idx");
 
     constexpr int32_t MAX_ENTRIES{5};
     {
@@ -505,5 +518,6 @@ TEST_CASE("Test playback rec-file to OD4Session with external player control for
     // We have seeked to the beginning of the file after 3 entries and thus, we must replay more than 5 entries.
     REQUIRE(MAX_ENTRIES == envelopeCounter);
     UNLINK("abc6.rec");
+    UNLINK("abc6.rec.idx");
 #endif
 }
@@ -11,6 +11,8 @@
 
 #include "cluon/cluon.hpp"
 #include "cluon/Envelope.hpp"
+#include "cluon/EnvelopeReader.hpp"
+#include "cluon/EnvelopeView.hpp"
 #include "cluon/stringtoolbox.hpp"
 
 #include <cstdint>
@@ -60,26 +62,26 @@ inline int32_t cluon_filter(int32_t argc, char **argv) {
             }
         }
 
-        bool foundData{false};
-        do {
-            auto retVal = cluon::extractEnvelope(std::cin);
-            foundData = retVal.first;
-            if (0 < retVal.second.dataType()) {
+        // Envelopes are read from stdin in large blocks and written unchanged
+        // to stdout without decoding them.
+        cluon::EnvelopeReader reader{std::cin};
+        cluon::EnvelopeFrame frame;
+        while (reader.next(frame)) {
+            const cluon::EnvelopeView VIEW{cluon::viewEnvelope(frame.m_data, frame.m_size)};
+            if (VIEW.valid() && (0 < VIEW.dataType())) {
                 std::stringstream sstr;
-                sstr << retVal.second.dataType() << "/" << retVal.second.senderStamp();
+                sstr << VIEW.dataType() << "/" << VIEW.senderStamp();
                 std::string str = sstr.str();
                 if ( (0 < mapOfEnvelopesToKeep.size()) && mapOfEnvelopesToKeep.count(str)) {
-                    str = cluon::serializeEnvelope(std::move(retVal.second));
-                    std::cout << str;
+                    std::cout.write(frame.m_data, static_cast<std::streamsize>(frame.m_size));
                     std::cout.flush();
                 }
                 if ( (0 < mapOfEnvelopesToDrop.size()) && !mapOfEnvelopesToDrop.count(str)) {
-                    str = cluon::serializeEnvelope(std::move(retVal.second));
-                    std::cout << str;
+                    std::cout.write(frame.m_data, static_cast<std::streamsize>(frame.m_size));
                     std::cout.flush();
                 }
             }
-        } while (std::cin.good() && foundData);
+        }
     }
     return retCode;
 }
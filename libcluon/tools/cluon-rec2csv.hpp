@@ -10,6 +10,7 @@
 #define CLUON_REC2CSV_HPP
 
 #include "cluon/cluon.hpp"
+#include "cluon/Arena.hpp"
 #include "cluon/GenericMessage.hpp"
 #include "cluon/MessageParser.hpp"
 #include "cluon/MetaMessage.hpp"
@@ -103,6 +104,7 @@ inline int32_t cluon_rec2csv(int32_t argc, char **argv) {
                     }
                     cluon::data::Envelope env{std::move(next.second)};
                     if (scope.count(env.dataType()) > 0) {
+                        cluon::ArenaScope arenaScope{cluon::Arena::ofThisThread()};
                         cluon::FromProtoVisitor protoDecoder;
                         std::stringstream sstr(env.serializedData());
                         protoDecoder.decodeFrom(sstr);